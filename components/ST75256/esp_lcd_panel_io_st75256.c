@@ -0,0 +1,208 @@
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sys/cdefs.h>
+#include "esp_lcd_panel_io_interface.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_io_st75256.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include "driver/i2c_master.h"
+
+static const char *TAG = "lcd_panel.io.st75256";
+
+// I2C control byte: Co (bit7) = another control byte follows after one data byte,
+// A0 (bit6) = the data byte is a parameter / RAM data rather than a command
+#define ST75256_CTRL_CO                   0x80
+#define ST75256_CTRL_A0                   0x40
+
+// Worst case: every command/parameter byte needs its own control byte, plus the final data control byte
+#define ST75256_IO_HDR_SIZE               (ESP_LCD_PANEL_IO_ST75256_MAX_CMD_BYTES * 2 + 1)
+
+typedef struct {
+    esp_lcd_panel_io_t base;
+    i2c_master_dev_handle_t i2c_handle;
+    esp_lcd_panel_io_color_trans_done_cb_t on_color_trans_done;
+    void *user_ctx;
+    uint32_t scl_speed_hz;
+    size_t hdr_len;
+    uint8_t hdr[ST75256_IO_HDR_SIZE];
+} st75256_panel_io_t;
+
+static esp_err_t panel_io_st75256_rx_param(esp_lcd_panel_io_t *io, int lcd_cmd, void *param, size_t param_size);
+static esp_err_t panel_io_st75256_tx_param(esp_lcd_panel_io_t *io, int lcd_cmd, const void *param, size_t param_size);
+static esp_err_t panel_io_st75256_tx_color(esp_lcd_panel_io_t *io, int lcd_cmd, const void *color, size_t color_size);
+static esp_err_t panel_io_st75256_del(esp_lcd_panel_io_t *io);
+static esp_err_t panel_io_st75256_register_event_callbacks(esp_lcd_panel_io_t *io, const esp_lcd_panel_io_callbacks_t *cbs, void *user_ctx);
+
+esp_err_t esp_lcd_new_panel_io_st75256(i2c_master_bus_handle_t bus, const esp_lcd_panel_io_st75256_config_t *io_config,
+                                       esp_lcd_panel_io_handle_t *ret_io)
+{
+    esp_err_t ret = ESP_OK;
+    st75256_panel_io_t *st75256_io = NULL;
+    ESP_GOTO_ON_FALSE(bus && io_config && ret_io, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+
+    st75256_io = calloc(1, sizeof(st75256_panel_io_t));
+    ESP_GOTO_ON_FALSE(st75256_io, ESP_ERR_NO_MEM, err, TAG, "no mem for st75256 panel io");
+
+    i2c_device_config_t i2c_dev_conf = {
+        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+        .device_address = io_config->dev_addr,
+        .scl_speed_hz = io_config->scl_speed_hz,
+    };
+    ESP_GOTO_ON_ERROR(i2c_master_bus_add_device(bus, &i2c_dev_conf, &st75256_io->i2c_handle), err, TAG, "add i2c device failed");
+
+    st75256_io->on_color_trans_done = io_config->on_color_trans_done;
+    st75256_io->user_ctx = io_config->user_ctx;
+    st75256_io->scl_speed_hz = io_config->scl_speed_hz;
+    st75256_io->base.rx_param = panel_io_st75256_rx_param;
+    st75256_io->base.tx_param = panel_io_st75256_tx_param;
+    st75256_io->base.tx_color = panel_io_st75256_tx_color;
+    st75256_io->base.del = panel_io_st75256_del;
+    st75256_io->base.register_event_callbacks = panel_io_st75256_register_event_callbacks;
+    *ret_io = &(st75256_io->base);
+    ESP_LOGD(TAG, "new st75256 panel io @%p, addr 0x%02"PRIx32, st75256_io, io_config->dev_addr);
+
+    return ESP_OK;
+
+err:
+    free(st75256_io);
+    return ret;
+}
+
+bool esp_lcd_panel_io_is_st75256(esp_lcd_panel_io_handle_t io)
+{
+    return io && io->del == panel_io_st75256_del;
+}
+
+static esp_err_t panel_io_st75256_del(esp_lcd_panel_io_t *io)
+{
+    st75256_panel_io_t *st75256_io = __containerof(io, st75256_panel_io_t, base);
+    ESP_RETURN_ON_ERROR(i2c_master_bus_rm_device(st75256_io->i2c_handle), TAG, "rm i2c device failed");
+    ESP_LOGD(TAG, "del st75256 panel io @%p", st75256_io);
+    free(st75256_io);
+    return ESP_OK;
+}
+
+static esp_err_t panel_io_st75256_register_event_callbacks(esp_lcd_panel_io_t *io, const esp_lcd_panel_io_callbacks_t *cbs, void *user_ctx)
+{
+    st75256_panel_io_t *st75256_io = __containerof(io, st75256_panel_io_t, base);
+    st75256_io->on_color_trans_done = cbs->on_color_trans_done;
+    st75256_io->user_ctx = user_ctx;
+    return ESP_OK;
+}
+
+static esp_err_t panel_io_st75256_rx_param(esp_lcd_panel_io_t *io, int lcd_cmd, void *param, size_t param_size)
+{
+    // Reading back over I2C is not used by the ST75256 driver
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+// Append one byte with its control byte. The Co bit of the previous control byte is set here,
+// so the last byte of a header always ends the control sequence (Co=0).
+static inline void st75256_io_push(st75256_panel_io_t *st75256_io, uint8_t ctrl, uint8_t byte)
+{
+    if (st75256_io->hdr_len) {
+        st75256_io->hdr[st75256_io->hdr_len - 2] |= ST75256_CTRL_CO;
+    }
+    st75256_io->hdr[st75256_io->hdr_len++] = ctrl;
+    st75256_io->hdr[st75256_io->hdr_len++] = byte;
+}
+
+// Send the encoded header plus an optional data phase in one START...STOP
+static esp_err_t st75256_io_transmit(st75256_panel_io_t *st75256_io, const void *data, size_t data_size, bool notify)
+{
+    i2c_master_transmit_multi_buffer_info_t buffers[2];
+    size_t num_buffers = 1;
+
+    if (data_size) {
+        // Data phase: one control byte with A0=1 and Co=0, everything after it is RAM data
+        if (st75256_io->hdr_len) {
+            st75256_io->hdr[st75256_io->hdr_len - 2] |= ST75256_CTRL_CO;
+        }
+        st75256_io->hdr[st75256_io->hdr_len++] = ST75256_CTRL_A0;
+        buffers[1].write_buffer = (uint8_t *)data;
+        buffers[1].buffer_size = data_size;
+        num_buffers = 2;
+    }
+    buffers[0].write_buffer = st75256_io->hdr;
+    buffers[0].buffer_size = st75256_io->hdr_len;
+    st75256_io->hdr_len = 0;
+
+    if (buffers[0].buffer_size == 0) {
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_ERROR(i2c_master_multi_buffer_transmit(st75256_io->i2c_handle, buffers, num_buffers, -1), TAG, "i2c transmit failed");
+
+    if (notify && data_size && st75256_io->on_color_trans_done) {
+        st75256_io->on_color_trans_done(&st75256_io->base, NULL, st75256_io->user_ctx);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t panel_io_st75256_tx_param(esp_lcd_panel_io_t *io, int lcd_cmd, const void *param, size_t param_size)
+{
+    st75256_panel_io_t *st75256_io = __containerof(io, st75256_panel_io_t, base);
+    const uint8_t *params = param;
+    ESP_RETURN_ON_FALSE(param_size < ESP_LCD_PANEL_IO_ST75256_MAX_CMD_BYTES, ESP_ERR_INVALID_SIZE, TAG, "too many parameters");
+
+    st75256_io->hdr_len = 0;
+    if (lcd_cmd >= 0) {
+        st75256_io_push(st75256_io, 0x00, lcd_cmd);
+    }
+    for (size_t i = 0; i < param_size; i++) {
+        st75256_io_push(st75256_io, ST75256_CTRL_A0, params[i]);
+    }
+    return st75256_io_transmit(st75256_io, NULL, 0, false);
+}
+
+static esp_err_t panel_io_st75256_tx_color(esp_lcd_panel_io_t *io, int lcd_cmd, const void *color, size_t color_size)
+{
+    st75256_panel_io_t *st75256_io = __containerof(io, st75256_panel_io_t, base);
+
+    st75256_io->hdr_len = 0;
+    if (lcd_cmd >= 0) {
+        st75256_io_push(st75256_io, 0x00, lcd_cmd);
+    }
+    return st75256_io_transmit(st75256_io, color, color_size, true);
+}
+
+esp_err_t esp_lcd_panel_io_st75256_get_scl_speed(esp_lcd_panel_io_handle_t io, uint32_t *scl_speed_hz)
+{
+    ESP_RETURN_ON_FALSE(esp_lcd_panel_io_is_st75256(io) && scl_speed_hz, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st75256_panel_io_t *st75256_io = __containerof(io, st75256_panel_io_t, base);
+    *scl_speed_hz = st75256_io->scl_speed_hz;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_io_st75256_tx_stream(esp_lcd_panel_io_handle_t io, const uint8_t *cmds, size_t cmds_size,
+                                             const void *data, size_t data_size)
+{
+    ESP_RETURN_ON_FALSE(esp_lcd_panel_io_is_st75256(io), ESP_ERR_INVALID_ARG, TAG, "not an st75256 panel io");
+    ESP_RETURN_ON_FALSE(cmds_size <= ESP_LCD_PANEL_IO_ST75256_MAX_CMD_BYTES, ESP_ERR_INVALID_SIZE, TAG, "command list too long");
+    st75256_panel_io_t *st75256_io = __containerof(io, st75256_panel_io_t, base);
+
+    st75256_io->hdr_len = 0;
+    size_t pos = 0;
+    while (pos < cmds_size) {
+        ESP_RETURN_ON_FALSE(pos + 2 <= cmds_size && pos + 2 + cmds[pos + 1] <= cmds_size, ESP_ERR_INVALID_ARG, TAG, "malformed command list");
+        uint8_t num_params = cmds[pos + 1];
+        st75256_io_push(st75256_io, 0x00, cmds[pos]);
+        for (size_t i = 0; i < num_params; i++) {
+            st75256_io_push(st75256_io, ST75256_CTRL_A0, cmds[pos + 2 + i]);
+        }
+        pos += 2 + num_params;
+    }
+    // One flush can take several streams, the caller reports the end with esp_lcd_panel_io_st75256_signal_done()
+    return st75256_io_transmit(st75256_io, data, data_size, false);
+}
+
+esp_err_t esp_lcd_panel_io_st75256_signal_done(esp_lcd_panel_io_handle_t io)
+{
+    ESP_RETURN_ON_FALSE(esp_lcd_panel_io_is_st75256(io), ESP_ERR_INVALID_ARG, TAG, "not an st75256 panel io");
+    st75256_panel_io_t *st75256_io = __containerof(io, st75256_panel_io_t, base);
+    if (st75256_io->on_color_trans_done) {
+        st75256_io->on_color_trans_done(&st75256_io->base, NULL, st75256_io->user_ctx);
+    }
+    return ESP_OK;
+}
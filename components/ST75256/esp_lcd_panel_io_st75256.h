@@ -0,0 +1,121 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Your Name
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_lcd_panel_io.h"
+#include "driver/i2c_master.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Maximum command bytes (commands + parameters) accepted by one
+ *        esp_lcd_panel_io_st75256_tx_stream() call
+ */
+#define ESP_LCD_PANEL_IO_ST75256_MAX_CMD_BYTES  64
+
+/**
+ * @brief ST75256 I2C panel IO configuration structure
+ */
+typedef struct {
+    uint32_t dev_addr;      /*!< I2C device address of the ST75256 (0x3C or 0x3F) */
+    uint32_t scl_speed_hz;  /*!< I2C SCL frequency */
+    esp_lcd_panel_io_color_trans_done_cb_t on_color_trans_done; /*!< Callback invoked when color data transfer has finished */
+    void *user_ctx;         /*!< User private data, passed directly to on_color_trans_done's user_ctx */
+} esp_lcd_panel_io_st75256_config_t;
+
+/**
+ * @brief Create an ST75256 specific I2C panel IO
+ *
+ * Unlike the generic I2C panel IO, commands, their parameters and the pixel stream
+ * are encoded with the controller's continuation control bytes (Co/A0) and sent in a
+ * single START...STOP sequence, so the address byte and start/stop overhead are paid
+ * once per transfer instead of once per command.
+ *
+ * The standard esp_lcd_panel_io_tx_param() / esp_lcd_panel_io_tx_color() calls work as
+ * usual (parameters are sent with A0=1). The ST75256 panel driver detects this IO and
+ * batches a whole flush through esp_lcd_panel_io_st75256_tx_stream().
+ *
+ * @param[in] bus I2C master bus handle
+ * @param[in] io_config IO configuration
+ * @param[out] ret_io Returned panel IO handle
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_ERR_NO_MEM        if out of memory
+ *          - ESP_OK                on success
+ *
+ * Example usage:
+ * @code {c}
+ * esp_lcd_panel_io_st75256_config_t io_config = {
+ *     .dev_addr = 0x3C,
+ *     .scl_speed_hz = 800000,
+ * };
+ * esp_lcd_new_panel_io_st75256(i2c_bus_handle, &io_config, &io_handle);
+ * @endcode
+ */
+esp_err_t esp_lcd_new_panel_io_st75256(i2c_master_bus_handle_t bus, const esp_lcd_panel_io_st75256_config_t *io_config,
+                                       esp_lcd_panel_io_handle_t *ret_io);
+
+/**
+ * @brief Check whether a panel IO handle was created by esp_lcd_new_panel_io_st75256()
+ *
+ * @param[in] io Panel IO handle
+ * @return true if the IO supports esp_lcd_panel_io_st75256_tx_stream()
+ */
+bool esp_lcd_panel_io_is_st75256(esp_lcd_panel_io_handle_t io);
+
+/**
+ * @brief Get the SCL frequency an ST75256 panel IO was created with
+ *
+ * @param[in] io Panel IO handle created by esp_lcd_new_panel_io_st75256()
+ * @param[out] scl_speed_hz Returned esp_lcd_panel_io_st75256_config_t.scl_speed_hz
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if the IO was not created by esp_lcd_new_panel_io_st75256()
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_io_st75256_get_scl_speed(esp_lcd_panel_io_handle_t io, uint32_t *scl_speed_hz);
+
+/**
+ * @brief Send a list of commands followed by RAM data in one I2C transaction
+ *
+ * `cmds` is a sequence of records `[cmd][n][param_0]...[param_n-1]`. Each command is sent
+ * with A0=0 and its parameters with A0=1, then `data` (if any) follows as one continuous
+ * data phase, which is what 0x5C (write RAM) expects.
+ *
+ * The transfer is blocking and does not invoke on_color_trans_done, since one flush may
+ * need several streams. Call esp_lcd_panel_io_st75256_signal_done() when the flush is complete.
+ *
+ * @param[in] io Panel IO handle created by esp_lcd_new_panel_io_st75256()
+ * @param[in] cmds Encoded command list, can be NULL if `cmds_size` is 0
+ * @param[in] cmds_size Size of the command list in bytes
+ * @param[in] data RAM data, can be NULL if `data_size` is 0
+ * @param[in] data_size Size of the RAM data in bytes
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid or the command list is malformed
+ *          - ESP_ERR_INVALID_SIZE  if the command list holds more than ESP_LCD_PANEL_IO_ST75256_MAX_CMD_BYTES
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_io_st75256_tx_stream(esp_lcd_panel_io_handle_t io, const uint8_t *cmds, size_t cmds_size,
+                                             const void *data, size_t data_size);
+
+/**
+ * @brief Invoke on_color_trans_done to report that a flush has been sent completely
+ *
+ * @param[in] io Panel IO handle created by esp_lcd_new_panel_io_st75256()
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if the IO was not created by esp_lcd_new_panel_io_st75256()
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_io_st75256_signal_done(esp_lcd_panel_io_handle_t io);
+
+#ifdef __cplusplus
+}
+#endif
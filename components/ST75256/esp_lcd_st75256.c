@@ -1,10 +1,17 @@
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
+#include <inttypes.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
 #include "esp_lcd_panel_interface.h"
 #include "esp_lcd_panel_io.h"
 #include "esp_lcd_st75256.h"
+#include "esp_lcd_panel_io_st75256.h"
+#include "st75256_kernels.h"
 #include "esp_log.h"
 #include "esp_lcd_panel_ops.h"
 #include "esp_compiler.h"
@@ -12,8 +19,10 @@
 #include "esp_err.h"
 #include "esp_check.h"               // 提供 ESP_RETURN_ON_ERROR 等
 #include "esp_lcd_panel_vendor.h"
+#include "esp_timer.h"
 #include <stdint.h>
 #include <sys/cdefs.h>
+#include <sys/param.h>
 #include "sdkconfig.h"
 #if CONFIG_LCD_ENABLE_DEBUG_LOG
 // The local log level must be defined before including esp_log.h
@@ -41,61 +50,547 @@ static const char *TAG = "lcd_panel.st75256";
 #define ST75256_CMD_SET_POWER_CONTROL     0x20  // Followed by 1 byte
 #define ST75256_CMD_SET_DISPLAY_MODE      0xF0  // Followed by 1 byte
 #define ST75256_CMD_SET_SCAN_DIRECTION    0xBC  // Followed by 1 byte: 0x00~0x07
+#define ST75256_CMD_SET_AREA_SCROLL       0xAA  // Followed by 4 byte: top block, bottom block, blocks, mode
+#define ST75256_CMD_SET_SCROLL_START      0xAB  // Followed by 1 byte: display start line
 
 // ST75256 Commands (Command Set 2, entered by sending 0x31)
 #define ST75256_CMD_SET_GRAYSCALE_TABLE   0x20  // Followed by 16 bytes
 #define ST75256_CMD_DISABLE_AUTO_READ     0xD7  // Disable OPT auto read
 #define ST75256_CMD_ANALOG_CIRCUIT_SET    0x32  // Followed by 3 byte
+#define ST75256_CMD_SET_FRAME_RATE        0xF0  // Followed by 4 byte: one code per temperature range
 
 // Command set selectors
 #define ST75256_CMD_SET_1                 0x30  // Switch to Command Set 1
 #define ST75256_CMD_SET_2                 0x31  // Switch to Command Set 2
 
 // ST75256 Physical Coordinates
-#define ST75256_TOTAL_PAGES               0x14  // Total 21 pages 
-
-// Predefined grayscale table (16 levels)
+#define ST75256_MAX_COLUMNS               256   // Column addresses, a column mirror reverses all of them
+#define ST75256_MAX_DDRAM_ROWS            248   // Rows the 8-bit start line (0xAB) and window math can address
+// Default geometry (JLX256128G), used for zero fields of esp_lcd_panel_st75256_geometry_t
+#define ST75256_DEFAULT_WIDTH             256   // Visible columns (landscape)
+#define ST75256_DEFAULT_HEIGHT            128   // Visible rows (landscape)
+#define ST75256_DEFAULT_DDRAM_PAGES       21    // DDRAM pages of 8 rows, visible or not (168 rows)
+
+// Shadow framebuffer
+#define ST75256_TX_CHUNK_SIZE             256   // Bounce buffer used to pack strided windows
+#define ST75256_WINDOW_COST               20    // Approx. bus bytes spent opening a column/page window
+
+// Bus sharing
+#define ST75256_SCL_CLOCKS_PER_BYTE       9     // 8 data bits + ACK
+
+// Power save
+#define ST75256_SLEEP_OUT_DELAY_MS        10    // Booster and regulators settle after 0x94
+#define ST75256_IDLE_RETRY_US             10000 // Idle timer found the panel busy (blocking mode)
+
+// Adaptive frame rate
+#define ST75256_FRAME_RATE_ACTIVE_FPS     10    // Default esp_lcd_panel_st75256_frame_rate_t.active_fps
+#define ST75256_FRAME_RATE_IDLE_MS        500   // Default esp_lcd_panel_st75256_frame_rate_t.idle_ms
+#define ST75256_CADENCE_MAX_US            1000000 // Longest flush interval the cadence counts, a pause is not longer
+#define ST75256_CADENCE_SMOOTHING         4     // Each flush moves the smoothed interval 1/4 of the way
+
+// Async flush
+#define ST75256_FLUSH_QUEUE_LEN           8     // LVGL's draw buffers, other producers and queued control operations
+#define ST75256_FLUSH_TASK_PRIO           5     // Default, just above the esp_lvgl_port task
+#define ST75256_FLUSH_TASK_STACK          3072
+#define ST75256_EVENT_JOBS_RUN            (1 << 0) // Flush task ran a batch of jobs
+#define ST75256_STATS_TASK_PRIO           1
+#define ST75256_STATS_TASK_STACK          3072
+
+// Display modes (0xF0)
+#define ST75256_DISPLAY_MODE_MONO         0x10  // 1 bit per pixel, 8 rows per page
+#define ST75256_DISPLAY_MODE_GRAY         0x11  // 2 bits per pixel, 4 rows per page
+
+// Area scroll (0xAA), scroll blocks are 4 DDRAM rows
+#define ST75256_SCROLL_BLOCK_ROWS         4
+#define ST75256_SCROLL_MODE_WHOLE         0x03  // Whole screen scroll
+
+// Predefined grayscale table (16 levels), gray mode only
 static const uint8_t grayscale_table[16] = {
     0x01, 0x03, 0x05, 0x07, 0x09, 0x0B, 0x0D, 0x10,
     0x11, 0x13, 0x15, 0x17, 0x19, 0x1B, 0x1D, 0x1F
 };
 
-// Panel private data
+// Glass settings of the JLX256128G, [cmd][n][params...] records (see ESP_LCD_ST75256_INIT_DELAY)
+static const uint8_t default_init_cmds[] = {
+    ST75256_CMD_SET_2, 0,
+    ST75256_CMD_DISABLE_AUTO_READ, 1, 0x9F,
+    ST75256_CMD_ANALOG_CIRCUIT_SET, 3, 0x00, 0x01, 0x00,
+    ST75256_CMD_SET_1, 0,
+    ST75256_CMD_SET_CONTRAST, 2, 0x1E, 0x05,
+    ST75256_CMD_SET_POWER_CONTROL, 1, 0x0B,
+    ST75256_CMD_DISPLAY_CONTROL, 3, 0x00, 0x7F, 0x20, // CL 不分频, 占空比=1/128, 帧反转（帧频由 0xF0 设置）
+};
+
+// Operations the flush task runs, in the order they were queued
+typedef enum {
+    ST75256_JOB_DRAW,         // draw_bitmap(), reports through on_color_trans_done
+    ST75256_JOB_DRAW_CB,      // esp_lcd_panel_st75256_queue_bitmap(), reports through its own callback
+    ST75256_JOB_FILL,         // esp_lcd_panel_st75256_fill_rect()
+    ST75256_JOB_INVERT,       // invert_color()
+    ST75256_JOB_DISP_ON_OFF,  // disp_on_off()
+    ST75256_JOB_MIRROR,       // mirror()
+    ST75256_JOB_SWAP_XY,      // swap_xy()
+    ST75256_JOB_POWER_SAVE,   // esp_lcd_panel_st75256_set_power_save()
+    ST75256_JOB_IDLE,         // Idle timer expired, enter power save unless drawn since
+    ST75256_JOB_STOP,         // panel_st75256_del(): the flush task reports back and exits
+} st75256_job_type_t;
+
+// A panel call waiting for the flush task, color_data stays valid until the job is reported done
 typedef struct {
+    st75256_job_type_t type;
+    int x_start;              // Draw and fill area
+    int y_start;
+    int x_end;
+    int y_end;
+    const void *color_data;
+    esp_lcd_panel_st75256_done_cb_t on_done; // ST75256_JOB_DRAW_CB only
+    void *user_ctx;
+    uint8_t pattern;          // Fill byte
+    bool enable;              // Invert, display on, swap axes, mirror X, power save
+    bool mirror_y;
+} st75256_flush_job_t;
+
+typedef struct st75256_panel st75256_panel_t;
+typedef esp_err_t (*st75256_draw_fn_t)(st75256_panel_t *st75256, int x_start, int y_start, int x_end, int y_end, const uint8_t *data);
+
+// Everything the current orientation and input format need, worked out once when either changes
+typedef struct {
+    uint8_t scan_dir;             // 0xBC parameter: bit2 page first, bit1 column addresses reversed, bit0 page addresses reversed
+    uint8_t data_order;           // 0x0C (LSB on top), 0x08 (MSB on top) flips the rows within each page for the row mirror
+    bool row_mirror;              // Rows reversed, the visible rows then sit at the other end of DDRAM
+    uint8_t row_offset;           // Added to window rows: DDRAM rows hidden above the visible ones
+    uint8_t col_offset;           // Added to window columns: column_offset, counted from the other end if reversed
+    uint8_t x_mask;               // Alignment draw areas need in LVGL X and Y (pixels - 1)
+    uint8_t y_mask;
+    st75256_draw_fn_t draw;       // Send as a native window, or convert through the remap buffer
+    st75256_kernel_fn_t convert;  // Conversion kernel of st75256_draw_converted(), NULL for native input
+    st75256_kernel_fn_t convert_full; // Same, specialized for areas as wide as the screen (see st75256_kernel_for_width())
+    uint16_t full_width;          // LVGL width of the screen in this orientation
+} st75256_plan_t;
+
+// Panel private data
+struct st75256_panel {
     esp_lcd_panel_t base;
     esp_lcd_panel_io_handle_t io;
-    uint8_t height;           // Physical height in pixels (128 or 256)
-    uint8_t width;            // Physical width in pixels (256 or 128)
+    uint16_t height;          // Physical height in pixels at creation (e.g. 128, 256 in portrait)
+    uint16_t width;           // Physical width in pixels at creation (e.g. 256, 128 in portrait)
+    uint16_t columns;         // Visible DDRAM columns (landscape orientation)
+    uint8_t pages;            // Visible DDRAM pages (landscape orientation)
+    uint8_t page_rows;        // Rows per page: 8 (monochrome) or 4 (gray)
+    uint8_t ddram_pages;      // All DDRAM pages, including the rows used by Y mirroring
+    uint8_t ddram_rows;       // ddram_pages * page_rows, the rows scrolling wraps around
+    uint8_t column_offset;    // First DDRAM column of the glass
+    bool gray;                // 4-level gray mode, draw_bitmap takes 8-bit pixels
     int reset_gpio_num;
     int x_gap;
     int y_gap;
     unsigned int bits_per_pixel;
     bool reset_level;
     bool swap_axes;           // true = 128x256 mode, false = 256x128 mode
-    bool y_mirror;           // true = Y mirror mode, false = Y normal mode
-} st75256_panel_t;
+    bool mirror_x;            // LVGL X mirrored (esp_lcd_panel_mirror())
+    bool mirror_y;            // LVGL Y mirrored
+    st75256_plan_t plan;      // Derived from swap_axes, mirror_x/y, gray and input_format by st75256_update_plan()
+    uint8_t scroll_line;      // Display start line (0xAB), landscape only: screen row r shows DDRAM row r + scroll_line
+    uint8_t *shadow;          // Copy of the visible DDRAM in transmit order, NULL if disabled
+    uint8_t *dirty_lo;        // Per shadow line: first changed byte (lo > hi means clean)
+    uint8_t *dirty_hi;        // Per shadow line: last changed byte
+    uint16_t shadow_lines;    // Lines in the shadow: pages (landscape) or columns (portrait)
+    uint16_t shadow_stride;   // Bytes per shadow line
+    uint8_t *remap_buf;       // Portrait transpose output, allocated on first use
+    bool remap_strip;         // Convert one band at a time through a small buffer
+    esp_lcd_st75256_input_format_t input_format; // Monochrome draw_bitmap layout
+    esp_lcd_panel_st75256_stats_t stats;
+    struct {
+        uint8_t cmd_set;      // Active command set (ST75256_CMD_SET_1/2), 0 = unknown
+        uint8_t data_order;   // Last 0x08/0x0C sent, 0 = unknown
+        uint8_t scan_dir;     // Last 0xBC parameter
+        bool scan_valid;
+        bool window_valid;    // Window registers match `window` and the address counter sits at its origin
+        uint8_t window[4];    // col_start, col_end, page_start, page_end (inclusive)
+        bool scroll_area;     // Whole screen scroll mode (0xAA) programmed
+    } cache;                  // What the controller currently holds, used to elide redundant writes
+    struct {
+        uint8_t window[4];    // Window opened by the last st75256_set_ddram_window(), as in cache.window
+        uint16_t line_bytes;  // Bytes per line of it: columns (landscape) or pages (page first scan)
+        size_t size;          // Bytes filling it once
+        size_t pos;           // Bytes written into it so far, modulo size
+    } ram;                    // Where RAM writes stand, for reopening the rest of a window after a slice
+    size_t slice_bytes;       // Bus sharing: most pixel bytes per transaction, 0 = unlimited
+    bool stream_io;           // IO from esp_lcd_new_panel_io_st75256(): commands are batched with the next data
+    uint32_t scl_speed_hz;    // Stream IO SCL, 0 if unknown: bus hold times are then measured rather than computed
+    size_t cmd_list_len;
+    size_t cmd_list_bytes;    // Command and parameter bytes in cmd_list (without the [n] fields)
+    uint8_t cmd_list[ESP_LCD_PANEL_IO_ST75256_MAX_CMD_BYTES]; // Pending [cmd][n][params...] records
+    uint8_t tx_buf[ST75256_TX_CHUNK_SIZE];
+    QueueHandle_t flush_queue;   // Async flush only: pending st75256_flush_job_t
+    EventGroupHandle_t flush_events; // ST75256_EVENT_JOBS_RUN, for st75256_lock() callers waiting on queued jobs
+    uint32_t jobs_run;           // Jobs the flush task has run, counted under the lock
+    SemaphoreHandle_t flush_task_done; // Given by the flush task as it exits
+    SemaphoreHandle_t lock;      // Serialises panel state and the bus between callers and the flush task
+    bool shadow_batch;           // Flush task merging queued draws: shadow commits wait for the whole batch
+    size_t batch_submitted;      // Bytes handed in by the draws of the batch so far
+    TaskHandle_t flush_task;
+    TaskHandle_t stats_task;     // Optional statistics log task, stopped by a notification
+    SemaphoreHandle_t stats_task_done;
+    uint16_t stats_period_ms;
+    bool disp_on;                // Last disp_on_off(), restored when leaving power save
+    bool power_save;             // Sleeping (0x95): display off, DDRAM and registers retained
+    esp_timer_handle_t idle_timer; // Automatic power save and idle frame rate
+    SemaphoreHandle_t timer_lock;  // Held by the idle timer callback, del waits on it before deleting the timer
+    bool deleting;                 // del has started: the idle timer is not armed again
+    int64_t idle_us;             // Power save after this long without draws or fills, 0 = never
+    int64_t last_activity_us;    // Last draw or fill, for the idle timer
+    esp_lcd_panel_st75256_frame_rate_t frame_rate; // Defaults filled in, all zero = the driver leaves the frame rate alone
+    uint8_t frame_rate_code;     // Last frame rate code sent
+    int64_t last_flush_us;       // Last draw, for the flush cadence and the idle frame rate
+    uint32_t flush_interval_us;  // Smoothed time between draws
+    const uint8_t *init_cmds;    // Glass init table, default_init_cmds or the user's
+    size_t init_cmds_size;
+};
 
-static void st75256_remap_swapped_frame(uint8_t *src, uint8_t *dst);
-static inline void st75256_apply_mirror(int *start, int *end);
+static esp_err_t st75256_set_ddram_window(st75256_panel_t *st75256, uint8_t col_start, uint8_t col_end, uint8_t page_start, uint8_t page_end);
+static esp_err_t st75256_resume_ddram_window(st75256_panel_t *st75256);
+static esp_err_t st75256_set_window(st75256_panel_t *st75256, int col_start, int col_end, int row_start, int row_end);
+static esp_err_t st75256_stream_pattern(st75256_panel_t *st75256, uint8_t pattern, size_t size);
+static void st75256_shadow_set_layout(st75256_panel_t *st75256);
+static void st75256_shadow_invalidate(st75256_panel_t *st75256);
+static void st75256_shadow_mark_clean(st75256_panel_t *st75256);
+static void st75256_shadow_scroll(st75256_panel_t *st75256, int lines);
+static void st75256_shadow_put(st75256_panel_t *st75256, int col_start, int col_end, int row_start, int row_end, const uint8_t *data);
+static esp_err_t st75256_shadow_commit(st75256_panel_t *st75256, size_t submitted);
+static esp_err_t st75256_draw_native(st75256_panel_t *st75256, int col_start, int col_end, int row_start, int row_end, const uint8_t *data);
+static esp_err_t st75256_draw_landscape(st75256_panel_t *st75256, int x_start, int y_start, int x_end, int y_end, const uint8_t *data);
+static esp_err_t st75256_draw_portrait(st75256_panel_t *st75256, int x_start, int y_start, int x_end, int y_end, const uint8_t *data);
+static esp_err_t st75256_draw_converted(st75256_panel_t *st75256, int x_start, int y_start, int x_end, int y_end, const uint8_t *src);
+static esp_err_t st75256_draw(st75256_panel_t *st75256, int x_start, int y_start, int x_end, int y_end, const uint8_t *data);
+static void st75256_flush_done(st75256_panel_t *st75256, uint64_t sent_before, esp_err_t draw_ret);
+static void st75256_flush_task(void *arg);
+static esp_err_t st75256_run_job(st75256_panel_t *st75256, const st75256_flush_job_t *job);
+static void st75256_stats_task(void *arg);
+static void st75256_idle_timer_cb(void *arg);
+static void st75256_frame_rate_defaults(esp_lcd_panel_st75256_frame_rate_t *out, const esp_lcd_panel_st75256_frame_rate_t *in);
+static bool st75256_init_cmds_valid(const uint8_t *cmds, size_t size);
+static esp_err_t st75256_init_sequence(st75256_panel_t *st75256);
+
+// Take the panel. Async flush: only once the jobs queued before the call have run, jobs queued later
+// do not hold the caller up. The flush task itself (on_done, on_color_trans_done) would wait for its
+// own queue, it takes the panel right away.
+static void st75256_lock(st75256_panel_t *st75256)
+{
+    xSemaphoreTake(st75256->lock, portMAX_DELAY);
+    if (!st75256->flush_queue || xTaskGetCurrentTaskHandle() == st75256->flush_task) {
+        return;
+    }
+    // The flush task takes jobs out of the queue and runs them without releasing the lock,
+    // so under the lock every job queued so far is either run or still in the queue
+    uint32_t target = st75256->jobs_run + uxQueueMessagesWaiting(st75256->flush_queue);
+    while ((int32_t)(target - st75256->jobs_run) > 0) {
+        // Cleared under the lock, the flush task sets it under the lock: no batch goes unnoticed
+        xEventGroupClearBits(st75256->flush_events, ST75256_EVENT_JOBS_RUN);
+        xSemaphoreGive(st75256->lock);
+        xEventGroupWaitBits(st75256->flush_events, ST75256_EVENT_JOBS_RUN, pdFALSE, pdTRUE, portMAX_DELAY);
+        xSemaphoreTake(st75256->lock, portMAX_DELAY);
+    }
+}
 
-// Helper: switch to Command Set 1
-static inline esp_err_t st75256_set_cmd_set_1(esp_lcd_panel_io_handle_t io)
+static void st75256_unlock(st75256_panel_t *st75256)
 {
-    return esp_lcd_panel_io_tx_param(io, ST75256_CMD_SET_1, NULL, 0);
+    xSemaphoreGive(st75256->lock);
 }
 
-// Helper: switch to Command Set 2
-static inline esp_err_t st75256_set_cmd_set_2(esp_lcd_panel_io_handle_t io)
+// Forget everything cached about the controller state, the next writes are sent unconditionally
+static void st75256_invalidate_cache(st75256_panel_t *st75256)
 {
-    return esp_lcd_panel_io_tx_param(io, ST75256_CMD_SET_2, NULL, 0);
+    memset(&st75256->cache, 0, sizeof(st75256->cache));
+    st75256->cmd_list_len = 0;
+    st75256->cmd_list_bytes = 0;
+}
+
+// Account one I2C transaction started at `start`: `cmd_bytes` commands/parameters, `ctrl_bytes` control bytes
+// and `data_bytes` RAM bytes besides the address
+static inline void st75256_count_tx(st75256_panel_t *st75256, int64_t start, size_t cmd_bytes, size_t ctrl_bytes, size_t data_bytes)
+{
+    uint32_t bus_us = esp_timer_get_time() - start;
+    // The measured time includes waiting for other devices to release the bus, the wire time does not
+    uint32_t hold_us = bus_us;
+    if (st75256->scl_speed_hz) {
+        hold_us = (uint64_t)(1 + cmd_bytes + ctrl_bytes + data_bytes) * ST75256_SCL_CLOCKS_PER_BYTE * 1000000 / st75256->scl_speed_hz;
+    }
+    st75256->stats.bus_us += bus_us;
+    st75256->stats.bus_hold_max_us = MAX(st75256->stats.bus_hold_max_us, hold_us);
+    st75256->stats.transactions++;
+    st75256->stats.cmd_bytes += cmd_bytes;
+    st75256->stats.overhead_bytes += 1 + ctrl_bytes;
+}
+
+// Stream IO: the pending command list leaves with this transaction, every byte carries a control byte
+static void st75256_count_stream(st75256_panel_t *st75256, int64_t start, size_t data_bytes)
+{
+    st75256_count_tx(st75256, start, st75256->cmd_list_bytes, st75256->cmd_list_bytes + (data_bytes ? 1 : 0), data_bytes);
+    st75256->cmd_list_len = 0;
+    st75256->cmd_list_bytes = 0;
+}
+
+// Helper: send the pending command list on its own (stream IO only)
+static esp_err_t st75256_flush_cmds(st75256_panel_t *st75256)
+{
+    if (!st75256->cmd_list_len) {
+        return ESP_OK;
+    }
+    int64_t start = esp_timer_get_time();
+    esp_err_t ret = esp_lcd_panel_io_st75256_tx_stream(st75256->io, st75256->cmd_list, st75256->cmd_list_len, NULL, 0);
+    st75256_count_stream(st75256, start, 0);
+    if (ret != ESP_OK) {
+        st75256_invalidate_cache(st75256);
+    }
+    return ret;
+}
+
+// Helper: send one command (A0=0) followed by its parameters (A0=1)
+// With the stream IO the command is only queued, it leaves with the next data or st75256_flush_cmds().
+static esp_err_t st75256_tx_cmd(st75256_panel_t *st75256, uint8_t cmd, const uint8_t *params, size_t size)
+{
+    esp_err_t ret = ESP_OK;
+    if (st75256->stream_io) {
+        ESP_RETURN_ON_FALSE(size + 2 <= sizeof(st75256->cmd_list), ESP_ERR_INVALID_SIZE, TAG, "too many parameters");
+        if (st75256->cmd_list_len + size + 2 > sizeof(st75256->cmd_list)) {
+            ESP_RETURN_ON_ERROR(st75256_flush_cmds(st75256), TAG, "flush commands failed");
+        }
+        uint8_t *rec = st75256->cmd_list + st75256->cmd_list_len;
+        rec[0] = cmd;
+        rec[1] = size;
+        if (size) {
+            memcpy(rec + 2, params, size);
+        }
+        st75256->cmd_list_len += size + 2;
+        st75256->cmd_list_bytes += size + 1;
+        return ESP_OK;
+    }
+
+    int64_t start = esp_timer_get_time();
+    ret = esp_lcd_panel_io_tx_param(st75256->io, cmd, NULL, 0);
+    st75256_count_tx(st75256, start, 1, 1, 0);
+    if (ret == ESP_OK && size) {
+        start = esp_timer_get_time();
+        ret = esp_lcd_panel_io_tx_color(st75256->io, -1, params, size);
+        st75256_count_tx(st75256, start, size, 1, 0);
+    }
+    if (ret != ESP_OK) {
+        // The controller may have seen only part of the sequence
+        st75256_invalidate_cache(st75256);
+    }
+    return ret;
+}
+
+// Send RAM data in one transaction. With the stream IO the pending commands leave with it.
+static esp_err_t st75256_tx_data_once(st75256_panel_t *st75256, const void *data, size_t size)
+{
+    esp_err_t ret;
+    int64_t start = esp_timer_get_time();
+    if (st75256->stream_io) {
+        ret = esp_lcd_panel_io_st75256_tx_stream(st75256->io, st75256->cmd_list, st75256->cmd_list_len, data, size);
+        st75256_count_stream(st75256, start, size);
+    } else {
+        ret = esp_lcd_panel_io_tx_color(st75256->io, -1, data, size);
+        st75256_count_tx(st75256, start, 0, 1, size);
+    }
+    if (ret != ESP_OK) {
+        st75256_invalidate_cache(st75256);
+    }
+    if (st75256->ram.size) {
+        st75256->ram.pos = (st75256->ram.pos + size) % st75256->ram.size;
+    }
+    return ret;
+}
+
+// Helper: send RAM data into the window opened by the last 0x5C
+// Bus sharing: split at line boundaries of the window into slices, let the other bus users in between
+// and reopen the window at the next line, so each slice starts from a known address.
+static esp_err_t st75256_tx_data(st75256_panel_t *st75256, const void *data, size_t size)
+{
+    const uint8_t *bytes = data;
+    while (st75256->slice_bytes && size > st75256->slice_bytes && st75256->ram.size) {
+        size_t line = st75256->ram.line_bytes;
+        size_t pos = st75256->ram.pos;
+        size_t end = (pos + st75256->slice_bytes) / line * line;
+        if (end <= pos) {
+            // A line longer than the slice is not split
+            end = (pos / line + 1) * line;
+        }
+        if (end - pos >= size) {
+            break;
+        }
+        ESP_RETURN_ON_ERROR(st75256_tx_data_once(st75256, bytes, end - pos), TAG, "send pixel slice failed");
+        bytes += end - pos;
+        size -= end - pos;
+        taskYIELD();
+        ESP_RETURN_ON_ERROR(st75256_resume_ddram_window(st75256), TAG, "reopen window failed");
+    }
+    return st75256_tx_data_once(st75256, bytes, size);
+}
+
+// Helper: switch command set (ST75256_CMD_SET_1 / ST75256_CMD_SET_2), skipped if already active
+static esp_err_t st75256_select_cmd_set(st75256_panel_t *st75256, uint8_t cmd_set)
+{
+    if (st75256->cache.cmd_set == cmd_set) {
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_ERROR(st75256_tx_cmd(st75256, cmd_set, NULL, 0), TAG, "switch cmd set failed");
+    st75256->cache.cmd_set = cmd_set;
+    return ESP_OK;
+}
+
+// Helper: send a Command Set 1 command
+static esp_err_t st75256_tx_cmd_1(st75256_panel_t *st75256, uint8_t cmd, const uint8_t *params, size_t size)
+{
+    ESP_RETURN_ON_ERROR(st75256_select_cmd_set(st75256, ST75256_CMD_SET_1), TAG, "enter cmd set 1 failed");
+    return st75256_tx_cmd(st75256, cmd, params, size);
+}
+
+// Helper: send a Command Set 2 command
+static esp_err_t st75256_tx_cmd_2(st75256_panel_t *st75256, uint8_t cmd, const uint8_t *params, size_t size)
+{
+    ESP_RETURN_ON_ERROR(st75256_select_cmd_set(st75256, ST75256_CMD_SET_2), TAG, "enter cmd set 2 failed");
+    return st75256_tx_cmd(st75256, cmd, params, size);
 }
 
 // Helper: send scan direction command (0xBC + value)
 static esp_err_t st75256_set_scan_direction(st75256_panel_t *st75256, uint8_t dir)
 {
-    ESP_RETURN_ON_ERROR(st75256_set_cmd_set_1(st75256->io), TAG, "switch to cmd set 1 failed");
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(st75256->io, ST75256_CMD_SET_SCAN_DIRECTION, NULL, 0), TAG, "send scan dir cmd failed");
-    return esp_lcd_panel_io_tx_color(st75256->io, -1, &dir, 1);
+    if (st75256->cache.scan_valid && st75256->cache.scan_dir == dir) {
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_ERROR(st75256_tx_cmd_1(st75256, ST75256_CMD_SET_SCAN_DIRECTION, &dir, 1), TAG, "send scan dir failed");
+    st75256->cache.scan_dir = dir;
+    st75256->cache.scan_valid = true;
+    // The scan direction changes how the address counter advances
+    st75256->cache.window_valid = false;
+    return ESP_OK;
+}
+
+// Helper: select data order (ST75256_CMD_SET_DATA_MSB / ST75256_CMD_SET_DATA_LSB)
+static esp_err_t st75256_set_data_order(st75256_panel_t *st75256, uint8_t order)
+{
+    if (st75256->cache.data_order == order) {
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_ERROR(st75256_tx_cmd_1(st75256, order, NULL, 0), TAG, "set data format failed");
+    st75256->cache.data_order = order;
+    return ESP_OK;
+}
+
+// Screen row (landscape, gap excluded) shown from DDRAM row 0 while scrolled, INT_MAX if not scrolled.
+// DDRAM wraps around there, so no window may cross it.
+static int st75256_scroll_wrap(st75256_panel_t *st75256)
+{
+    if (!st75256->scroll_line) {
+        return INT_MAX;
+    }
+    return st75256->ddram_rows - st75256->scroll_line - st75256->y_gap;
+}
+
+// Helper: move the display start line, the shadow follows the content (landscape only)
+static esp_err_t st75256_set_scroll_line(st75256_panel_t *st75256, int line)
+{
+    if (!st75256->cache.scroll_area) {
+        uint8_t blocks = st75256->ddram_rows / ST75256_SCROLL_BLOCK_ROWS;
+        uint8_t area[4] = {0x00, blocks - 1, blocks, ST75256_SCROLL_MODE_WHOLE};
+        ESP_RETURN_ON_ERROR(st75256_tx_cmd_1(st75256, ST75256_CMD_SET_AREA_SCROLL, area, sizeof(area)), TAG, "set scroll area failed");
+        st75256->cache.scroll_area = true;
+    }
+    uint8_t start_line = line;
+    ESP_RETURN_ON_ERROR(st75256_tx_cmd_1(st75256, ST75256_CMD_SET_SCROLL_START, &start_line, 1), TAG, "set scroll start failed");
+    ESP_RETURN_ON_ERROR(st75256_flush_cmds(st75256), TAG, "set scroll start failed");
+
+    // The content moved up by the difference, take the shorter way around the DDRAM rows
+    int delta = line - st75256->scroll_line;
+    if (delta > st75256->ddram_rows / 2) {
+        delta -= st75256->ddram_rows;
+    } else if (delta < -st75256->ddram_rows / 2) {
+        delta += st75256->ddram_rows;
+    }
+    st75256_shadow_scroll(st75256, delta / st75256->page_rows);
+    st75256->scroll_line = line;
+    return ESP_OK;
+}
+
+/**
+ * 方向引擎：swap_xy 与 mirror 的 8 种组合全部由硬件完成，软件只做硬件做不到的部分。
+ *  - swap_axes：0xBC bit2，页地址优先递增，LVGL X 沿硬件行（页），Y 沿硬件列
+ *  - 列方向镜像：0xBC bit1（列地址反向），DDRAM 内容不变
+ *  - 行方向镜像：0xBC bit0 反转页地址（作用于全部 168 行 DDRAM 的 21 页），页内的行由数据格式 0x08（MSB 在上）反转，
+ *    两者合起来把可见的 128 行放到 DDRAM 的最后 128 行，窗口只需整体偏移 row_offset（与基线及 u8g2 的翻转方式相同）
+ * 竖屏时 mirror_x 作用于行、mirror_y 作用于列。需要软件处理的只有数据格式：
+ * 竖屏下 LVGL 页格式需要 8x8 转置，I1 与灰度输入需要打包。结果记录在 plan 中，刷新时不再判断。
+ */
+static void st75256_update_plan(st75256_panel_t *st75256)
+{
+    st75256_plan_t *plan = &st75256->plan;
+    const bool swap = st75256->swap_axes;
+    bool col_mirror = swap ? st75256->mirror_y : st75256->mirror_x;
+    plan->row_mirror = swap ? st75256->mirror_x : st75256->mirror_y;
+    plan->scan_dir = (swap ? 0x04 : 0x00) | (col_mirror ? 0x02 : 0x00) | (plan->row_mirror ? 0x01 : 0x00);
+    plan->data_order = plan->row_mirror ? ST75256_CMD_SET_DATA_MSB : ST75256_CMD_SET_DATA_LSB;
+    plan->row_offset = plan->row_mirror ? (st75256->ddram_pages - st75256->pages) * st75256->page_rows : 0;
+    plan->col_offset = col_mirror ? ST75256_MAX_COLUMNS - st75256->columns - st75256->column_offset : st75256->column_offset;
+    plan->full_width = swap ? st75256->pages * st75256->page_rows : st75256->columns;
+
+    plan->x_mask = 0;
+    plan->y_mask = 0;
+    if (st75256->gray) {
+        plan->convert = swap ? st75256_pack_gray_rows : st75256_pack_gray_pages;
+    } else if (st75256->input_format == ESP_LCD_ST75256_INPUT_I1) {
+        plan->convert = swap ? st75256_pack_i1_rows : st75256_pack_i1_pages;
+    } else if (swap && st75256->input_format == ESP_LCD_ST75256_INPUT_LVGL_PAGES) {
+        // Transposed in 8x8 blocks
+        plan->convert = st75256_remap_swapped;
+        plan->y_mask = 0x07;
+    } else {
+        plan->convert = NULL;
+    }
+    // DDRAM is written a page at a time: areas cover whole pages along the page axis, whatever the input
+    if (swap) {
+        plan->x_mask = st75256->page_rows - 1;
+    } else {
+        plan->y_mask = st75256->page_rows - 1;
+    }
+
+    plan->convert_full = st75256_kernel_for_width(plan->convert, plan->full_width);
+    if (plan->convert) {
+        plan->draw = st75256_draw_converted;
+    } else {
+        plan->draw = swap ? st75256_draw_portrait : st75256_draw_landscape;
+    }
+}
+
+// Switch orientation: the shadow and the scan direction follow the new plan
+static esp_err_t st75256_set_orientation(st75256_panel_t *st75256, bool swap_axes, bool mirror_x, bool mirror_y)
+{
+    bool swap_changed = swap_axes != st75256->swap_axes;
+    bool rows_moved = swap_changed || (swap_axes ? mirror_x : mirror_y) != st75256->plan.row_mirror;
+    if (rows_moved && st75256->scroll_line) {
+        // Scrolling is landscape without row mirror only
+        ESP_RETURN_ON_ERROR(st75256_set_scroll_line(st75256, 0), TAG, "stop scrolling failed");
+    }
+
+    st75256->swap_axes = swap_axes;
+    st75256->mirror_x = mirror_x;
+    st75256->mirror_y = mirror_y;
+    st75256_update_plan(st75256);
+    if (st75256->shadow && swap_changed) {
+        // The shadow is kept in transmit order, which depends on the scan direction
+        memset(st75256->shadow, 0, st75256->columns * st75256->pages);
+        st75256_shadow_set_layout(st75256);
+    }
+    if (rows_moved) {
+        // The visible rows moved to other DDRAM addresses, whose content is unknown.
+        // A column mirror keeps the addresses, the shadow stays valid.
+        st75256_shadow_invalidate(st75256);
+    }
+
+    ESP_RETURN_ON_ERROR(st75256_set_data_order(st75256, st75256->plan.data_order), TAG, "set data format failed");
+    ESP_RETURN_ON_ERROR(st75256_set_scan_direction(st75256, st75256->plan.scan_dir), TAG, "set scan direction failed");
+    return st75256_flush_cmds(st75256);
 }
 
 static esp_err_t panel_st75256_del(esp_lcd_panel_t *panel);
@@ -118,14 +613,38 @@ esp_err_t esp_lcd_new_panel_st75256(const esp_lcd_panel_io_handle_t io,
     esp_err_t ret = ESP_OK;
     st75256_panel_t *st75256 = NULL;
     ESP_GOTO_ON_FALSE(io && panel_dev_config && ret_panel, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
-    ESP_GOTO_ON_FALSE(panel_dev_config->bits_per_pixel == 1, ESP_ERR_INVALID_ARG, err, TAG, "bpp must be 1");
 
     esp_lcd_panel_st75256_config_t *st75256_spec_config = (esp_lcd_panel_st75256_config_t *)panel_dev_config->vendor_config;
+    bool gray = st75256_spec_config ? st75256_spec_config->flags.gray_mode : false;
+    // Gray mode takes LVGL's 8-bit color and packs it, monochrome takes 1bpp vertical pages as is
+    ESP_GOTO_ON_FALSE(panel_dev_config->bits_per_pixel == (gray ? 8 : 1), ESP_ERR_INVALID_ARG, err, TAG,
+                      "bpp must be %d", gray ? 8 : 1);
     bool swap_axes = st75256_spec_config ? (st75256_spec_config->orientation != 0) : false;
 
+    // Module geometry, zero fields take the 256x128 defaults
+    esp_lcd_panel_st75256_geometry_t geometry = {0};
+    if (st75256_spec_config) {
+        geometry = st75256_spec_config->geometry;
+    }
+    uint16_t columns = geometry.width ? geometry.width : ST75256_DEFAULT_WIDTH;
+    uint16_t rows = geometry.height ? geometry.height : ST75256_DEFAULT_HEIGHT;
+    uint8_t ddram_pages = geometry.ddram_pages ? geometry.ddram_pages : ST75256_DEFAULT_DDRAM_PAGES;
+    ESP_GOTO_ON_FALSE(columns + geometry.column_offset <= ST75256_MAX_COLUMNS, ESP_ERR_INVALID_ARG, err, TAG,
+                      "width + column offset must not exceed %d", ST75256_MAX_COLUMNS);
+    ESP_GOTO_ON_FALSE(!(rows % 8) && rows <= ddram_pages * 8 && ddram_pages * 8 <= ST75256_MAX_DDRAM_ROWS, ESP_ERR_INVALID_ARG, err, TAG,
+                      "height must be a multiple of 8 within %d DDRAM pages (at most %d rows)", ddram_pages, ST75256_MAX_DDRAM_ROWS);
+
+    const uint8_t *init_cmds = default_init_cmds;
+    size_t init_cmds_size = sizeof(default_init_cmds);
+    if (st75256_spec_config && st75256_spec_config->init_cmds) {
+        init_cmds = st75256_spec_config->init_cmds;
+        init_cmds_size = st75256_spec_config->init_cmds_size;
+        ESP_GOTO_ON_FALSE(st75256_init_cmds_valid(init_cmds, init_cmds_size), ESP_ERR_INVALID_ARG, err, TAG, "malformed init_cmds");
+    }
+
     // Determine physical dimensions based on orientation
-    uint8_t width = swap_axes ? 128 : 256;
-    uint8_t height = swap_axes ? 256 : 128;
+    uint16_t width = swap_axes ? rows : columns;
+    uint16_t height = swap_axes ? columns : rows;
 
     ESP_COMPILER_DIAGNOSTIC_PUSH_IGNORE("-Wanalyzer-malloc-leak")
     st75256 = calloc(1, sizeof(st75256_panel_t));
@@ -140,12 +659,97 @@ esp_err_t esp_lcd_new_panel_st75256(const esp_lcd_panel_io_handle_t io,
     }
 
     st75256->io = io;
+    st75256->stream_io = esp_lcd_panel_io_is_st75256(io);
+    if (st75256->stream_io) {
+        ESP_GOTO_ON_ERROR(esp_lcd_panel_io_st75256_get_scl_speed(io, &st75256->scl_speed_hz), err, TAG, "get scl speed failed");
+    }
     st75256->bits_per_pixel = panel_dev_config->bits_per_pixel;
     st75256->reset_gpio_num = panel_dev_config->reset_gpio_num;
     st75256->reset_level = panel_dev_config->flags.reset_active_high;
     st75256->width = width;
     st75256->height = height;
+    st75256->columns = columns;
+    st75256->column_offset = geometry.column_offset;
+    st75256->gray = gray;
+    st75256->page_rows = gray ? 4 : 8;
+    st75256->pages = rows / st75256->page_rows;
+    st75256->ddram_rows = ddram_pages * 8;
+    st75256->ddram_pages = st75256->ddram_rows / st75256->page_rows;
     st75256->swap_axes = swap_axes;
+    st75256->remap_strip = st75256_spec_config ? st75256_spec_config->flags.remap_strip : false;
+    st75256->init_cmds = init_cmds;
+    st75256->init_cmds_size = init_cmds_size;
+    st75256_update_plan(st75256);
+
+    // Any task may call into the panel, the lock keeps their command sequences apart on the bus
+    st75256->lock = xSemaphoreCreateMutex();
+    ESP_GOTO_ON_FALSE(st75256->lock, ESP_ERR_NO_MEM, err, TAG, "no mem for panel lock");
+    st75256->timer_lock = xSemaphoreCreateMutex();
+    ESP_GOTO_ON_FALSE(st75256->timer_lock, ESP_ERR_NO_MEM, err, TAG, "no mem for timer lock");
+
+    if (st75256_spec_config && st75256_spec_config->flags.shadow_fb) {
+        // One allocation: shadow (columns x pages) + dirty_lo/dirty_hi (one entry per possible line)
+        size_t shadow_size = st75256->columns * st75256->pages;
+        size_t max_lines = MAX(st75256->columns, st75256->pages);
+        st75256->shadow = calloc(1, shadow_size + 2 * max_lines);
+        ESP_GOTO_ON_FALSE(st75256->shadow, ESP_ERR_NO_MEM, err, TAG, "no mem for shadow framebuffer");
+        st75256->dirty_lo = st75256->shadow + shadow_size;
+        st75256->dirty_hi = st75256->dirty_lo + max_lines;
+        st75256_shadow_set_layout(st75256);
+        st75256_shadow_invalidate(st75256);
+    }
+
+    if (st75256_spec_config && st75256_spec_config->bus_share_max_hold_us) {
+        // Bytes the bus moves in the allowed time, less what reopening the window costs
+        ESP_GOTO_ON_FALSE(st75256->stream_io, ESP_ERR_NOT_SUPPORTED, err, TAG, "bus sharing needs esp_lcd_new_panel_io_st75256()");
+        ESP_GOTO_ON_FALSE(st75256->scl_speed_hz, ESP_ERR_INVALID_ARG, err, TAG, "bus sharing needs the panel IO scl_speed_hz");
+        uint64_t bytes = (uint64_t)st75256_spec_config->bus_share_max_hold_us * st75256->scl_speed_hz / ST75256_SCL_CLOCKS_PER_BYTE / 1000000;
+        st75256->slice_bytes = bytes > ST75256_WINDOW_COST ? bytes - ST75256_WINDOW_COST : 1;
+    }
+
+    // Power save and the idle frame rate wait for the screen to go quiet, also when enabled later at run time
+    const esp_timer_create_args_t timer_args = {
+        .callback = st75256_idle_timer_cb,
+        .arg = st75256,
+        .name = "st75256_idle",
+    };
+    ESP_GOTO_ON_ERROR(esp_timer_create(&timer_args, &st75256->idle_timer), err, TAG, "create idle timer failed");
+    st75256->flush_interval_us = ST75256_CADENCE_MAX_US;
+    if (st75256_spec_config) {
+        st75256->idle_us = (int64_t)st75256_spec_config->power_save_idle_ms * 1000;
+        st75256_frame_rate_defaults(&st75256->frame_rate, &st75256_spec_config->frame_rate);
+    }
+
+    if (st75256_spec_config && st75256_spec_config->flags.async_flush) {
+        // The generic I2C IO reports done after every tx_color, only the ST75256 IO can report once per flush.
+        // The task is created last, so no error path has to tear down a running task.
+        ESP_GOTO_ON_FALSE(st75256->stream_io, ESP_ERR_NOT_SUPPORTED, err, TAG, "async flush needs esp_lcd_new_panel_io_st75256()");
+        UBaseType_t priority = st75256_spec_config->flush_task_priority ? st75256_spec_config->flush_task_priority : ST75256_FLUSH_TASK_PRIO;
+        st75256->flush_queue = xQueueCreate(ST75256_FLUSH_QUEUE_LEN, sizeof(st75256_flush_job_t));
+        ESP_GOTO_ON_FALSE(st75256->flush_queue, ESP_ERR_NO_MEM, err, TAG, "no mem for flush queue");
+        st75256->flush_events = xEventGroupCreate();
+        ESP_GOTO_ON_FALSE(st75256->flush_events, ESP_ERR_NO_MEM, err, TAG, "no mem for flush events");
+        st75256->flush_task_done = xSemaphoreCreateBinary();
+        ESP_GOTO_ON_FALSE(st75256->flush_task_done, ESP_ERR_NO_MEM, err, TAG, "no mem for flush task semaphore");
+        ESP_GOTO_ON_FALSE(xTaskCreate(st75256_flush_task, "st75256_flush", ST75256_FLUSH_TASK_STACK, st75256, priority, &st75256->flush_task) == pdPASS,
+                          ESP_ERR_NO_MEM, err, TAG, "create flush task failed");
+    }
+
+    if (st75256_spec_config && st75256_spec_config->stats_log_period_ms) {
+        // Diagnostics only: the panel works without the log task, so failing to start it is not an error
+        st75256->stats_period_ms = st75256_spec_config->stats_log_period_ms;
+        st75256->stats_task_done = xSemaphoreCreateBinary();
+        if (!st75256->stats_task_done ||
+                xTaskCreate(st75256_stats_task, "st75256_stats", ST75256_STATS_TASK_STACK, st75256, ST75256_STATS_TASK_PRIO, &st75256->stats_task) != pdPASS) {
+            ESP_LOGW(TAG, "statistics log task not started");
+            if (st75256->stats_task_done) {
+                vSemaphoreDelete(st75256->stats_task_done);
+                st75256->stats_task_done = NULL;
+            }
+            st75256->stats_task = NULL;
+        }
+    }
+
     st75256->base.del = panel_st75256_del;
     st75256->base.reset = panel_st75256_reset;
     st75256->base.init = panel_st75256_init;
@@ -165,19 +769,472 @@ err:
         if (panel_dev_config->reset_gpio_num >= 0) {
             gpio_reset_pin(panel_dev_config->reset_gpio_num);
         }
+        if (st75256->idle_timer) {
+            esp_timer_delete(st75256->idle_timer);
+        }
+        if (st75256->flush_queue) {
+            vQueueDelete(st75256->flush_queue);
+        }
+        if (st75256->flush_events) {
+            vEventGroupDelete(st75256->flush_events);
+        }
+        if (st75256->flush_task_done) {
+            vSemaphoreDelete(st75256->flush_task_done);
+        }
+        if (st75256->lock) {
+            vSemaphoreDelete(st75256->lock);
+        }
+        if (st75256->timer_lock) {
+            vSemaphoreDelete(st75256->timer_lock);
+        }
+        free(st75256->shadow);
         free(st75256);
     }
     return ret;
     ESP_COMPILER_DIAGNOSTIC_POP("-Wanalyzer-malloc-leak")
 }
 
+// Enter (display off, 0x95) or leave (0x94, display on again if it was) power save.
+// DDRAM and all registers are retained, so nothing has to be redrawn.
+static esp_err_t st75256_set_power_save(st75256_panel_t *st75256, bool enable)
+{
+    if (st75256->power_save == enable) {
+        return ESP_OK;
+    }
+    if (enable) {
+        ESP_RETURN_ON_ERROR(st75256_tx_cmd_1(st75256, ST75256_CMD_DISP_OFF, NULL, 0), TAG, "display off failed");
+        ESP_RETURN_ON_ERROR(st75256_tx_cmd_1(st75256, ST75256_CMD_POWER_SAVE_ON, NULL, 0), TAG, "power save on failed");
+        ESP_RETURN_ON_ERROR(st75256_flush_cmds(st75256), TAG, "power save on failed");
+        st75256->stats.power_saves++;
+    } else {
+        ESP_RETURN_ON_ERROR(st75256_tx_cmd_1(st75256, ST75256_CMD_POWER_SAVE_OFF, NULL, 0), TAG, "power save off failed");
+        ESP_RETURN_ON_ERROR(st75256_flush_cmds(st75256), TAG, "power save off failed");
+        vTaskDelay(pdMS_TO_TICKS(ST75256_SLEEP_OUT_DELAY_MS));
+        if (st75256->disp_on) {
+            ESP_RETURN_ON_ERROR(st75256_tx_cmd_1(st75256, ST75256_CMD_DISP_ON, NULL, 0), TAG, "display on failed");
+            ESP_RETURN_ON_ERROR(st75256_flush_cmds(st75256), TAG, "display on failed");
+        }
+    }
+    st75256->power_save = enable;
+    return ESP_OK;
+}
+
+static void st75256_frame_rate_defaults(esp_lcd_panel_st75256_frame_rate_t *out, const esp_lcd_panel_st75256_frame_rate_t *in)
+{
+    *out = *in;
+    if (out->active || out->idle) {
+        out->active_fps = out->active_fps ? out->active_fps : ST75256_FRAME_RATE_ACTIVE_FPS;
+        out->idle_ms = out->idle_ms ? out->idle_ms : ST75256_FRAME_RATE_IDLE_MS;
+    }
+}
+
+static inline bool st75256_frame_rate_enabled(st75256_panel_t *st75256)
+{
+    return st75256->frame_rate.active || st75256->frame_rate.idle;
+}
+
+static inline bool st75256_animating(st75256_panel_t *st75256)
+{
+    return (uint64_t)st75256->flush_interval_us * st75256->frame_rate.active_fps <= 1000000;
+}
+
+// Frame rate (0xF0 of command set 2), the same code for every temperature range
+static esp_err_t st75256_set_frame_rate_code(st75256_panel_t *st75256, uint8_t code)
+{
+    uint8_t frame_rate[4] = {code, code, code, code};
+    ESP_RETURN_ON_ERROR(st75256_tx_cmd_2(st75256, ST75256_CMD_SET_FRAME_RATE, frame_rate, sizeof(frame_rate)), TAG, "frame rate failed");
+    st75256->frame_rate_code = code;
+    return ESP_OK;
+}
+
+// Microseconds until the idle timer has something to do, -1 if nothing is pending
+static int64_t st75256_idle_due(st75256_panel_t *st75256, int64_t now)
+{
+    int64_t due = -1;
+    if (st75256->idle_us && !st75256->power_save) {
+        due = MAX(st75256->last_activity_us + st75256->idle_us - now, 0);
+    }
+    if (st75256_frame_rate_enabled(st75256) && st75256->frame_rate_code != st75256->frame_rate.idle) {
+        int64_t frame_rate_due = MAX(st75256->last_flush_us + st75256->frame_rate.idle_ms * 1000LL - now, 0);
+        due = due < 0 ? frame_rate_due : MIN(due, frame_rate_due);
+    }
+    return due;
+}
+
+// The timer is only armed when it is not running, so a busy screen costs one timer event per period
+static void st75256_arm_idle_timer(st75256_panel_t *st75256, int64_t now)
+{
+    if (st75256->deleting || esp_timer_is_active(st75256->idle_timer)) {
+        return;
+    }
+    int64_t due = st75256_idle_due(st75256, now);
+    if (due >= 0) {
+        esp_timer_start_once(st75256->idle_timer, MAX(due, 1));
+    }
+}
+
+// A draw or fill is about to go out: wake the panel and start the idle period again
+static esp_err_t st75256_activity(st75256_panel_t *st75256)
+{
+    ESP_RETURN_ON_ERROR(st75256_set_power_save(st75256, false), TAG, "leave power save failed");
+    st75256->last_activity_us = esp_timer_get_time();
+    st75256_arm_idle_timer(st75256, st75256->last_activity_us);
+    return ESP_OK;
+}
+
+// A draw is about to go out: measure the flush cadence and raise the frame rate once the screen animates.
+// The frame rate command leaves with the pixel data of the draw.
+static esp_err_t st75256_count_flush(st75256_panel_t *st75256)
+{
+    int64_t now = esp_timer_get_time();
+    int64_t interval = st75256->last_flush_us ? MIN(now - st75256->last_flush_us, ST75256_CADENCE_MAX_US) : ST75256_CADENCE_MAX_US;
+    st75256->flush_interval_us += (interval - (int64_t)st75256->flush_interval_us) / ST75256_CADENCE_SMOOTHING;
+    st75256->last_flush_us = now;
+    if (st75256_frame_rate_enabled(st75256) && st75256->frame_rate_code != st75256->frame_rate.active && st75256_animating(st75256)) {
+        ESP_RETURN_ON_ERROR(st75256_set_frame_rate_code(st75256, st75256->frame_rate.active), TAG, "raise frame rate failed");
+        st75256->stats.frame_rate_switches++;
+        // A power save deadline may be further out, the idle frame rate is due idle_ms from now
+        esp_timer_stop(st75256->idle_timer);
+        st75256_arm_idle_timer(st75256, now);
+    }
+    return ESP_OK;
+}
+
+// esp_timer task: hand the idle check to whoever owns the bus, ST75256_JOB_IDLE re-checks under the lock
+static void st75256_idle_timer_cb(void *arg)
+{
+    st75256_panel_t *st75256 = arg;
+    st75256_flush_job_t job = {.type = ST75256_JOB_IDLE};
+    esp_err_t ret = ESP_OK;
+    // esp_timer_delete() does not wait for a running callback, del waits on timer_lock instead
+    xSemaphoreTake(st75256->timer_lock, portMAX_DELAY);
+    if (st75256->deleting) {
+        // Fired while del was stopping the timer
+    } else if (st75256->flush_queue) {
+        // A full queue means draws are pending, they arm the timer again
+        xQueueSend(st75256->flush_queue, &job, 0);
+    } else if (xSemaphoreTake(st75256->lock, 0) != pdTRUE) {
+        // Busy right now, look again shortly
+        esp_timer_start_once(st75256->idle_timer, ST75256_IDLE_RETRY_US);
+    } else {
+        ret = st75256_run_job(st75256, &job);
+        xSemaphoreGive(st75256->lock);
+    }
+    xSemaphoreGive(st75256->timer_lock);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "idle power save or frame rate failed: %s", esp_err_to_name(ret));
+    }
+}
+
+// Queue a job for the flush task. From the flush task itself a full queue cannot drain while it waits.
+static esp_err_t st75256_queue_job(st75256_panel_t *st75256, const st75256_flush_job_t *job)
+{
+    if (xTaskGetCurrentTaskHandle() == st75256->flush_task) {
+        ESP_RETURN_ON_FALSE(xQueueSend(st75256->flush_queue, job, 0) == pdTRUE, ESP_ERR_INVALID_STATE, TAG, "flush queue full, called from the flush task");
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_FALSE(xQueueSend(st75256->flush_queue, job, portMAX_DELAY) == pdTRUE, ESP_FAIL, TAG, "queue job failed");
+    return ESP_OK;
+}
+
+// Run a panel call right away in blocking mode, or queue it behind the pending draws for the flush task
+static esp_err_t st75256_submit(st75256_panel_t *st75256, const st75256_flush_job_t *job)
+{
+    if (st75256->flush_queue) {
+        return st75256_queue_job(st75256, job);
+    }
+    st75256_lock(st75256);
+    esp_err_t ret = st75256_run_job(st75256, job);
+    st75256_unlock(st75256);
+    return ret;
+}
+
+esp_err_t esp_lcd_panel_st75256_fill_rect(esp_lcd_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end, uint8_t pattern)
+{
+    ESP_RETURN_ON_FALSE(panel && x_start < x_end && y_start < y_end, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
+    st75256_flush_job_t job = {
+        .type = ST75256_JOB_FILL,
+        .x_start = x_start,
+        .y_start = y_start,
+        .x_end = x_end,
+        .y_end = y_end,
+        .pattern = pattern,
+    };
+    return st75256_submit(st75256, &job);
+}
+
+esp_err_t esp_lcd_panel_st75256_queue_bitmap(esp_lcd_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end,
+                                             const void *color_data, esp_lcd_panel_st75256_done_cb_t on_done, void *user_ctx)
+{
+    ESP_RETURN_ON_FALSE(panel && color_data, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
+    st75256_flush_job_t job = {
+        .type = ST75256_JOB_DRAW_CB,
+        .x_start = x_start,
+        .y_start = y_start,
+        .x_end = x_end,
+        .y_end = y_end,
+        .color_data = color_data,
+        .on_done = on_done,
+        .user_ctx = user_ctx,
+    };
+    esp_err_t ret = st75256_submit(st75256, &job);
+    if (!st75256->flush_queue && on_done) {
+        on_done(panel, user_ctx);
+    }
+    return ret;
+}
+
+static esp_err_t st75256_fill(st75256_panel_t *st75256, int x_start, int y_start, int x_end, int y_end, uint8_t pattern)
+{
+    ESP_RETURN_ON_ERROR(st75256_activity(st75256), TAG, "wake failed");
+
+    // Native window, rounded out to whole pages along the row axis
+    int col_start = st75256->swap_axes ? y_start : x_start;
+    int col_end = st75256->swap_axes ? y_end : x_end;
+    int page_mask = st75256->page_rows - 1;
+    int row_start = (st75256->swap_axes ? x_start : y_start) & ~page_mask;
+    int row_end = ((st75256->swap_axes ? x_end : y_end) + page_mask) & ~page_mask;
+    ESP_RETURN_ON_FALSE(col_start >= 0 && col_start < col_end && col_end <= st75256->columns &&
+                        row_start >= 0 && row_start < row_end && row_end <= st75256->pages * st75256->page_rows,
+                        ESP_ERR_INVALID_ARG, TAG, "fill area out of range");
+
+    int page_start = row_start / st75256->page_rows;
+    int page_end = row_end / st75256->page_rows;
+    // While scrolled the rows on either side of the DDRAM wrap are separate windows
+    int wrap = st75256_scroll_wrap(st75256);
+    for (int start = row_start, end; start < row_end; start = end) {
+        end = (start < wrap && wrap < row_end) ? wrap : row_end;
+        size_t size = (size_t)(end - start) / st75256->page_rows * (col_end - col_start);
+        ESP_RETURN_ON_ERROR(st75256_set_window(st75256, col_start, col_end, start, end), TAG, "set window failed");
+        ESP_RETURN_ON_ERROR(st75256_stream_pattern(st75256, pattern, size), TAG, "fill failed");
+        st75256->stats.pixel_bytes_sent += size;
+    }
+
+    // Keep the shadow in sync with what DDRAM now holds
+    if (st75256->shadow) {
+        for (int col = col_start; col < col_end; col++) {
+            for (int page = page_start; page < page_end; page++) {
+                if (st75256->swap_axes) {
+                    st75256->shadow[col * st75256->shadow_stride + page] = pattern;
+                } else {
+                    st75256->shadow[page * st75256->shadow_stride + col] = pattern;
+                }
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_st75256_set_input_format(esp_lcd_panel_handle_t panel, esp_lcd_st75256_input_format_t format)
+{
+    ESP_RETURN_ON_FALSE(panel && format <= ESP_LCD_ST75256_INPUT_I1, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
+    ESP_RETURN_ON_FALSE(!st75256->gray, ESP_ERR_NOT_SUPPORTED, TAG, "gray mode takes 8-bit color only");
+    st75256_lock(st75256);
+    st75256->input_format = format;
+    st75256_update_plan(st75256);
+    st75256_unlock(st75256);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_st75256_set_scroll(esp_lcd_panel_handle_t panel, int start_line)
+{
+    esp_err_t ret = ESP_OK;
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
+    ESP_RETURN_ON_FALSE(start_line >= 0 && start_line < st75256->ddram_rows && !(start_line % st75256->page_rows),
+                        ESP_ERR_INVALID_ARG, TAG, "start line must be a multiple of %d below %d", st75256->page_rows, st75256->ddram_rows);
+    st75256_lock(st75256);
+    // Portrait scans columns first and Y mirror reverses the rows, the start line only moves landscape rows as expected
+    ESP_GOTO_ON_FALSE(!st75256->swap_axes && !st75256->plan.row_mirror && !(st75256->y_gap % st75256->page_rows),
+                      ESP_ERR_NOT_SUPPORTED, out, TAG, "scrolling needs landscape, no Y mirror and a page aligned Y gap");
+    if (start_line != st75256->scroll_line) {
+        ret = st75256_set_scroll_line(st75256, start_line);
+    }
+out:
+    st75256_unlock(st75256);
+    return ret;
+}
+
+esp_err_t esp_lcd_panel_st75256_get_scroll(esp_lcd_panel_handle_t panel, int *start_line)
+{
+    ESP_RETURN_ON_FALSE(panel && start_line, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
+    st75256_lock(st75256);
+    *start_line = st75256->scroll_line;
+    st75256_unlock(st75256);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_st75256_set_power_save(esp_lcd_panel_handle_t panel, bool enable)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
+    st75256_flush_job_t job = {.type = ST75256_JOB_POWER_SAVE, .enable = enable};
+    return st75256_submit(st75256, &job);
+}
+
+esp_err_t esp_lcd_panel_st75256_get_power_save(esp_lcd_panel_handle_t panel, bool *enabled)
+{
+    ESP_RETURN_ON_FALSE(panel && enabled, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
+    // A single flag, read without waiting for queued draws (polled from the LVGL task)
+    *enabled = st75256->power_save;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_st75256_get_idle_time(esp_lcd_panel_handle_t panel, uint32_t *idle_ms)
+{
+    ESP_RETURN_ON_FALSE(panel && idle_ms, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
+    // Queued draws count as activity, they are not waited for (polled from the LVGL task)
+    if (st75256->flush_queue && uxQueueMessagesWaiting(st75256->flush_queue)) {
+        *idle_ms = 0;
+        return ESP_OK;
+    }
+    // The timestamp is 64 bits: read it under the lock, at most one running batch away
+    xSemaphoreTake(st75256->lock, portMAX_DELAY);
+    int64_t idle_us = esp_timer_get_time() - st75256->last_activity_us;
+    xSemaphoreGive(st75256->lock);
+    *idle_ms = MIN(idle_us / 1000, UINT32_MAX);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_st75256_set_frame_rate(esp_lcd_panel_handle_t panel, const esp_lcd_panel_st75256_frame_rate_t *frame_rate)
+{
+    esp_err_t ret = ESP_OK;
+    ESP_RETURN_ON_FALSE(panel && frame_rate, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
+    st75256_lock(st75256);
+    st75256_frame_rate_defaults(&st75256->frame_rate, frame_rate);
+    if (st75256_frame_rate_enabled(st75256)) {
+        // Pick up where the cadence stands, the idle timer lowers it later if needed
+        int64_t now = esp_timer_get_time();
+        bool active = now - st75256->last_flush_us < st75256->frame_rate.idle_ms * 1000LL && st75256_animating(st75256);
+        ESP_GOTO_ON_ERROR(st75256_set_frame_rate_code(st75256, active ? st75256->frame_rate.active : st75256->frame_rate.idle), out, TAG, "set frame rate failed");
+        ESP_GOTO_ON_ERROR(st75256_flush_cmds(st75256), out, TAG, "set frame rate failed");
+        esp_timer_stop(st75256->idle_timer);
+        st75256_arm_idle_timer(st75256, now);
+    }
+out:
+    st75256_unlock(st75256);
+    return ret;
+}
+
+esp_err_t esp_lcd_panel_st75256_get_geometry(esp_lcd_panel_handle_t panel, esp_lcd_panel_st75256_geometry_t *geometry)
+{
+    ESP_RETURN_ON_FALSE(panel && geometry, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
+    // Fixed at creation, no lock needed
+    geometry->width = st75256->columns;
+    geometry->height = st75256->pages * st75256->page_rows;
+    geometry->ddram_pages = st75256->ddram_rows / 8;
+    geometry->column_offset = st75256->column_offset;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_st75256_invalidate_cache(esp_lcd_panel_handle_t panel)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
+    st75256_lock(st75256);
+    st75256_invalidate_cache(st75256);
+    st75256_unlock(st75256);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_st75256_get_stats(esp_lcd_panel_handle_t panel, esp_lcd_panel_st75256_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(panel && stats, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
+    st75256_lock(st75256);
+    *stats = st75256->stats;
+    // Current state rather than counters: a pause counts as it goes, not only once the next flush ends it
+    int64_t since_flush = esp_timer_get_time() - st75256->last_flush_us;
+    stats->flush_interval_us = MAX(st75256->flush_interval_us, (uint32_t)MIN(since_flush, ST75256_CADENCE_MAX_US));
+    stats->frame_rate = st75256->frame_rate_code;
+    st75256_unlock(st75256);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_st75256_reset_stats(esp_lcd_panel_handle_t panel)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
+    st75256_lock(st75256);
+    memset(&st75256->stats, 0, sizeof(st75256->stats));
+    st75256_unlock(st75256);
+    return ESP_OK;
+}
+
+static void st75256_stats_task(void *arg)
+{
+    st75256_panel_t *st75256 = arg;
+    esp_lcd_panel_st75256_stats_t last = {0};
+    esp_lcd_panel_st75256_stats_t now;
+
+    // A notification from panel_st75256_del() ends the loop
+    while (!ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(st75256->stats_period_ms))) {
+        esp_lcd_panel_st75256_get_stats(&st75256->base, &now);
+        if (now.flushes < last.flushes) {
+            // Cleared by esp_lcd_panel_st75256_reset_stats()
+            memset(&last, 0, sizeof(last));
+        }
+        uint32_t flushes = now.flushes - last.flushes;
+        uint64_t bus_us = now.bus_us - last.bus_us;
+        uint64_t remap_us = now.remap_us - last.remap_us;
+        ESP_LOGI(TAG, "%" PRIu32 " flushes (%" PRIu32 " merged, every %" PRIu32 " ms), frame rate 0x%02x (%" PRIu32 " switches), %" PRIu32 " power saves, %" PRIu64 "/%" PRIu64 "/%" PRIu64 " pixel/cmd/ctrl bytes in %" PRIu32 " transactions, "
+                 "bus %" PRIu64 " us (max %" PRIu32 ", hold %" PRIu32 "), remap %" PRIu64 " us (max %" PRIu32 "), areas %" PRIu32 "/%" PRIu32 "/%" PRIu32 "/%" PRIu32 "/%" PRIu32,
+                 flushes, now.flushes_merged - last.flushes_merged, now.flush_interval_us / 1000, now.frame_rate,
+                 now.frame_rate_switches - last.frame_rate_switches, now.power_saves - last.power_saves, now.pixel_bytes_sent - last.pixel_bytes_sent, now.cmd_bytes - last.cmd_bytes,
+                 now.overhead_bytes - last.overhead_bytes, now.transactions - last.transactions,
+                 bus_us, now.bus_max_us, now.bus_hold_max_us, remap_us, now.remap_max_us,
+                 now.area_hist[0] - last.area_hist[0], now.area_hist[1] - last.area_hist[1], now.area_hist[2] - last.area_hist[2],
+                 now.area_hist[3] - last.area_hist[3], now.area_hist[4] - last.area_hist[4]);
+        last = now;
+    }
+    xSemaphoreGive(st75256->stats_task_done);
+    vTaskDelete(NULL);
+}
+
 static esp_err_t panel_st75256_del(esp_lcd_panel_t *panel)
 {
     st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
     if (st75256->reset_gpio_num >= 0) {
         gpio_reset_pin(st75256->reset_gpio_num);
     }
+    if (st75256->stats_task) {
+        // Let the log task finish its current line, it may hold the log lock or the panel lock
+        xTaskNotifyGive(st75256->stats_task);
+        xSemaphoreTake(st75256->stats_task_done, portMAX_DELAY);
+        vSemaphoreDelete(st75256->stats_task_done);
+    }
+    // No caller or job can arm the timer while the lock is held, a running callback finishes first.
+    // It may have queued one more idle job, which finds `deleting` set and leaves the timer alone.
+    st75256_lock(st75256);
+    xSemaphoreTake(st75256->timer_lock, portMAX_DELAY);
+    st75256->deleting = true;
+    xSemaphoreGive(st75256->timer_lock);
+    esp_timer_stop(st75256->idle_timer);
+    esp_timer_delete(st75256->idle_timer);
+    vSemaphoreDelete(st75256->timer_lock);
+    st75256_unlock(st75256);
+    if (st75256->flush_task) {
+        // The flush task runs what is still queued and its callbacks, then reports back from the stop job
+        // and deletes itself: it may be anywhere in its loop, deleting it from here could cut a callback short
+        st75256_flush_job_t job = {.type = ST75256_JOB_STOP};
+        st75256_queue_job(st75256, &job);
+        xSemaphoreTake(st75256->flush_task_done, portMAX_DELAY);
+        vSemaphoreDelete(st75256->flush_task_done);
+        vEventGroupDelete(st75256->flush_events);
+        vQueueDelete(st75256->flush_queue);
+    }
+    vSemaphoreDelete(st75256->lock);
     ESP_LOGD(TAG, "del st75256 panel @%p", st75256);
+    free(st75256->shadow);
+    free(st75256->remap_buf);
     free(st75256);
     return ESP_OK;
 }
@@ -186,10 +1243,15 @@ static esp_err_t panel_st75256_reset(esp_lcd_panel_t *panel)
 {
     st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
     if (st75256->reset_gpio_num >= 0) {
+        st75256_lock(st75256);
         gpio_set_level(st75256->reset_gpio_num, st75256->reset_level);
         vTaskDelay(pdMS_TO_TICKS(10));
         gpio_set_level(st75256->reset_gpio_num, !st75256->reset_level);
         vTaskDelay(pdMS_TO_TICKS(120)); // ST75256 requires >100ms after reset
+        st75256->scroll_line = 0;
+        st75256_invalidate_cache(st75256);
+        st75256_shadow_invalidate(st75256);
+        st75256_unlock(st75256);
     }
     return ESP_OK;
 }
@@ -197,84 +1259,109 @@ static esp_err_t panel_st75256_reset(esp_lcd_panel_t *panel)
 static esp_err_t panel_st75256_init(esp_lcd_panel_t *panel)
 {
     st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
-    esp_lcd_panel_io_handle_t io = st75256->io;
-
-    // Step 1: Enter Command Set 1 and turn display OFF
-    ESP_RETURN_ON_ERROR(st75256_set_cmd_set_1(io), TAG, "enter cmd set 1 failed");
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, ST75256_CMD_DISP_OFF, NULL, 0), TAG, "display off failed");
-
-    // Step 2: Exit power save mode
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, ST75256_CMD_POWER_SAVE_OFF, NULL, 0), TAG, "power save off failed");
-
-    // Step 3: Set data format (MSB first)
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, ST75256_CMD_SET_DATA_MSB, NULL, 0), TAG, "set data format failed");
+    st75256_lock(st75256);
+    esp_err_t ret = st75256_init_sequence(st75256);
+    st75256_unlock(st75256);
+    return ret;
+}
 
-    // Step 4: Enter Command Set 2 for advanced config
-    ESP_RETURN_ON_ERROR(st75256_set_cmd_set_2(io), TAG, "enter cmd set 2 failed");
+// Every record complete, and short enough for the command list of the stream IO
+static bool st75256_init_cmds_valid(const uint8_t *cmds, size_t size)
+{
+    for (size_t i = 0; i < size;) {
+        if (size - i < 2) {
+            return false;
+        }
+        size_t n = cmds[i + 1] & ~ESP_LCD_ST75256_INIT_DELAY;
+        size_t len = 2 + n + ((cmds[i + 1] & ESP_LCD_ST75256_INIT_DELAY) ? 1 : 0);
+        if (n + 2 > ESP_LCD_PANEL_IO_ST75256_MAX_CMD_BYTES || len > size - i) {
+            return false;
+        }
+        i += len;
+    }
+    return true;
+}
 
-    // Step 5: Disable auto-read
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, ST75256_CMD_DISABLE_AUTO_READ, NULL, 0), TAG, "disable auto-read cmd failed");
-    uint8_t disable_auto_read_val = 0x9F;
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_color(io, -1, &disable_auto_read_val, 1), TAG, "disable auto-read param failed");
+// Send an init table. The commands join the pending command list like any other,
+// so with the stream IO they leave together with the next data unless a delay needs them out first.
+static esp_err_t st75256_run_init_cmds(st75256_panel_t *st75256, const uint8_t *cmds, size_t size)
+{
+    uint8_t cmd_set = ST75256_CMD_SET_1;
+    for (size_t i = 0; i < size;) {
+        uint8_t cmd = cmds[i];
+        uint8_t n = cmds[i + 1] & ~ESP_LCD_ST75256_INIT_DELAY;
+        bool delay = cmds[i + 1] & ESP_LCD_ST75256_INIT_DELAY;
+        if (cmd == ST75256_CMD_SET_1 || cmd == ST75256_CMD_SET_2) {
+            // Sent with the next command, and only if it differs from the active set
+            cmd_set = cmd;
+        } else {
+            ESP_RETURN_ON_ERROR(st75256_select_cmd_set(st75256, cmd_set), TAG, "select cmd set failed");
+            ESP_RETURN_ON_ERROR(st75256_tx_cmd(st75256, cmd, cmds + i + 2, n), TAG, "send 0x%02X failed", cmd);
+        }
+        i += 2 + n;
+        if (delay) {
+            ESP_RETURN_ON_ERROR(st75256_flush_cmds(st75256), TAG, "send 0x%02X failed", cmd);
+            vTaskDelay(pdMS_TO_TICKS(cmds[i]));
+            i++;
+        }
+    }
+    return ESP_OK;
+}
 
-    // Step 6: Analog circuit setting
-    uint8_t analog_cfg[3] = {0x00, 0x01, 0x00};
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, ST75256_CMD_ANALOG_CIRCUIT_SET, NULL, 0), TAG, "analog circuit cmd failed");
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_color(io, -1, analog_cfg, 3), TAG, "analog circuit param failed");
+static esp_err_t st75256_init_sequence(st75256_panel_t *st75256)
+{
+    // Nothing is known about the controller before init
+    st75256_invalidate_cache(st75256);
 
-    // Step 7: Gray scale table
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, ST75256_CMD_SET_GRAYSCALE_TABLE, NULL, 0), TAG, "gray scale cmd failed");
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_color(io, -1, grayscale_table, 16), TAG, "gray scale data failed");
+    // Step 1: Enter Command Set 1 and turn display OFF
+    ESP_RETURN_ON_ERROR(st75256_tx_cmd_1(st75256, ST75256_CMD_DISP_OFF, NULL, 0), TAG, "display off failed");
 
-    // Step 8: Back to Command Set 1 for contrast and power
-    ESP_RETURN_ON_ERROR(st75256_set_cmd_set_1(io), TAG, "back to cmd set 1 failed");
+    // Step 2: Exit power save mode
+    ESP_RETURN_ON_ERROR(st75256_tx_cmd_1(st75256, ST75256_CMD_POWER_SAVE_OFF, NULL, 0), TAG, "power save off failed");
+    st75256->disp_on = false;
+    st75256->power_save = false;
 
-    // Step 9: Contrast setting (0x81 + 2 bytes)
-    uint8_t contrast_val[2] = {0x1E, 0x05};
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, ST75256_CMD_SET_CONTRAST, NULL, 0), TAG, "contrast cmd failed");
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_color(io, -1, contrast_val, 2), TAG, "contrast param failed");
+    // Step 3: Gray scale table (gray mode only), before the glass table so that it can override the levels
+    if (st75256->gray) {
+        ESP_RETURN_ON_ERROR(st75256_tx_cmd_2(st75256, ST75256_CMD_SET_GRAYSCALE_TABLE, grayscale_table, 16), TAG, "gray scale table failed");
+    }
 
-    // Step 10: Power control (simplified)
-    uint8_t power_val = 0x0B;
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, ST75256_CMD_SET_POWER_CONTROL, NULL, 0), TAG, "power ctrl cmd failed");
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_color(io, -1, &power_val, 1), TAG, "power ctrl param failed");
+    // Step 4: Glass settings: auto-read, analog circuit, contrast, power and display control
+    ESP_RETURN_ON_ERROR(st75256_run_init_cmds(st75256, st75256->init_cmds, st75256->init_cmds_size), TAG, "init commands failed");
 
-    // Step 11: Display control (0xCA + 3 bytes)
-    uint8_t display_ctrl[3] = {0x00, 0x7F, 0x20}; // 典型值：设置CL驱动频率=0, 占空比=128, 帧周期=0x20
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, ST75256_CMD_DISPLAY_CONTROL, NULL, 0), TAG, "display control cmd failed");
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_color(io, -1, display_ctrl, 3), TAG, "display control param failed");
+    // Step 5: Frame rate, starting at the idle one (only when configured, the reset default stays otherwise)
+    if (st75256_frame_rate_enabled(st75256)) {
+        ESP_RETURN_ON_ERROR(st75256_set_frame_rate_code(st75256, st75256->frame_rate.idle), TAG, "frame rate failed");
+    }
 
-    // Step 12: Display mode (monochrome)
-    uint8_t display_mode = 0x10; // 0x10 = monochrome（单色）, 0x11 = grayscale（四级灰度）
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, ST75256_CMD_SET_DISPLAY_MODE, NULL, 0), TAG, "display mode cmd failed");
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_color(io, -1, &display_mode, 1), TAG, "display mode param failed");
+    // Step 6: Data format (bit0 is the top row of a page, as in LVGL's page format, MSB on top for the row mirror)
+    // and the scan direction of the current orientation
+    ESP_RETURN_ON_ERROR(st75256_set_data_order(st75256, st75256->plan.data_order), TAG, "set data format failed");
+    ESP_RETURN_ON_ERROR(st75256_set_scan_direction(st75256, st75256->plan.scan_dir), TAG, "set scan direction failed");
 
-    // Step 13: Normal display mode
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, ST75256_CMD_INVERT_OFF, NULL, 0), TAG, "normal display failed");
+    // Step 7: Display mode
+    uint8_t display_mode = st75256->gray ? ST75256_DISPLAY_MODE_GRAY : ST75256_DISPLAY_MODE_MONO; // 0x10 = monochrome（单色）, 0x11 = grayscale（四级灰度）
+    ESP_RETURN_ON_ERROR(st75256_tx_cmd_1(st75256, ST75256_CMD_SET_DISPLAY_MODE, &display_mode, 1), TAG, "display mode failed");
 
-    // Step 14: Clear display RAM
-    {
-        // Switch to Command Set 1
-        ESP_RETURN_ON_ERROR(st75256_set_cmd_set_1(io), TAG, "enter cmd set 1 failed");
-        // 设置列地址范围: 0 ~ 255
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, ST75256_CMD_SET_COLUMN_RANGE, NULL, 0), TAG, "set column range cmd failed");
-        uint8_t col_range[2] = {0, 255};
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_color(io, -1, col_range, 2), TAG, "set column range param failed");
+    // Step 8: Normal display mode
+    ESP_RETURN_ON_ERROR(st75256_tx_cmd_1(st75256, ST75256_CMD_INVERT_OFF, NULL, 0), TAG, "normal display failed");
 
-        // 设置页地址范围: 0 ~ 14 
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, ST75256_CMD_SET_PAGE_RANGE, NULL, 0), TAG, "set page range cmd failed");
-        uint8_t page_range[2] = {0, 40};
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_color(io, -1, page_range, 2), TAG, "set page range param failed");
+    // Step 9: Display start line 0, a software-only re-init keeps the last set_scroll() otherwise
+    if (st75256->scroll_line) {
+        uint8_t start_line = 0;
+        ESP_RETURN_ON_ERROR(st75256_tx_cmd_1(st75256, ST75256_CMD_SET_SCROLL_START, &start_line, 1), TAG, "scroll start failed");
+        st75256->scroll_line = 0;
+    }
 
-        // 开始写显存
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, ST75256_CMD_WRITE_RAM, NULL, 0), TAG, "write ram cmd failed");
+    // Step 10: Clear the whole display RAM (all pages, so that Y mirroring starts blank too)
+    ESP_RETURN_ON_ERROR(st75256_set_ddram_window(st75256, 0, ST75256_MAX_COLUMNS - 1, 0, st75256->ddram_pages - 1), TAG, "set clear window failed");
+    ESP_RETURN_ON_ERROR(st75256_stream_pattern(st75256, 0x00, ST75256_MAX_COLUMNS * st75256->ddram_pages), TAG, "clear ddram failed");
+    st75256->stats.pixel_bytes_sent += ST75256_MAX_COLUMNS * st75256->ddram_pages;
 
-        // 发送 4096 字节的 0x00
-        static const uint8_t zero_byte = 0x00;
-        const size_t total_bytes = 256 * 16; // width * num_pages
-        for (size_t i = 0; i < total_bytes; i++) {
-            ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_color(io, -1, &zero_byte, 1), TAG, "clear ddram failed");
-        }
+    // DDRAM is known to be blank now, the shadow can start diffing right away
+    if (st75256->shadow) {
+        memset(st75256->shadow, 0, st75256->columns * st75256->pages);
+        st75256_shadow_mark_clean(st75256);
     }
 
     // Display remains OFF until disp_on_off(true) is called
@@ -284,218 +1371,717 @@ static esp_err_t panel_st75256_init(esp_lcd_panel_t *panel)
 static esp_err_t panel_st75256_draw_bitmap(esp_lcd_panel_t *panel, int x_start, int y_start, int x_end, int y_end, const void *color_data)
 {
     st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
-    esp_lcd_panel_io_handle_t io = st75256->io;
-    void *color_data_local = NULL;
 
     // >>> 调试：打印原始坐标 <<<
-    ESP_LOGD(TAG, "Draw bitmap: input rect = (%d, %d) -> (%d, %d)", x_start, y_start, x_end, y_end);
-
-    // Apply gap offset (for panels with non-zero start address)
-    x_start += st75256->x_gap;
-    x_end += st75256->x_gap;
-    y_start += st75256->y_gap;
-    y_end += st75256->y_gap;
-
-    // >>> 调试：打印 gap 后坐标 <<<
-    ESP_LOGD(TAG, "After gap: (%d, %d) -> (%d, %d), swap_axes=%s",
+    ESP_LOGD(TAG, "Draw bitmap: input rect = (%d, %d) -> (%d, %d), swap_axes=%s",
              x_start, y_start, x_end, y_end,
              st75256->swap_axes ? "true" : "false");
 
-    // Handle coordinate swap if enabled
-    if (st75256->swap_axes) {    
-        if (st75256->y_mirror) {
-            // If Y is mirrored, adjust X coordinates accordingly
-            st75256_apply_mirror(&x_start, &x_end);
-            // After applying Y mirror, the coordinates are still in swapped orientation, so we will swap them later together with X/Y
+    if (st75256->flush_queue) {
+        // 异步模式：只排队，由 flush 任务发送；发送完成后通过 on_color_trans_done 通知 LVGL
+        st75256_flush_job_t job = {
+            .type = ST75256_JOB_DRAW,
+            .x_start = x_start,
+            .y_start = y_start,
+            .x_end = x_end,
+            .y_end = y_end,
+            .color_data = color_data,
+        };
+        return st75256_queue_job(st75256, &job);
+    }
+
+    st75256_lock(st75256);
+    uint64_t sent_before = st75256->stats.pixel_bytes_sent;
+    esp_err_t ret = st75256_draw(st75256, x_start, y_start, x_end, y_end, color_data);
+    st75256_flush_done(st75256, sent_before, ret);
+    st75256_unlock(st75256);
+    return ret;
+}
+
+// Run one queued panel call (draws are also run in batches, see st75256_run_draws())
+static esp_err_t st75256_run_job(st75256_panel_t *st75256, const st75256_flush_job_t *job)
+{
+    esp_err_t ret = ESP_OK;
+    switch (job->type) {
+    case ST75256_JOB_DRAW:
+    case ST75256_JOB_DRAW_CB:
+        return st75256_draw(st75256, job->x_start, job->y_start, job->x_end, job->y_end, job->color_data);
+    case ST75256_JOB_FILL:
+        return st75256_fill(st75256, job->x_start, job->y_start, job->x_end, job->y_end, job->pattern);
+    case ST75256_JOB_INVERT:
+        ESP_RETURN_ON_ERROR(st75256_tx_cmd_1(st75256, job->enable ? ST75256_CMD_INVERT_ON : ST75256_CMD_INVERT_OFF, NULL, 0), TAG, "invert failed");
+        return st75256_flush_cmds(st75256);
+    case ST75256_JOB_DISP_ON_OFF:
+        st75256->disp_on = job->enable;
+        if (st75256->power_save) {
+            // Turning the display on wakes the panel, turning it off only takes effect then
+            return job->enable ? st75256_activity(st75256) : ESP_OK;
+        }
+        ESP_RETURN_ON_ERROR(st75256_tx_cmd_1(st75256, job->enable ? ST75256_CMD_DISP_ON : ST75256_CMD_DISP_OFF, NULL, 0), TAG, "disp on/off failed");
+        ESP_RETURN_ON_ERROR(st75256_flush_cmds(st75256), TAG, "disp on/off failed");
+        // Optional delay if needed by panel
+        if (job->enable) {
+            vTaskDelay(pdMS_TO_TICKS(10));
         }
-        
-        //设置竖向扫描（128x256 模式）后，坐标系变为 Y 轴向下，X 轴向左，但物理内存布局仍是按行（水平）扫描的，因此需要交换 X/Y 坐标并重新排列像素数据
-        int tmp = x_start;
-        x_start = y_start;
-        y_start = tmp;
-        tmp = x_end;
-        x_end = y_end;
-        y_end = tmp;
+        return ESP_OK;
+    case ST75256_JOB_MIRROR:
+        return st75256_set_orientation(st75256, st75256->swap_axes, job->enable, job->mirror_y);
+    case ST75256_JOB_SWAP_XY:
+        return st75256_set_orientation(st75256, job->enable, st75256->mirror_x, st75256->mirror_y);
+    case ST75256_JOB_POWER_SAVE:
+        return job->enable ? st75256_set_power_save(st75256, true) : st75256_activity(st75256);
+    case ST75256_JOB_IDLE: {
+        // Draws since the timer was armed moved the deadlines, whatever is not due yet arms it again
+        int64_t now = esp_timer_get_time();
+        if (st75256_frame_rate_enabled(st75256) && st75256->frame_rate_code != st75256->frame_rate.idle &&
+                now - st75256->last_flush_us >= st75256->frame_rate.idle_ms * 1000LL) {
+            ESP_RETURN_ON_ERROR(st75256_set_frame_rate_code(st75256, st75256->frame_rate.idle), TAG, "lower frame rate failed");
+            ESP_RETURN_ON_ERROR(st75256_flush_cmds(st75256), TAG, "lower frame rate failed");
+            st75256->stats.frame_rate_switches++;
+        }
+        if (st75256->idle_us && now - st75256->last_activity_us >= st75256->idle_us) {
+            ESP_RETURN_ON_ERROR(st75256_set_power_save(st75256, true), TAG, "enter power save failed");
+        }
+        st75256_arm_idle_timer(st75256, now);
+        return ESP_OK;
+    }
+    case ST75256_JOB_STOP:
+        // Handled by the flush task once the batch is done
+        return ESP_OK;
+    }
+    return ret;
+}
+
+static inline bool st75256_job_is_draw(const st75256_flush_job_t *job)
+{
+    return job->type == ST75256_JOB_DRAW || job->type == ST75256_JOB_DRAW_CB;
+}
+
+/**
+ * 合并排队的绘制：同一批中连续的绘制之间没有其他操作，方向与格式都不变。
+ *  - 有影子显存：依次写入影子，最后只提交一次，重叠区域只发送最终内容，相邻区域合并为最省的窗口
+ *  - 无影子显存：被后面某次绘制完全覆盖的区域直接跳过（页方向的取整同样被覆盖）
+ */
+static void st75256_run_draws(st75256_panel_t *st75256, const st75256_flush_job_t *jobs, int count)
+{
+    st75256->shadow_batch = st75256->shadow && count > 1;
+    for (int i = 0; i < count; i++) {
+        const st75256_flush_job_t *job = &jobs[i];
+        bool covered = false;
+        for (int j = i + 1; j < count && !st75256->shadow && !covered; j++) {
+            covered = jobs[j].x_start <= job->x_start && jobs[j].y_start <= job->y_start &&
+                      jobs[j].x_end >= job->x_end && jobs[j].y_end >= job->y_end;
+        }
+        if (covered) {
+            st75256->stats.flushes++;
+            st75256->stats.flushes_merged++;
+            continue;
+        }
+        esp_err_t ret = st75256_run_job(st75256, job);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "flush (%d, %d) -> (%d, %d) failed: %s", job->x_start, job->y_start, job->x_end, job->y_end, esp_err_to_name(ret));
+        }
+    }
+    if (st75256->shadow_batch) {
+        st75256->shadow_batch = false;
+        uint64_t bus_before = st75256->stats.bus_us;
+        esp_err_t ret = st75256_shadow_commit(st75256, st75256->batch_submitted);
+        st75256->stats.bus_max_us = MAX(st75256->stats.bus_max_us, (uint32_t)(st75256->stats.bus_us - bus_before));
+        st75256->stats.flushes_merged += count - 1;
+        st75256->batch_submitted = 0;
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "flush of %d merged areas failed: %s", count, esp_err_to_name(ret));
+        }
+    }
+}
 
-        // >>> 调试：打印交换后坐标 <<<
-        ESP_LOGD(TAG, "After swap_xy: (%d, %d) -> (%d, %d)", x_start, y_start, x_end, y_end);
+static void st75256_flush_task(void *arg)
+{
+    st75256_panel_t *st75256 = arg;
+    st75256_flush_job_t jobs[ST75256_FLUSH_QUEUE_LEN];
+
+    bool stop = false;
+    while (!stop) {
+        // Wait for work, then take everything queued so far. The lock is held until all of it ran,
+        // so st75256_lock() callers find every job either run or still in the queue.
+        xQueuePeek(st75256->flush_queue, &jobs[0], portMAX_DELAY);
+        xSemaphoreTake(st75256->lock, portMAX_DELAY);
+        int count = 0;
+        while (count < ST75256_FLUSH_QUEUE_LEN && xQueueReceive(st75256->flush_queue, &jobs[count], 0) == pdTRUE) {
+            count++;
+        }
+        for (int i = 0; i < count;) {
+            if (!st75256_job_is_draw(&jobs[i])) {
+                esp_err_t ret = st75256_run_job(st75256, &jobs[i]);
+                if (ret != ESP_OK) {
+                    ESP_LOGE(TAG, "queued panel call %d failed: %s", jobs[i].type, esp_err_to_name(ret));
+                }
+                i++;
+                continue;
+            }
+            int run = 1;
+            while (i + run < count && st75256_job_is_draw(&jobs[i + run])) {
+                run++;
+            }
+            st75256_run_draws(st75256, &jobs[i], run);
+            i += run;
+        }
+        st75256->jobs_run += count;
+        xEventGroupSetBits(st75256->flush_events, ST75256_EVENT_JOBS_RUN);
+        xSemaphoreGive(st75256->lock);
+
+        // Producers wait for this even if the transfer failed
+        for (int i = 0; i < count; i++) {
+            if (jobs[i].type == ST75256_JOB_DRAW) {
+                esp_lcd_panel_io_st75256_signal_done(st75256->io);
+            } else if (jobs[i].type == ST75256_JOB_DRAW_CB && jobs[i].on_done) {
+                jobs[i].on_done(&st75256->base, jobs[i].user_ctx);
+            }
+            stop |= jobs[i].type == ST75256_JOB_STOP;
+        }
+    }
+    // del frees the panel as soon as this is given, nothing of it may be touched after
+    xSemaphoreGive(st75256->flush_task_done);
+    vTaskDelete(NULL);
+}
 
-        static uint8_t s_remap_buffer[16 * 256];     // 交换坐标后需要重新排列像素数据，暂存缓冲区（最大支持全屏交换）,注：分辨率改动后需要修改大小
-        memset(s_remap_buffer, 0, sizeof(s_remap_buffer));  // 清空缓冲区
-        st75256_remap_swapped_frame((uint8_t *)color_data, s_remap_buffer);
-        color_data_local = (void*)s_remap_buffer;
+// Report the end of a blocking flush through on_color_trans_done. The stream IO reports it once, here.
+// The generic IO reports it after each tx_color, command parameters included, so several times per draw.
+static void st75256_flush_done(st75256_panel_t *st75256, uint64_t sent_before, esp_err_t draw_ret)
+{
+    if (st75256->stream_io) {
+        esp_lcd_panel_io_st75256_signal_done(st75256->io);
+        return;
     }
-    else {
-        if (st75256->y_mirror) {
-            // If Y is mirrored, adjust Y coordinates accordingly
-            st75256_apply_mirror(&y_start, &y_end); //
+    // When the shadow found nothing to send, rewrite one unchanged byte so that LVGL does not wait forever
+    // on this flush. Not after a failed draw: it returns the error, and the bus may be the problem.
+    if (draw_ret == ESP_OK && st75256->shadow && st75256->stats.pixel_bytes_sent == sent_before) {
+        if (st75256_set_window(st75256, 0, 1, 0, st75256->page_rows) == ESP_OK) {
+            st75256_tx_data(st75256, st75256->shadow, 1);
         }
-        color_data_local = (void*)color_data;
     }
+}
 
-    // ST75256 organizes memory in pages (8 rows per page)
-    uint8_t page_start = y_start / 8;
-    uint8_t page_end = (y_end - 1) / 8;
-    uint8_t num_pages = page_end - page_start + 1;
+// Bytes of draw_bitmap input covering `rows` landscape rows of an area `width` pixels wide
+static size_t st75256_input_rows_size(st75256_panel_t *st75256, int width, int rows)
+{
+    if (st75256->gray) {
+        return (size_t)rows * width;
+    }
+    if (st75256->input_format == ESP_LCD_ST75256_INPUT_I1) {
+        return (size_t)rows * ((width + 7) / 8);
+    }
+    return (size_t)(rows / 8) * width;
+}
 
-    // Width in pixels (columns)
-    int width = x_end - x_start;
+/**
+ * 单色模式：color_data 为 LVGL（esp_lvgl_port 单色模式）的竖向页格式：每字节 8 个竖向像素（bit0 在上），
+ * 每页 (x_end - x_start) 字节，共 (y_end - y_start) / 8 页。横屏时直接发送；竖屏时只转置当前区域。
+ * 若 input_format 为 ESP_LCD_ST75256_INPUT_NATIVE（见 esp_lcd_st75256_lvgl.c），竖屏数据已是发送顺序，同样直接发送。
+ * 若为 ESP_LCD_ST75256_INPUT_I1（LVGL v9），横屏按 8x8 块转置，竖屏只需逐字节取反并翻转位序。
+ * 灰度模式：color_data 为 LVGL 8 位色（RGB332），每像素 1 字节、按行排列，打包成每字节 4 个像素后发送。
+ * 需要转换的数据先写入 remap 缓冲区，结果紧密排列后作为一个窗口发送（remap_strip 模式下逐条带发送）。
+ * 走哪条路径由 st75256_update_plan() 预先决定，见 plan.draw / plan.convert。
+ */
+static esp_err_t st75256_draw_area(st75256_panel_t *st75256, int x_start, int y_start, int x_end, int y_end, const uint8_t *data)
+{
+    const int rows = st75256->pages * st75256->page_rows;
+    // LVGL 坐标：竖屏时 X 对应硬件行（页方向），Y 对应硬件列
+    const int x_limit = st75256->swap_axes ? rows : st75256->columns;
+    const int y_limit = st75256->swap_axes ? st75256->columns : rows;
+    ESP_RETURN_ON_FALSE(x_start >= 0 && x_start < x_end && x_end <= x_limit &&
+                        y_start >= 0 && y_start < y_end && y_end <= y_limit,
+                        ESP_ERR_INVALID_ARG, TAG, "draw area out of range");
+
+    // 滚动后 DDRAM 在 wrap 行处回绕，一个窗口不能跨过它：拆成两次绘制（影子显存发送时自行拆分）
+    int wrap = st75256_scroll_wrap(st75256);
+    if (!st75256->shadow && y_start < wrap && wrap < y_end) {
+        ESP_RETURN_ON_ERROR(st75256_draw_area(st75256, x_start, y_start, x_end, wrap, data), TAG, "draw above wrap failed");
+        return st75256_draw_area(st75256, x_start, wrap, x_end, y_end, data + st75256_input_rows_size(st75256, x_end - x_start, wrap - y_start));
+    }
 
-    // >>> 调试：打印页和宽度 <<<
-    ESP_LOGD(TAG, "Page range: %u -> %u (num=%u), width=%d", page_start, page_end, num_pages, width);
+    // 转换以页为单位：页方向（横屏 Y，竖屏 X）按页对齐，竖屏 LVGL 页格式按 8x8 块转置，Y 也需对齐 8
+    ESP_RETURN_ON_FALSE(!((x_start | x_end) & st75256->plan.x_mask) && !((y_start | y_end) & st75256->plan.y_mask),
+                        ESP_ERR_INVALID_ARG, TAG, "area must be aligned to %d x %d pixels", st75256->plan.x_mask + 1, st75256->plan.y_mask + 1);
+    return st75256->plan.draw(st75256, x_start, y_start, x_end, y_end, data);
+}
 
-    // Switch to Command Set 1
-    ESP_RETURN_ON_ERROR(st75256_set_cmd_set_1(io), TAG, "enter cmd set 1 failed");
+// Draw one flush and account it: area bucket, bus time and the rest of the time spent in the driver
+static esp_err_t st75256_draw(st75256_panel_t *st75256, int x_start, int y_start, int x_end, int y_end, const uint8_t *data)
+{
+    ESP_RETURN_ON_ERROR(st75256_activity(st75256), TAG, "wake failed");
+    ESP_RETURN_ON_ERROR(st75256_count_flush(st75256), TAG, "frame rate failed");
+    int64_t start = esp_timer_get_time();
+    uint64_t bus_before = st75256->stats.bus_us;
+    esp_err_t ret = st75256_draw_area(st75256, x_start, y_start, x_end, y_end, data);
+    uint32_t bus_us = st75256->stats.bus_us - bus_before;
+    int64_t elapsed = esp_timer_get_time() - start;
+    uint32_t remap_us = elapsed > bus_us ? elapsed - bus_us : 0;
+
+    st75256->stats.flushes++;
+    st75256->stats.remap_us += remap_us;
+    st75256->stats.remap_max_us = MAX(st75256->stats.remap_max_us, remap_us);
+    st75256->stats.bus_max_us = MAX(st75256->stats.bus_max_us, bus_us);
+    if (ret == ESP_OK) {
+        uint32_t screen = st75256->width * st75256->height;
+        uint32_t area = (uint32_t)(x_end - x_start) * (y_end - y_start);
+        int bucket = ESP_LCD_ST75256_STATS_AREA_BUCKETS - 1;
+        if (area < screen) {
+            // 1/64, 1/16, 1/4 of the screen, then the remaining partial areas
+            bucket = 0;
+            while (bucket < ESP_LCD_ST75256_STATS_AREA_BUCKETS - 2 && area * (64u >> (2 * bucket)) > screen) {
+                bucket++;
+            }
+        }
+        st75256->stats.area_hist[bucket]++;
+    }
+    return ret;
+}
 
-    // Set column address range [x_start, x_end)
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, ST75256_CMD_SET_COLUMN_RANGE, NULL, 0), TAG, "set column range cmd failed");
-    uint8_t col_param[2] = {(uint8_t)x_start, (uint8_t)(x_end - 1)};
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_color(io, -1, col_param, 2), TAG, "set column range param failed");
+// Plan draw for input already in transmit order: landscape windows are (x, y), portrait windows (y, x)
+static esp_err_t st75256_draw_landscape(st75256_panel_t *st75256, int x_start, int y_start, int x_end, int y_end, const uint8_t *data)
+{
+    return st75256_draw_native(st75256, x_start, x_end, y_start, y_end, data);
+}
 
-    // Set page address range [page_start, page_end]
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, ST75256_CMD_SET_PAGE_RANGE, NULL, 0), TAG, "set page range cmd failed");
-    uint8_t page_param[2] = {page_start, page_end};
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_color(io, -1, page_param, 2), TAG, "set page range param failed");
+static esp_err_t st75256_draw_portrait(st75256_panel_t *st75256, int x_start, int y_start, int x_end, int y_end, const uint8_t *data)
+{
+    return st75256_draw_native(st75256, y_start, y_end, x_start, x_end, data);
+}
 
-    // Start writing RAM
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, ST75256_CMD_WRITE_RAM, NULL, 0), TAG, "write ram cmd failed");
+// Write data that is already in DDRAM transmit order to a native window (columns x rows)
+static esp_err_t st75256_draw_native(st75256_panel_t *st75256, int col_start, int col_end, int row_start, int row_end, const uint8_t *data)
+{
+    // Calculate correct data size: pages × width (each page has 'width' bytes), rows are page aligned
+    size_t data_size = (row_end - row_start) / st75256->page_rows * (col_end - col_start);
 
-    // Calculate correct data size: pages × width (each page has 'width' bytes)
-    size_t data_size = num_pages * width;
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_color(io, -1, color_data_local, data_size), TAG, "send pixel data failed");
+    if (st75256->shadow) {
+        st75256_shadow_put(st75256, col_start, col_end, row_start, row_end, data);
+        return st75256_shadow_commit(st75256, data_size);
+    }
 
+    ESP_RETURN_ON_ERROR(st75256_set_window(st75256, col_start, col_end, row_start, row_end), TAG, "set window failed");
+    ESP_RETURN_ON_ERROR(st75256_tx_data(st75256, data, data_size), TAG, "send pixel data failed");
+    st75256->stats.pixel_bytes_sent += data_size;
     return ESP_OK;
 }
 
-static esp_err_t panel_st75256_invert_color(esp_lcd_panel_t *panel, bool invert_color_data)
+// The remap buffer belongs to the panel and is only allocated once a flush needs converting
+static esp_err_t st75256_get_remap_buf(st75256_panel_t *st75256, uint8_t **buf)
 {
-    st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
-    esp_lcd_panel_io_handle_t io = st75256->io;
-    uint8_t cmd = invert_color_data ? ST75256_CMD_INVERT_ON : ST75256_CMD_INVERT_OFF;
-    ESP_RETURN_ON_ERROR(st75256_set_cmd_set_1(io), TAG, "enter cmd set 1 failed");
-    return esp_lcd_panel_io_tx_param(io, cmd, NULL, 0);
+    if (!st75256->remap_buf) {
+        // Full mode: the whole visible DDRAM; strip mode: the largest band st75256_draw_converted() uses,
+        // 8 portrait columns or (gray / I1 input) one landscape page
+        size_t size = st75256->columns * st75256->pages;
+        if (st75256->remap_strip) {
+            size = MAX(st75256->columns, st75256->pages * 8);
+        }
+        st75256->remap_buf = malloc(size);
+        ESP_RETURN_ON_FALSE(st75256->remap_buf, ESP_ERR_NO_MEM, TAG, "no mem for remap buffer");
+        ESP_LOGD(TAG, "remap buffer: %u bytes (%s)", (unsigned)size, st75256->remap_strip ? "strip" : "full");
+    }
+    *buf = st75256->remap_buf;
+    return ESP_OK;
 }
 
-static esp_err_t panel_st75256_mirror(esp_lcd_panel_t *panel, bool mirror_x, bool mirror_y)
+// Convert `num_rows` source rows starting at LVGL row `y` into DDRAM transmit order, returns the byte count
+static size_t st75256_convert(st75256_panel_t *st75256, const uint8_t *src, int width, int y, int num_rows, uint8_t *dst)
 {
-    st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
-    esp_lcd_panel_io_handle_t io = st75256->io;
-    uint8_t dir = 0x00;
+    st75256_kernel_fn_t kernel = width == st75256->plan.full_width ? st75256->plan.convert_full : st75256->plan.convert;
+    kernel(src + st75256_input_rows_size(st75256, width, y), width, num_rows, dst);
+    // Portrait areas are page aligned in X, landscape ones in Y: the output is always whole bytes
+    return (size_t)width * num_rows / st75256->page_rows;
+}
 
-    // Base direction from swap_axes
-    if (st75256->swap_axes) {
-        dir = 0x04; // 128x256 base
-    } else {
-        dir = 0x00; // 256x128 base
+// Areas that need converting first (monochrome portrait, I1 input, any gray area): convert into the remap buffer
+// and send it as one window. LVGL area (x, y) maps to native (columns = y, rows = x) in portrait.
+static esp_err_t st75256_draw_converted(st75256_panel_t *st75256, int x_start, int y_start, int x_end, int y_end, const uint8_t *src)
+{
+    const int width = x_end - x_start;
+    const int height = y_end - y_start;
+    const bool swap = st75256->swap_axes;
+    uint8_t *buf = NULL;
+    ESP_RETURN_ON_ERROR(st75256_get_remap_buf(st75256, &buf), TAG, "get remap buffer failed");
+
+    // 条带模式：每次只转换一条（竖屏 8 行 LVGL 像素 = 8 个硬件列，横屏一页），依次写入同一个窗口
+    int band = height;
+    if (st75256->remap_strip) {
+        band = swap ? 8 : st75256->page_rows;
     }
 
-    // Apply mirroring bits (bit1: X, bit0: Y)
-    if (mirror_x) dir |= 0x02;
-    if (mirror_y) 
-    {
-        dir |= 0x01;
-        st75256->y_mirror = true;
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, ST75256_CMD_SET_DATA_MSB, NULL, 0), TAG, "set data format failed");
+    size_t data_size = 0;
+    if (!st75256->shadow) {
+        if (swap) {
+            ESP_RETURN_ON_ERROR(st75256_set_window(st75256, y_start, y_end, x_start, x_end), TAG, "set window failed");
+        } else {
+            ESP_RETURN_ON_ERROR(st75256_set_window(st75256, x_start, x_end, y_start, y_end), TAG, "set window failed");
+        }
     }
-    else
-    {
-        st75256->y_mirror = false;
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, ST75256_CMD_SET_DATA_LSB, NULL, 0), TAG, "set data format failed");
+    for (int y = 0; y < height; y += band) {
+        int num_rows = MIN(band, height - y);
+        size_t size = st75256_convert(st75256, src, width, y, num_rows, buf);
+        if (!st75256->shadow) {
+            ESP_RETURN_ON_ERROR(st75256_tx_data(st75256, buf, size), TAG, "send pixel data failed");
+        } else if (swap) {
+            st75256_shadow_put(st75256, y_start + y, y_start + y + num_rows, x_start, x_end, buf);
+        } else {
+            st75256_shadow_put(st75256, x_start, x_end, y_start + y, y_start + y + num_rows, buf);
+        }
+        data_size += size;
     }
-
-    return st75256_set_scan_direction(st75256, dir);
+    if (st75256->shadow) {
+        return st75256_shadow_commit(st75256, data_size);
+    }
+    st75256->stats.pixel_bytes_sent += data_size;
+    return ESP_OK;
 }
 
-static esp_err_t panel_st75256_swap_xy(esp_lcd_panel_t *panel, bool swap_axes)
+// Open a RAM write window in raw DDRAM addresses (inclusive ranges)
+// Program a window (skipped if unchanged) and start writing RAM at its origin
+static esp_err_t st75256_open_ddram_window(st75256_panel_t *st75256, const uint8_t window[4])
 {
-    st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
-    st75256->swap_axes = swap_axes;
-    // Update scan direction to match new orientation
-    uint8_t dir = swap_axes ? 0x04 : 0x00;
-    return st75256_set_scan_direction(st75256, dir);
+    // Every RAM write fills its window completely, which wraps the address counter back to
+    // the window origin, so an unchanged window only needs a new 0x5C.
+    if (!st75256->cache.window_valid || memcmp(st75256->cache.window, window, sizeof(st75256->cache.window)) != 0) {
+        // Set column address range [col_start, col_end]
+        ESP_RETURN_ON_ERROR(st75256_tx_cmd_1(st75256, ST75256_CMD_SET_COLUMN_RANGE, &window[0], 2), TAG, "set column range failed");
+        // Set page address range [page_start, page_end]
+        ESP_RETURN_ON_ERROR(st75256_tx_cmd_1(st75256, ST75256_CMD_SET_PAGE_RANGE, &window[2], 2), TAG, "set page range failed");
+        memcpy(st75256->cache.window, window, sizeof(st75256->cache.window));
+        st75256->cache.window_valid = true;
+    }
+
+    // Start writing RAM
+    return st75256_tx_cmd_1(st75256, ST75256_CMD_WRITE_RAM, NULL, 0);
 }
 
-static esp_err_t panel_st75256_set_gap(esp_lcd_panel_t *panel, int x_gap, int y_gap)
+static esp_err_t st75256_set_ddram_window(st75256_panel_t *st75256, uint8_t col_start, uint8_t col_end, uint8_t page_start, uint8_t page_end)
 {
-    st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
-    st75256->x_gap = x_gap;
-    st75256->y_gap = y_gap;
+    // >>> 调试：打印页和列范围 <<<
+    ESP_LOGD(TAG, "Window: col %u -> %u, page %u -> %u", col_start, col_end, page_start, page_end);
+
+    uint8_t window[4] = {col_start, col_end, page_start, page_end};
+    ESP_RETURN_ON_ERROR(st75256_open_ddram_window(st75256, window), TAG, "open window failed");
+    // The address counter runs along a page first (landscape) or along a column first (0xBC bit2)
+    bool page_first = st75256->plan.scan_dir & 0x04;
+    int columns = col_end - col_start + 1;
+    int pages = page_end - page_start + 1;
+    memcpy(st75256->ram.window, window, sizeof(window));
+    st75256->ram.line_bytes = page_first ? pages : columns;
+    st75256->ram.size = columns * pages;
+    st75256->ram.pos = 0;
     return ESP_OK;
 }
 
-static esp_err_t panel_st75256_disp_on_off(esp_lcd_panel_t *panel, bool on_off)
+// Bus sharing: reopen the current window from the line the last slice ended on
+static esp_err_t st75256_resume_ddram_window(st75256_panel_t *st75256)
 {
-    st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
-    esp_lcd_panel_io_handle_t io = st75256->io;
-    uint8_t cmd = on_off ? ST75256_CMD_DISP_ON : ST75256_CMD_DISP_OFF;
-    ESP_RETURN_ON_ERROR(st75256_set_cmd_set_1(io), TAG, "enter cmd set 1 failed");
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, cmd, NULL, 0), TAG, "disp on/off failed");
-    // Optional delay if needed by panel
-    if (on_off) {
-        vTaskDelay(pdMS_TO_TICKS(10));
+    uint8_t window[4];
+    memcpy(window, st75256->ram.window, sizeof(window));
+    int line = st75256->ram.pos / st75256->ram.line_bytes;
+    if (st75256->plan.scan_dir & 0x04) {
+        window[0] += line;
+    } else {
+        window[2] += line;
     }
-    return ESP_OK;
+    return st75256_open_ddram_window(st75256, window);
 }
 
-/**
- * 镜像坐标变换（通用）
- * 
- * 变换公式：new_start = total_height - old_end, new_end = total_height - old_start
- * 
- * @param start [in/out] 起始坐标
- * @param end   [in/out] 结束坐标
- */
-static inline void st75256_apply_mirror(int *start, int *end)
+// Open a RAM write window. Coordinates are native (DDRAM columns / rows, end exclusive),
+// gap and Y mirror are applied here so that callers never deal with them.
+static esp_err_t st75256_set_window(st75256_panel_t *st75256, int col_start, int col_end, int row_start, int row_end)
+{
+    // Apply gap offset (for panels with non-zero start address) and where the glass sits in the column addresses
+    int col_gap = (st75256->swap_axes ? st75256->y_gap : st75256->x_gap) + st75256->plan.col_offset;
+    int row_gap = st75256->swap_axes ? st75256->x_gap : st75256->y_gap;
+    col_start += col_gap;
+    col_end += col_gap;
+    row_start += row_gap;
+    row_end += row_gap;
+
+    if (st75256->scroll_line) {
+        // Callers split windows at st75256_scroll_wrap(), so a window wraps as a whole or not at all
+        row_start += st75256->scroll_line;
+        row_end += st75256->scroll_line;
+        if (row_start >= st75256->ddram_rows) {
+            row_start -= st75256->ddram_rows;
+            row_end -= st75256->ddram_rows;
+        }
+    }
+
+    // Rows reversed: the reversed page addresses put the visible rows at the end of DDRAM
+    row_start += st75256->plan.row_offset;
+    row_end += st75256->plan.row_offset;
+
+    // ST75256 organizes memory in pages (8 rows per page, 4 in gray mode)
+    return st75256_set_ddram_window(st75256, col_start, col_end - 1, row_start / st75256->page_rows, (row_end - 1) / st75256->page_rows);
+}
+
+// Stream `size` bytes of a constant pattern into the open RAM window, one chunk per transaction
+static esp_err_t st75256_stream_pattern(st75256_panel_t *st75256, uint8_t pattern, size_t size)
 {
-    const int total_height = (ST75256_TOTAL_PAGES + 1) * 8;
-    int tmp_start = total_height - *end;
-    int tmp_end   = total_height - *start;
-    *start = tmp_start;
-    *end   = tmp_end;
+    size_t chunk = MIN(size, ST75256_TX_CHUNK_SIZE);
+    memset(st75256->tx_buf, pattern, chunk);
+    while (size) {
+        size_t n = MIN(size, chunk);
+        ESP_RETURN_ON_ERROR(st75256_tx_data(st75256, st75256->tx_buf, n), TAG, "send pattern failed");
+        size -= n;
+    }
+    return ESP_OK;
 }
 
 /**
- * 将 LVGL 的 swap_xy 显存格式转换为 ST75256 硬件页格式
+ * 影子显存（shadow framebuffer）
  *
- * @param src  LVGL 显存指针，4096 字节 (32 页 × 128 字节)
- * @param dst  ST75256 显存指针，4096 字节 (16 页 × 256 字节)
- * 
- * @note 边界检查：dst_byte 范围 0~4095
- *       最大值：LVGL_Y=255, LVGL_X=127 → dst_byte = 255*16 + 15 = 4095 
+ * 驱动保存一份与 DDRAM 可见区域一致的副本，按"发送顺序"组织：
+ *  - 横屏：line = 页 (page)，minor = 列 (column)
+ *  - 竖屏：line = 列 (column)，minor = 页 (page)（0xBC 竖向扫描时先递增页地址）
+ * 每次刷新先与副本逐行比较，只记录每行真正变化的 [lo, hi] 区间，
+ * 再把相邻的脏行按总线开销合并成尽量少的窗口发送。
  */
-static void st75256_remap_swapped_frame(uint8_t *src, uint8_t *dst)
+static void st75256_shadow_set_layout(st75256_panel_t *st75256)
+{
+    if (st75256->swap_axes) {
+        st75256->shadow_lines = st75256->columns;
+        st75256->shadow_stride = st75256->pages;
+    } else {
+        st75256->shadow_lines = st75256->pages;
+        st75256->shadow_stride = st75256->columns;
+    }
+}
+
+// Mark the whole shadow as dirty: DDRAM content is unknown, the next flush resends everything
+static void st75256_shadow_invalidate(st75256_panel_t *st75256)
+{
+    if (st75256->shadow) {
+        memset(st75256->dirty_lo, 0, st75256->shadow_lines);
+        memset(st75256->dirty_hi, st75256->shadow_stride - 1, st75256->shadow_lines);
+    }
+}
+
+static void st75256_shadow_mark_clean(st75256_panel_t *st75256)
+{
+    memset(st75256->dirty_lo, 0xFF, st75256->shadow_lines);
+    memset(st75256->dirty_hi, 0x00, st75256->shadow_lines);
+}
+
+// The panel content moved up by `lines` shadow lines (down if negative): move the shadow and its
+// dirty spans along. The lines scrolled in show DDRAM rows the shadow does not cover, they start
+// blank and dirty.
+static void st75256_shadow_scroll(st75256_panel_t *st75256, int lines)
 {
-    if (!src || !dst) {
-        ESP_LOGE(TAG, "Invalid pointer: src=%p, dst=%p", src, dst);
+    if (!st75256->shadow || !lines) {
         return;
     }
+    const size_t stride = st75256->shadow_stride;
+    int exposed = MIN(abs(lines), st75256->shadow_lines);
+    int keep = st75256->shadow_lines - exposed;
+    int from = lines > 0 ? exposed : 0;
+    int to = lines > 0 ? 0 : exposed;
+    memmove(st75256->shadow + to * stride, st75256->shadow + from * stride, keep * stride);
+    memmove(st75256->dirty_lo + to, st75256->dirty_lo + from, keep);
+    memmove(st75256->dirty_hi + to, st75256->dirty_hi + from, keep);
+
+    int first = lines > 0 ? keep : 0;
+    memset(st75256->shadow + first * stride, 0, exposed * stride);
+    memset(st75256->dirty_lo + first, 0, exposed);
+    memset(st75256->dirty_hi + first, stride - 1, exposed);
+}
+
+// Copy new native data into the shadow, widening each line's dirty span only where bytes differ
+static void st75256_shadow_merge(st75256_panel_t *st75256, int line_start, int num_lines,
+                                 int minor_start, int num_minor, const uint8_t *data)
+{
+    for (int i = 0; i < num_lines; i++) {
+        int line = line_start + i;
+        const uint8_t *src = data + i * num_minor;
+        uint8_t *dst = st75256->shadow + line * st75256->shadow_stride + minor_start;
+        if (memcmp(dst, src, num_minor) == 0) {
+            continue;
+        }
+
+        int lo = 0;
+        int hi = num_minor - 1;
+        while (src[lo] == dst[lo]) {
+            lo++;
+        }
+        while (src[hi] == dst[hi]) {
+            hi--;
+        }
+        memcpy(dst + lo, src + lo, hi - lo + 1);
+
+        if (st75256->dirty_lo[line] > st75256->dirty_hi[line]) {
+            st75256->dirty_lo[line] = minor_start + lo;
+            st75256->dirty_hi[line] = minor_start + hi;
+        } else {
+            st75256->dirty_lo[line] = MIN(st75256->dirty_lo[line], minor_start + lo);
+            st75256->dirty_hi[line] = MAX(st75256->dirty_hi[line], minor_start + hi);
+        }
+    }
+}
 
-    for(int page = 0; page < 32; page++)
-    {
-        for(int x = 0; x < 128; x++)
-        {
-            uint8_t src_byte = src[x + page * 128];
-            if (src_byte == 0) continue;
+// Send lines [line_start, line_end] x minor [lo, hi] of the shadow as one window
+static esp_err_t st75256_shadow_send(st75256_panel_t *st75256, int line_start, int line_end, int lo, int hi, size_t *sent)
+{
+    const size_t stride = st75256->shadow_stride;
+    const size_t span = hi - lo + 1;
 
-            for(int bit = 0; bit < 8; bit++)
-            {
-                if(src_byte & (1 << bit))
-                {
-                    // 计算像素位置
-                    int LVGL_Y = page * 8 + bit;  
-                    int LVGL_X = x;
+    if (st75256->swap_axes) {
+        ESP_RETURN_ON_ERROR(st75256_set_window(st75256, line_start, line_end + 1, lo * st75256->page_rows, (hi + 1) * st75256->page_rows), TAG, "set window failed");
+    } else {
+        ESP_RETURN_ON_ERROR(st75256_set_window(st75256, lo, hi + 1, line_start * st75256->page_rows, (line_end + 1) * st75256->page_rows), TAG, "set window failed");
+    }
 
-                    // 计算目标位置
-                    int dst_byte = LVGL_Y * 16 + LVGL_X / 8;
-                    int dst_bit = LVGL_X % 8;
+    if (span == stride) {
+        // Whole lines are contiguous in the shadow, send them in one go
+        size_t size = (line_end - line_start + 1) * stride;
+        ESP_RETURN_ON_ERROR(st75256_tx_data(st75256, st75256->shadow + line_start * stride, size), TAG, "send pixel data failed");
+        *sent += size;
+        return ESP_OK;
+    }
 
-                    // 边界检查
-                    if (dst_byte < 0 || dst_byte >= 16 * 256) continue;
+    // Strided window: pack the spans into the bounce buffer, the RAM write continues across transfers
+    size_t fill = 0;
+    for (int line = line_start; line <= line_end; line++) {
+        const uint8_t *src = st75256->shadow + line * stride + lo;
+        size_t left = span;
+        while (left) {
+            size_t n = MIN(left, ST75256_TX_CHUNK_SIZE - fill);
+            memcpy(st75256->tx_buf + fill, src, n);
+            fill += n;
+            src += n;
+            left -= n;
+            if (fill == ST75256_TX_CHUNK_SIZE) {
+                ESP_RETURN_ON_ERROR(st75256_tx_data(st75256, st75256->tx_buf, fill), TAG, "send pixel data failed");
+                *sent += fill;
+                fill = 0;
+            }
+        }
+    }
+    if (fill) {
+        ESP_RETURN_ON_ERROR(st75256_tx_data(st75256, st75256->tx_buf, fill), TAG, "send pixel data failed");
+        *sent += fill;
+    }
+    return ESP_OK;
+}
 
-                    dst[dst_byte] |= (1 << dst_bit);
-                }
+// Walk the dirty spans and send them as the cheapest set of windows (greedy merge of neighbouring lines)
+static esp_err_t st75256_shadow_flush(st75256_panel_t *st75256, size_t *sent)
+{
+    int group_start = -1;
+    int group_end = 0;
+    int lo = 0;
+    int hi = 0;
+    // Scrolled landscape panel: the line shown from DDRAM page 0 has to start a new window
+    int wrap = st75256_scroll_wrap(st75256);
+    int wrap_line = (wrap == INT_MAX || st75256->swap_axes) ? -1 : wrap / st75256->page_rows;
+
+    for (int line = 0; line < st75256->shadow_lines; line++) {
+        int line_lo = st75256->dirty_lo[line];
+        int line_hi = st75256->dirty_hi[line];
+        if (line_lo > line_hi) {
+            continue;
+        }
+        if (group_start >= 0) {
+            int merged_lo = MIN(lo, line_lo);
+            int merged_hi = MAX(hi, line_hi);
+            size_t merged_cost = ST75256_WINDOW_COST + (line - group_start + 1) * (merged_hi - merged_lo + 1);
+            size_t split_cost = 2 * ST75256_WINDOW_COST + (group_end - group_start + 1) * (hi - lo + 1) + (line_hi - line_lo + 1);
+            if (merged_cost <= split_cost && line != wrap_line) {
+                group_end = line;
+                lo = merged_lo;
+                hi = merged_hi;
+                continue;
             }
+            ESP_RETURN_ON_ERROR(st75256_shadow_send(st75256, group_start, group_end, lo, hi, sent), TAG, "send window failed");
         }
+        group_start = group_end = line;
+        lo = line_lo;
+        hi = line_hi;
+    }
+    if (group_start >= 0) {
+        ESP_RETURN_ON_ERROR(st75256_shadow_send(st75256, group_start, group_end, lo, hi, sent), TAG, "send window failed");
+    }
+
+    st75256_shadow_mark_clean(st75256);
+    return ESP_OK;
+}
+
+// Merge data for a native window into the shadow, nothing is sent yet
+static void st75256_shadow_put(st75256_panel_t *st75256, int col_start, int col_end, int row_start, int row_end, const uint8_t *data)
+{
+    int page_start = row_start / st75256->page_rows;
+    int num_pages = (row_end - row_start) / st75256->page_rows;
+    int num_cols = col_end - col_start;
+
+    if (st75256->swap_axes) {
+        st75256_shadow_merge(st75256, col_start, num_cols, page_start, num_pages, data);
+    } else {
+        st75256_shadow_merge(st75256, page_start, num_pages, col_start, num_cols, data);
+    }
+}
+
+// Send everything merged since the last commit, `submitted` is the byte count the caller handed in
+static esp_err_t st75256_shadow_commit(st75256_panel_t *st75256, size_t submitted)
+{
+    if (st75256->shadow_batch) {
+        // The flush task commits once the whole batch is in the shadow
+        st75256->batch_submitted += submitted;
+        return ESP_OK;
+    }
+    size_t sent = 0;
+    esp_err_t ret = st75256_shadow_flush(st75256, &sent);
+    if (ret != ESP_OK) {
+        // Part of the dirty area may not have reached DDRAM, resend everything next time
+        st75256_shadow_invalidate(st75256);
+        return ret;
+    }
+
+    st75256->stats.pixel_bytes_sent += sent;
+    if (submitted > sent) {
+        st75256->stats.pixel_bytes_saved += submitted - sent;
+    }
+    return ESP_OK;
+}
+
+// Queued behind pending draws with async flush, so frames drawn before the call keep their settings
+static esp_err_t panel_st75256_invert_color(esp_lcd_panel_t *panel, bool invert_color_data)
+{
+    st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
+    st75256_flush_job_t job = {.type = ST75256_JOB_INVERT, .enable = invert_color_data};
+    return st75256_submit(st75256, &job);
+}
+
+static esp_err_t panel_st75256_mirror(esp_lcd_panel_t *panel, bool mirror_x, bool mirror_y)
+{
+    st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
+    st75256_flush_job_t job = {.type = ST75256_JOB_MIRROR, .enable = mirror_x, .mirror_y = mirror_y};
+    return st75256_submit(st75256, &job);
+}
+
+static esp_err_t panel_st75256_swap_xy(esp_lcd_panel_t *panel, bool swap_axes)
+{
+    st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
+    st75256_flush_job_t job = {.type = ST75256_JOB_SWAP_XY, .enable = swap_axes};
+    return st75256_submit(st75256, &job);
+}
+
+static esp_err_t panel_st75256_set_gap(esp_lcd_panel_t *panel, int x_gap, int y_gap)
+{
+    st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
+    st75256_lock(st75256);
+    if (x_gap != st75256->x_gap || y_gap != st75256->y_gap) {
+        st75256_shadow_invalidate(st75256);
     }
+    st75256->x_gap = x_gap;
+    st75256->y_gap = y_gap;
+    st75256_unlock(st75256);
+    return ESP_OK;
 }
 
+static esp_err_t panel_st75256_disp_on_off(esp_lcd_panel_t *panel, bool on_off)
+{
+    st75256_panel_t *st75256 = __containerof(panel, st75256_panel_t, base);
+    st75256_flush_job_t job = {.type = ST75256_JOB_DISP_ON_OFF, .enable = on_off};
+    return st75256_submit(st75256, &job);
+}
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "esp_err.h"
 #include "esp_lcd_panel_dev.h"
 
@@ -14,6 +15,61 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Glass geometry of an ST75256 module, in landscape (unrotated) terms
+ *
+ * Zero fields take the defaults of the 256x128 module the driver was written
+ * for. Other glasses on the same controller (e.g. 256x160, or 256x208 with a
+ * 26-page DDRAM) only need their numbers here.
+ */
+typedef struct {
+    uint16_t width;          /*!< Visible columns, 0 = 256 */
+    uint16_t height;         /*!< Visible rows, a multiple of 8, 0 = 128 */
+    uint8_t ddram_pages;     /*!< DDRAM pages of 8 rows the rows are scanned over (mirroring, scrolling), 0 = 21 (168 rows) */
+    uint8_t column_offset;   /*!< First DDRAM column wired to the glass */
+} esp_lcd_panel_st75256_geometry_t;
+
+/**
+ * @brief Flag of an esp_lcd_panel_st75256_config_t.init_cmds record: wait after the command
+ *
+ * The table is a sequence of records `cmd, n, params[n]`, starting in command
+ * set 1. Records for 0x30 and 0x31 (no parameters) select command set 1 or 2
+ * for the records after them. OR this flag into `n` to wait after the command:
+ * one more byte after the parameters gives the delay in milliseconds.
+ *
+ * Example usage:
+ * @code {c}
+ * static const uint8_t my_glass_init[] = {
+ *     0x31, 0,                                   // Command set 2
+ *     0xD7, 1, 0x9F,                             // Disable auto read
+ *     0x32, 3, 0x00, 0x01, 0x03,                 // Analog circuit
+ *     0x30, 0,                                   // Command set 1
+ *     0x81, 2, 0x20, 0x04,                       // Contrast
+ *     0x20, 1 | ESP_LCD_ST75256_INIT_DELAY, 0x0B, 20, // Power control, then wait 20 ms
+ *     0xCA, 3, 0x00, 0x9F, 0x20,                 // Display control (1/160 duty)
+ * };
+ * @endcode
+ */
+#define ESP_LCD_ST75256_INIT_DELAY 0x80
+
+/**
+ * @brief Controller frame rate, raised while the screen animates and lowered when it is static
+ *
+ * The codes go to all four temperature ranges of the frame rate command (0xF0 of
+ * command set 2), see the frame rate table of the ST75256 datasheet. A higher
+ * frame rate shortens the ghosting of moving content, a lower one saves power on
+ * a static screen. The driver measures the flush cadence: once it reaches
+ * `active_fps` the next flush switches to `active`, `idle_ms` after the last
+ * flush the idle timer switches back to `idle`. With `active` equal to `idle`
+ * the rate is fixed.
+ */
+typedef struct {
+    uint8_t active;          /*!< Frame rate code while the screen animates */
+    uint8_t idle;            /*!< Frame rate code on a static screen, and after init */
+    uint8_t active_fps;      /*!< Flushes per second that count as animating, 0 = 10 */
+    uint16_t idle_ms;        /*!< Time without flushes before going back to `idle`, 0 = 500 */
+} esp_lcd_panel_st75256_frame_rate_t;
+
 /**
  * @brief ST75256 configuration structure
  *
@@ -30,8 +86,170 @@ typedef struct {
      * Default is 0 (256x128).
      */
     uint8_t orientation;
+    esp_lcd_panel_st75256_geometry_t geometry; /*!< Module size, all zero for 256x128 */
+
+    struct {
+        /**
+         * @brief Keep a driver-owned copy of the visible DDRAM (4 KB for 256x128)
+         *
+         * Every flush is compared against the copy and only the column/page
+         * windows that really changed are sent over the bus.
+         */
+        unsigned int shadow_fb: 1;
+        /**
+         * @brief Portrait mode only: transpose and send 8 rows at a time
+         *
+         * The remap buffer then holds a single band (128 bytes) instead of a full
+         * frame (4 KB). In both modes it is allocated on the first portrait flush.
+         */
+        unsigned int remap_strip: 1;
+        /**
+         * @brief Return from draw_bitmap at once and transmit from a driver task
+         *
+         * on_color_trans_done fires once the whole area is out, so LVGL renders
+         * into its other buffer while the bus is busy. Requires the panel IO
+         * from esp_lcd_new_panel_io_st75256().
+         *
+         * invert_color, disp_on_off, mirror, swap_xy and fill_rect are queued
+         * behind the pending draws as well and return before they run. Called
+         * from the flush task (on_color_trans_done, queue_bitmap's on_done) they
+         * return ESP_ERR_INVALID_STATE instead of waiting on a full queue. Draws
+         * queued back to back are merged: with shadow_fb into one commit, else
+         * areas that a later draw covers completely are skipped.
+         */
+        unsigned int async_flush: 1;
+        /**
+         * @brief 4-level gray mode (display mode 0x11)
+         *
+         * draw_bitmap then takes LVGL's 8-bit color (RGB332, one byte per pixel,
+         * row-major) and `bits_per_pixel` must be 8. The area must be aligned to
+         * 4 pixels along the page axis (Y in landscape, X in portrait). DDRAM
+         * and the optional shadow take twice the space of monochrome mode.
+         */
+        unsigned int gray_mode: 1;
+    } flags;
+    uint8_t flush_task_priority; /*!< async_flush only: flush task priority, 0 = default (5) */
+    uint16_t stats_log_period_ms; /*!< Log a statistics summary from a background task at this period, 0 = disabled */
+    /**
+     * @brief Longest time one I2C transaction may hold the bus, in microseconds, 0 = no limit
+     *
+     * For buses shared with other devices (sensors, ...): pixel data is split at
+     * page boundaries (columns in portrait) into transactions that fit, the task
+     * yields between them and the RAM window is reopened for the rest. A single
+     * line (one page or column plus the window commands) is never split, so the
+     * limit is raised to that if it is shorter. Needs the panel IO from
+     * esp_lcd_new_panel_io_st75256(), its scl_speed_hz sets the bytes per slice.
+     */
+    uint16_t bus_share_max_hold_us;
+    /**
+     * @brief Enter power save after this many milliseconds without draws or fills, 0 = never
+     *
+     * The display is turned off and the controller's analog circuits stop, DDRAM is
+     * retained. The next draw or fill wakes the panel before it is sent (about 10 ms),
+     * the picture comes back without a redraw. A busy screen costs one timer event
+     * per period. See also esp_lcd_panel_st75256_set_power_save().
+     */
+    uint32_t power_save_idle_ms;
+    esp_lcd_panel_st75256_frame_rate_t frame_rate; /*!< Adaptive frame rate, all zero = keep the controller's reset default */
+    /**
+     * @brief Glass specific init commands, NULL = the JLX256128G settings
+     *
+     * Analog circuit, contrast, power control and display control of the module,
+     * see ESP_LCD_ST75256_INIT_DELAY for the format. init() sends display off and
+     * power save off before the table, and the data format, scan direction,
+     * display mode, frame rate and the DDRAM clear after it, so these need not
+     * (and cannot) be set here. The table is referenced, not copied, and must
+     * stay valid while the panel exists.
+     */
+    const uint8_t *init_cmds;
+    size_t init_cmds_size;   /*!< Bytes in init_cmds */
 } esp_lcd_panel_st75256_config_t;
 
+/**
+ * @brief Pixel data layout expected by draw_bitmap in monochrome mode
+ */
+typedef enum {
+    /**
+     * LVGL orientation, vertical pages: each byte holds 8 vertical pixels (bit0 on top),
+     * one page of (x_end - x_start) bytes per 8 rows. This is what esp_lvgl_port's
+     * monochrome mode produces. y_start and y_end must be multiples of 8, portrait
+     * panels transpose it in 8x8 blocks before sending and need x_start and x_end
+     * aligned to 8 as well.
+     */
+    ESP_LCD_ST75256_INPUT_LVGL_PAGES = 0,
+    /**
+     * DDRAM transmit order of the current orientation, sent without conversion.
+     * Landscape: same as ESP_LCD_ST75256_INPUT_LVGL_PAGES. Portrait: one row of
+     * (x_end - x_start) / 8 bytes per LVGL row, bit0 holds the leftmost pixel of
+     * each byte; x_start and x_end must be multiples of 8.
+     * See esp_lcd_st75256_lvgl_attach() to render LVGL frames in this order.
+     */
+    ESP_LCD_ST75256_INPUT_NATIVE,
+    /**
+     * LVGL v9 LV_COLOR_FORMAT_I1 without the palette: row-major, (x_end - x_start + 7) / 8
+     * bytes per row (LV_DRAW_BUF_STRIDE_ALIGN 1), bit7 holds the leftmost pixel and a set
+     * bit is a light (unlit) pixel. The area must be aligned to 8 pixels along the page
+     * axis (Y in landscape, X in portrait). Portrait needs no transpose.
+     */
+    ESP_LCD_ST75256_INPUT_I1,
+} esp_lcd_st75256_input_format_t;
+
+/**
+ * @brief Number of flush area buckets in esp_lcd_panel_st75256_stats_t
+ *
+ * Bucket i counts flushes of at most 1/4^(3-i) of the screen for i < 3
+ * (1/64, 1/16, 1/4), bucket 3 the larger partial areas and bucket 4 full screens.
+ */
+#define ESP_LCD_ST75256_STATS_AREA_BUCKETS 5
+
+/**
+ * @brief ST75256 bus statistics
+ *
+ * The bytes on the wire are pixel_bytes_sent + cmd_bytes + overhead_bytes.
+ * At 9 SCL clocks per byte (8 bits + ACK) this gives the bus time for a given
+ * clock, independent of the board the numbers were recorded on.
+ *
+ * The times split each flush into bus time (waiting for I2C transfers) and
+ * remap time (everything else the driver does: conversion, transposition and
+ * the shadow comparison). Time LVGL spends rendering is not included, so a
+ * frame rate well below what flushes take points at rendering.
+ */
+typedef struct {
+    uint64_t pixel_bytes_sent;    /*!< Pixel bytes written to DDRAM */
+    uint64_t pixel_bytes_saved;   /*!< Pixel bytes skipped because the shadow framebuffer already matched */
+    uint32_t flushes;             /*!< draw_bitmap calls processed */
+    uint32_t flushes_merged;      /*!< Queued draws sent together with a later one or skipped as covered by it */
+    uint32_t transactions;        /*!< I2C transactions (START ... STOP) */
+    uint64_t cmd_bytes;           /*!< Command and parameter bytes */
+    uint64_t overhead_bytes;      /*!< Address and control bytes */
+    uint64_t remap_us;            /*!< Time spent in flushes outside bus transfers */
+    uint32_t remap_max_us;        /*!< Longest remap time of a single flush */
+    uint64_t bus_us;              /*!< Time spent in bus transfers, including init and fill_rect */
+    uint32_t bus_max_us;          /*!< Longest bus time of a single flush */
+    uint32_t bus_hold_max_us;     /*!< Longest single I2C transaction: the worst case other devices on the bus wait for the panel.
+                                       With the ST75256 panel IO it is the wire time from the bytes and SCL, time spent waiting
+                                       for other devices to release the bus is not counted */
+    uint32_t power_saves;         /*!< Times the panel entered power save */
+    uint32_t frame_rate_switches; /*!< Frame rate changes made by the adaptive policy */
+    uint32_t flush_interval_us;   /*!< Current flush cadence: smoothed time between flushes, at most 1 s (not cleared by reset) */
+    uint8_t frame_rate;           /*!< Frame rate code in use, see esp_lcd_panel_st75256_frame_rate_t, 0 if left at the reset default (not cleared by reset) */
+    uint32_t area_hist[ESP_LCD_ST75256_STATS_AREA_BUCKETS]; /*!< Flushes by area, see ESP_LCD_ST75256_STATS_AREA_BUCKETS */
+} esp_lcd_panel_st75256_stats_t;
+
+/**
+ * @brief Callback of esp_lcd_panel_st75256_queue_bitmap(), the pixel data may be reused from here on
+ *
+ * @note With async_flush it runs in the flush task, like on_color_trans_done. Panel
+ *       calls made from there are queued without waiting and fail with
+ *       ESP_ERR_INVALID_STATE when the queue is full; calls that take the panel
+ *       (set_gap, get_stats, ...) do not wait for the jobs still queued. Blocking
+ *       work belongs in another task.
+ *
+ * @param[in] panel LCD panel handle
+ * @param[in] user_ctx User context passed to esp_lcd_panel_st75256_queue_bitmap()
+ */
+typedef void (*esp_lcd_panel_st75256_done_cb_t)(esp_lcd_panel_handle_t panel, void *user_ctx);
+
 /**
  * @brief Create LCD panel for model ST75256
  *
@@ -39,11 +257,11 @@ typedef struct {
  * @param[in] panel_dev_config General panel device configuration
  * @param[out] ret_panel Returned LCD panel handle
  * @return
- *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_ERR_INVALID_ARG   if parameter, geometry or init_cmds is invalid
  *          - ESP_ERR_NO_MEM        if out of memory
  *          - ESP_OK                on success
  *
- * @note The default panel size is 256x128 (landscape).
+ * @note The default panel size is 256x128 (landscape), other modules set esp_lcd_panel_st75256_config_t.geometry.
  * @note Use esp_lcd_panel_st75256_config_t to set orientation to 128x256.
  *
  * Example usage:
@@ -64,6 +282,224 @@ esp_err_t esp_lcd_new_panel_st75256(const esp_lcd_panel_io_handle_t io,
                                     const esp_lcd_panel_dev_config_t *panel_dev_config,
                                     esp_lcd_panel_handle_t *ret_panel);
 
+/**
+ * @brief Fill a rectangle of an ST75256 panel with a constant byte pattern
+ *
+ * The pattern is streamed from a small reusable chunk buffer in large transfers,
+ * which makes it suitable for clearing the screen or drawing solid bars at runtime.
+ *
+ * @note Coordinates follow esp_lcd_panel_draw_bitmap() (end exclusive, gap applied).
+ *       The area is extended to whole pages (8 pixels, 4 in gray mode) along the
+ *       page axis (Y in landscape, X in portrait).
+ * @note `pattern` is the raw DDRAM byte written to every column of every page:
+ *       0x00 clears, 0xFF sets all pixels, other values give repeating stripes.
+ *       In gray mode each byte holds four 2-bit pixels (0x55 is level 1 everywhere).
+ *
+ * @param[in] panel LCD panel handle returned by esp_lcd_new_panel_st75256()
+ * @param[in] x_start Start column index
+ * @param[in] y_start Start row index
+ * @param[in] x_end End column index (exclusive)
+ * @param[in] y_end End row index (exclusive)
+ * @param[in] pattern Byte written to each DDRAM column of each page
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid or the area is out of range
+ *          - ESP_ERR_INVALID_STATE if called from the flush task while the flush queue is full
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_st75256_fill_rect(esp_lcd_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end, uint8_t pattern);
+
+/**
+ * @brief Draw a bitmap from a task other than LVGL's
+ *
+ * Same area and data format as esp_lcd_panel_draw_bitmap(), but completion is
+ * reported through `on_done` instead of on_color_trans_done, so status bars or
+ * other producers can share the panel with LVGL. Every panel call is serialised
+ * by the driver; with async_flush the draw is queued in call order with the others.
+ *
+ * @note With async_flush `on_done` runs in the flush task and the function returns
+ *       once the draw is queued, drawing errors are only logged. `on_done` may queue
+ *       the next draw, see esp_lcd_panel_st75256_done_cb_t. Otherwise it draws
+ *       and calls `on_done` before returning.
+ *
+ * @param[in] panel LCD panel handle returned by esp_lcd_new_panel_st75256()
+ * @param[in] x_start Start column index
+ * @param[in] y_start Start row index
+ * @param[in] x_end End column index (exclusive)
+ * @param[in] y_end End row index (exclusive)
+ * @param[in] color_data Pixel data, must stay valid until `on_done`
+ * @param[in] on_done Called once the data was sent, may be NULL
+ * @param[in] user_ctx Passed to `on_done`
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid or the area is out of range
+ *          - ESP_ERR_INVALID_STATE if called from the flush task while the flush queue is full, `on_done` is not called
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_st75256_queue_bitmap(esp_lcd_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end,
+                                             const void *color_data, esp_lcd_panel_st75256_done_cb_t on_done, void *user_ctx);
+
+/**
+ * @brief Select the pixel data layout draw_bitmap takes on a monochrome ST75256 panel
+ *
+ * @note Takes effect for the next draw_bitmap call. Gray mode always takes 8-bit color.
+ *
+ * @param[in] panel LCD panel handle returned by esp_lcd_new_panel_st75256()
+ * @param[in] format Input layout, ESP_LCD_ST75256_INPUT_LVGL_PAGES by default
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_ERR_NOT_SUPPORTED if the panel is in gray mode
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_st75256_set_input_format(esp_lcd_panel_handle_t panel, esp_lcd_st75256_input_format_t format);
+
+/**
+ * @brief DDRAM rows the display start line of an ST75256 panel wraps around, default geometry
+ *
+ * 128 of them are visible, the other 40 scroll in from below. Other geometries
+ * wrap around geometry.ddram_pages * 8 rows, see esp_lcd_panel_st75256_get_geometry().
+ */
+#define ESP_LCD_ST75256_SCROLL_LINES 168
+
+/**
+ * @brief Set the display start line of an ST75256 panel (hardware vertical scroll)
+ *
+ * The screen then shows DDRAM from row `start_line` on, wrapping around after
+ * the DDRAM rows (ESP_LCD_ST75256_SCROLL_LINES by default): raising the start line by N moves the whole
+ * picture up by N rows with a single command. Drawing keeps using screen
+ * coordinates, so only the rows scrolled in at the edge need to be drawn.
+ *
+ * @note Landscape only, without Y mirror. Rotating or mirroring Y returns to start line 0.
+ * @note With flags.shadow_fb the shadow moves along: a full-screen redraw after
+ *       scrolling only sends the rows that really changed.
+ *
+ * @param[in] panel LCD panel handle returned by esp_lcd_new_panel_st75256()
+ * @param[in] start_line Multiple of the page height (8 pixels, 4 in gray mode) below the DDRAM rows
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_ERR_NOT_SUPPORTED if the panel is in portrait, Y mirrored or has a Y gap that is not page aligned
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_st75256_set_scroll(esp_lcd_panel_handle_t panel, int start_line);
+
+/**
+ * @brief Get the display start line of an ST75256 panel
+ *
+ * @param[in] panel LCD panel handle returned by esp_lcd_new_panel_st75256()
+ * @param[out] start_line Current start line, 0 unless set by esp_lcd_panel_st75256_set_scroll()
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_st75256_get_scroll(esp_lcd_panel_handle_t panel, int *start_line);
+
+/**
+ * @brief Enter or leave power save (0x95 / 0x94)
+ *
+ * Power save turns the display off and stops the controller's analog circuits,
+ * DDRAM and all settings are retained. Leaving it turns the display back on if
+ * disp_on_off() had turned it on, without redrawing. The next draw, fill or
+ * disp_on_off(true) also leaves power save. With async_flush the call is queued
+ * behind pending draws.
+ *
+ * @param[in] panel LCD panel handle returned by esp_lcd_new_panel_st75256()
+ * @param[in] enable true to enter power save, false to leave it
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_st75256_set_power_save(esp_lcd_panel_handle_t panel, bool enable);
+
+/**
+ * @brief Check whether an ST75256 panel is in power save
+ *
+ * @note Does not wait for queued calls (async_flush), a set_power_save() still in the queue is not reflected yet.
+ *
+ * @param[in] panel LCD panel handle returned by esp_lcd_new_panel_st75256()
+ * @param[out] enabled true while in power save, entered by the idle timer or esp_lcd_panel_st75256_set_power_save()
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_st75256_get_power_save(esp_lcd_panel_handle_t panel, bool *enabled);
+
+/**
+ * @brief Time since the last draw or fill of an ST75256 panel was sent
+ *
+ * The activity power_save_idle_ms is measured against. Draws still queued (async_flush)
+ * count as activity, the call does not wait for them.
+ *
+ * @param[in] panel LCD panel handle returned by esp_lcd_new_panel_st75256()
+ * @param[out] idle_ms Milliseconds since the last draw or fill, since boot if there was none
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_st75256_get_idle_time(esp_lcd_panel_handle_t panel, uint32_t *idle_ms);
+
+/**
+ * @brief Set the frame rate codes of an ST75256 panel and when to switch between them
+ *
+ * Replaces esp_lcd_panel_st75256_config_t.frame_rate. The code matching the
+ * current flush cadence is sent at once. The setting survives init, the
+ * codes in use and the measured cadence are reported by
+ * esp_lcd_panel_st75256_get_stats().
+ *
+ * @param[in] panel LCD panel handle returned by esp_lcd_new_panel_st75256()
+ * @param[in] frame_rate Codes and switching policy, see esp_lcd_panel_st75256_frame_rate_t
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_st75256_set_frame_rate(esp_lcd_panel_handle_t panel, const esp_lcd_panel_st75256_frame_rate_t *frame_rate);
+
+/**
+ * @brief Get the geometry an ST75256 panel was created with, defaults filled in
+ *
+ * @param[in] panel LCD panel handle returned by esp_lcd_new_panel_st75256()
+ * @param[out] geometry Visible size, DDRAM pages and column offset
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_st75256_get_geometry(esp_lcd_panel_handle_t panel, esp_lcd_panel_st75256_geometry_t *geometry);
+
+/**
+ * @brief Forget the cached controller state of an ST75256 panel
+ *
+ * The driver remembers the active command set, address window, data order and
+ * scan direction, and skips commands that would not change them. Call this after
+ * the controller was reset or disturbed outside the driver (e.g. a bus error
+ * reported by another device on the same bus), so that the next writes are sent
+ * unconditionally. Resets, init and failed transfers inside the driver do this
+ * automatically.
+ *
+ * @param[in] panel LCD panel handle returned by esp_lcd_new_panel_st75256()
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_st75256_invalidate_cache(esp_lcd_panel_handle_t panel);
+
+/**
+ * @brief Get the bus statistics of an ST75256 panel
+ *
+ * @param[in] panel LCD panel handle returned by esp_lcd_new_panel_st75256()
+ * @param[out] stats Returned statistics
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_st75256_get_stats(esp_lcd_panel_handle_t panel, esp_lcd_panel_st75256_stats_t *stats);
+
+/**
+ * @brief Clear the statistics of an ST75256 panel
+ *
+ * @param[in] panel LCD panel handle returned by esp_lcd_new_panel_st75256()
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_st75256_reset_stats(esp_lcd_panel_handle_t panel);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,388 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Your Name
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <inttypes.h>
+#include <sys/param.h>
+#include "esp_check.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_lcd_st75256.h"
+#include "esp_lcd_st75256_lvgl.h"
+
+static const char *TAG = "lcd_panel.st75256_lvgl";
+
+/**
+ * 硬件旋转：LVGL 直接按旋转后的坐标渲染（不做软件旋转），面板用 swap_xy/mirror 完成映射，
+ * 8 种组合都由 ST75256 的扫描方向实现（见 esp_lcd_st75256.c 的方向引擎）。
+ * 每个 1/4 圈写成 (swap, mirror_x, mirror_y)，方向与 LVGL 软件旋转一致：
+ * 90° 时旋转后的 (x, y) 对应原来的 (y, ver_res - 1 - x)。
+ * 再与显示设备的基础镜像（rotation.mirror_x/y）组合：先镜像再交换，交换会互换两个镜像轴。
+ */
+static esp_err_t st75256_lvgl_apply_rotation(esp_lcd_panel_handle_t panel, bool portrait, bool mirror_x, bool mirror_y, int rotation)
+{
+    static const bool quarter_turns[4][3] = {
+        {false, false, false},
+        {true, true, false},
+        {false, true, true},
+        {true, false, true},
+    };
+    const bool *turn = quarter_turns[rotation & 0x03];
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_swap_xy(panel, turn[0] != portrait), TAG, "swap xy failed");
+    return esp_lcd_panel_mirror(panel, turn[1] != (turn[0] ? mirror_y : mirror_x), turn[2] != (turn[0] ? mirror_x : mirror_y));
+}
+
+#if LVGL_VERSION_MAJOR >= 9
+
+typedef struct {
+    esp_lcd_panel_io_handle_t io;
+    esp_lcd_panel_handle_t panel;
+    bool portrait;            // Current orientation, follows lv_display_set_rotation()
+    bool base_portrait;       // Orientation and mirroring at LV_DISPLAY_ROTATION_0
+    bool mirror_x;
+    bool mirror_y;
+    uint8_t *buf[2];
+} st75256_lvgl_disp_t;
+
+/**
+ * LVGL v9：显示设备直接使用 LV_COLOR_FORMAT_I1 渲染（每像素 1 位，按行排列），
+ * 驱动以 ESP_LCD_ST75256_INPUT_I1 接收：竖屏逐字节取反即可发送，横屏按 8x8 块转置。
+ * 缓冲区开头是 8 字节调色板，flush 时跳过。
+ */
+static void st75256_lvgl_rounder_event(lv_event_t *e)
+{
+    st75256_lvgl_disp_t *disp = lv_event_get_user_data(e);
+    lv_area_t *area = lv_event_get_param(e);
+    if (disp->portrait) {
+        area->x1 &= ~0x07;
+        area->x2 |= 0x07;
+    } else {
+        area->y1 &= ~0x07;
+        area->y2 |= 0x07;
+    }
+}
+
+// lv_display_set_rotation(): LVGL now renders in the rotated resolution, the panel follows
+static void st75256_lvgl_rotation_event(lv_event_t *e)
+{
+    st75256_lvgl_disp_t *disp = lv_event_get_user_data(e);
+    lv_display_t *lv_disp = lv_event_get_target(e);
+    if (st75256_lvgl_apply_rotation(disp->panel, disp->base_portrait, disp->mirror_x, disp->mirror_y,
+                                    lv_display_get_rotation(lv_disp)) != ESP_OK) {
+        ESP_LOGE(TAG, "rotate panel failed");
+    }
+    disp->portrait = lv_display_get_horizontal_resolution(lv_disp) < lv_display_get_vertical_resolution(lv_disp);
+}
+
+static bool st75256_lvgl_flush_ready(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+{
+    lv_display_flush_ready(user_ctx);
+    return false;
+}
+
+static void st75256_lvgl_flush(lv_display_t *lv_disp, const lv_area_t *area, uint8_t *px_map)
+{
+    st75256_lvgl_disp_t *disp = lv_display_get_driver_data(lv_disp);
+    px_map += ST75256_LVGL_I1_PALETTE_SIZE;
+    if (esp_lcd_panel_draw_bitmap(disp->panel, area->x1, area->y1, area->x2 + 1, area->y2 + 1, px_map) != ESP_OK) {
+        // A rejected flush may never reach on_color_trans_done, do not leave LVGL waiting
+        lv_display_flush_ready(lv_disp);
+    }
+}
+
+lv_display_t *esp_lcd_st75256_lvgl_add_disp(const esp_lcd_st75256_lvgl_display_cfg_t *disp_cfg)
+{
+    esp_err_t ret = ESP_OK;
+    lv_display_t *lv_disp = NULL;
+    st75256_lvgl_disp_t *disp = NULL;
+    ESP_GOTO_ON_FALSE(disp_cfg && disp_cfg->io_handle && disp_cfg->panel_handle && disp_cfg->hres && disp_cfg->vres,
+                      ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+    // LVGL 9 splits areas that do not fit the buffer without asking the rounder, which could break page alignment
+    ESP_GOTO_ON_FALSE(!disp_cfg->strip_pages, ESP_ERR_NOT_SUPPORTED, err, TAG, "strip_pages needs LVGL 8");
+    ESP_GOTO_ON_FALSE(disp_cfg->buffer_size == disp_cfg->hres * disp_cfg->vres, ESP_ERR_INVALID_ARG, err, TAG,
+                      "buffer_size must be %" PRIu32 " pixels with LVGL 9", disp_cfg->hres * disp_cfg->vres);
+    ESP_GOTO_ON_ERROR(esp_lcd_panel_st75256_set_input_format(disp_cfg->panel_handle, ESP_LCD_ST75256_INPUT_I1), err, TAG, "set input format failed");
+    ESP_GOTO_ON_ERROR(st75256_lvgl_apply_rotation(disp_cfg->panel_handle, disp_cfg->hres < disp_cfg->vres, disp_cfg->rotation.mirror_x,
+                                                  disp_cfg->rotation.mirror_y, 0), err, TAG, "set panel orientation failed");
+
+    disp = calloc(1, sizeof(st75256_lvgl_disp_t));
+    ESP_GOTO_ON_FALSE(disp, ESP_ERR_NO_MEM, err, TAG, "no mem for display");
+    size_t buf_bytes = ST75256_LVGL_I1_PALETTE_SIZE + (disp_cfg->buffer_size + 7) / 8;
+    disp->buf[0] = calloc(1, buf_bytes);
+    if (disp_cfg->double_buffer) {
+        disp->buf[1] = calloc(1, buf_bytes);
+    }
+    ESP_GOTO_ON_FALSE(disp->buf[0] && (disp->buf[1] || !disp_cfg->double_buffer), ESP_ERR_NO_MEM, err, TAG, "no mem for draw buffers");
+    disp->io = disp_cfg->io_handle;
+    disp->panel = disp_cfg->panel_handle;
+    disp->portrait = disp_cfg->hres < disp_cfg->vres;
+    disp->base_portrait = disp->portrait;
+    disp->mirror_x = disp_cfg->rotation.mirror_x;
+    disp->mirror_y = disp_cfg->rotation.mirror_y;
+
+    lv_disp = lv_display_create(disp_cfg->hres, disp_cfg->vres);
+    ESP_GOTO_ON_FALSE(lv_disp, ESP_ERR_NO_MEM, err, TAG, "create LVGL display failed");
+    lv_display_set_color_format(lv_disp, LV_COLOR_FORMAT_I1);
+    lv_display_set_buffers(lv_disp, disp->buf[0], disp->buf[1], buf_bytes, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(lv_disp, st75256_lvgl_flush);
+    lv_display_set_driver_data(lv_disp, disp);
+    lv_display_add_event_cb(lv_disp, st75256_lvgl_rounder_event, LV_EVENT_INVALIDATE_AREA, disp);
+    lv_display_add_event_cb(lv_disp, st75256_lvgl_rotation_event, LV_EVENT_RESOLUTION_CHANGED, disp);
+
+    const esp_lcd_panel_io_callbacks_t cbs = {
+        .on_color_trans_done = st75256_lvgl_flush_ready,
+    };
+    ESP_GOTO_ON_ERROR(esp_lcd_panel_io_register_event_callbacks(disp->io, &cbs, lv_disp), err, TAG, "register IO callback failed");
+    ESP_LOGD(TAG, "display %" PRIu32 "x%" PRIu32 ", %u byte I1 draw buffer%s", disp_cfg->hres, disp_cfg->vres,
+             (unsigned)buf_bytes, disp_cfg->double_buffer ? " x2" : "");
+    return lv_disp;
+
+err:
+    if (ret != ESP_OK && disp) {
+        const esp_lcd_panel_io_callbacks_t no_cbs = {0};
+        esp_lcd_panel_io_register_event_callbacks(disp->io, &no_cbs, NULL);
+        if (lv_disp) {
+            lv_display_delete(lv_disp);
+        }
+        free(disp->buf[0]);
+        free(disp->buf[1]);
+        free(disp);
+    }
+    return NULL;
+}
+
+esp_err_t esp_lcd_st75256_lvgl_remove_disp(lv_display_t *lv_disp)
+{
+    ESP_RETURN_ON_FALSE(lv_disp, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st75256_lvgl_disp_t *disp = lv_display_get_driver_data(lv_disp);
+    ESP_RETURN_ON_FALSE(disp, ESP_ERR_INVALID_ARG, TAG, "not an ST75256 LVGL display");
+
+    const esp_lcd_panel_io_callbacks_t no_cbs = {0};
+    esp_lcd_panel_io_register_event_callbacks(disp->io, &no_cbs, NULL);
+    lv_display_delete(lv_disp);
+    free(disp->buf[0]);
+    free(disp->buf[1]);
+    free(disp);
+    return ESP_OK;
+}
+
+#else /* LVGL 8 */
+
+typedef struct {
+    lv_disp_drv_t drv;
+    lv_disp_draw_buf_t draw_buf;
+    esp_lcd_panel_io_handle_t io;
+    esp_lcd_panel_handle_t panel;
+    bool mirror_x;            // Mirroring at LV_DISP_ROT_NONE
+    bool mirror_y;
+    uint8_t *buf[2];
+} st75256_lvgl_disp_t;
+
+/**
+ * 渲染即转换：LVGL 通过 set_px 直接写入 ST75256 的发送顺序，draw_bitmap 不再转置。
+ *  - 横屏（旋转后 hor_res > ver_res）：竖向页格式，byte = (y / 8) * buf_w + x，bit = y % 8
+ *  - 竖屏：LVGL 的每一行是一个硬件列，byte = y * (buf_w / 8) + x / 8，bit = x % 8
+ * buf_w 是当前刷新区域的宽度，坐标相对区域左上角，因此不需要全屏刷新。
+ * 旋转 90°/270° 由面板完成（sw_rotate = 0），LVGL 按旋转后的坐标渲染，横竖屏随之互换。
+ */
+static inline bool st75256_lvgl_portrait(const lv_disp_drv_t *drv)
+{
+    return (drv->hor_res < drv->ver_res) != (drv->rotated == LV_DISP_ROT_90 || drv->rotated == LV_DISP_ROT_270);
+}
+
+void esp_lcd_st75256_lvgl_rounder(lv_disp_drv_t *drv, lv_area_t *area)
+{
+    if (st75256_lvgl_portrait(drv)) {
+        area->x1 &= ~0x07;
+        area->x2 |= 0x07;
+    } else {
+        area->y1 &= ~0x07;
+        area->y2 |= 0x07;
+    }
+}
+
+void esp_lcd_st75256_lvgl_set_px(lv_disp_drv_t *drv, uint8_t *buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
+                                 lv_color_t color, lv_opa_t opa)
+{
+    uint8_t mask;
+    if (st75256_lvgl_portrait(drv)) {
+        buf += y * (buf_w >> 3) + (x >> 3);
+        mask = 1 << (x & 0x07);
+    } else {
+        buf += (y >> 3) * buf_w + x;
+        mask = 1 << (y & 0x07);
+    }
+    if (lv_color_to1(color)) {
+        *buf &= ~mask;
+    } else {
+        *buf |= mask;
+    }
+}
+
+esp_err_t esp_lcd_st75256_lvgl_attach(lv_disp_t *disp, esp_lcd_panel_handle_t panel)
+{
+    ESP_RETURN_ON_FALSE(disp && disp->driver && panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    lv_disp_drv_t *drv = disp->driver;
+    // esp_lvgl_port rotates through the panel's swap_xy/mirror, software rotation would need another layout
+    ESP_RETURN_ON_FALSE(!drv->sw_rotate, ESP_ERR_NOT_SUPPORTED, TAG, "rotate the panel, not LVGL");
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_st75256_set_input_format(panel, ESP_LCD_ST75256_INPUT_NATIVE), TAG, "set input format failed");
+
+    drv->rounder_cb = esp_lcd_st75256_lvgl_rounder;
+    drv->set_px_cb = esp_lcd_st75256_lvgl_set_px;
+    // esp_lvgl_port forces full refresh for monochrome because its set_px indexes by hor_res
+    drv->full_refresh = 0;
+    // Anything rendered so far used the old layout
+    lv_obj_invalidate(lv_disp_get_scr_act(disp));
+    return ESP_OK;
+}
+
+static bool st75256_lvgl_flush_ready(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+{
+    lv_disp_flush_ready(user_ctx);
+    return false;
+}
+
+// lv_disp_set_rotation(): drv->hor_res/ver_res stay unrotated, drv->rotated is the new rotation
+static void st75256_lvgl_update(lv_disp_drv_t *drv)
+{
+    st75256_lvgl_disp_t *disp = drv->user_data;
+    if (st75256_lvgl_apply_rotation(disp->panel, drv->hor_res < drv->ver_res, disp->mirror_x, disp->mirror_y, drv->rotated) != ESP_OK) {
+        ESP_LOGE(TAG, "rotate panel failed");
+    }
+}
+
+static void st75256_lvgl_flush(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map)
+{
+    st75256_lvgl_disp_t *disp = drv->user_data;
+    if (esp_lcd_panel_draw_bitmap(disp->panel, area->x1, area->y1, area->x2 + 1, area->y2 + 1, color_map) != ESP_OK) {
+        // A rejected flush may never reach on_color_trans_done, do not leave LVGL waiting
+        lv_disp_flush_ready(drv);
+    }
+}
+
+/**
+ * 紧凑显存：LVGL v8 按像素数（lv_color_t）计算缓冲区大小，但 set_px 回调只写入 1/8 的字节，
+ * 因此向 LVGL 声明 buffer_size 个像素，实际只分配 buffer_size / 8 字节。
+ * 缓冲区小于刷新区域时，LVGL 按缓冲区能容纳的行数分条渲染，rounder 保证每条按页对齐。
+ * 条带模式（strip_pages）：缓冲区只有几页高，配合双缓冲与面板的 async_flush，
+ * 一条在总线上发送时 LVGL 已经在渲染下一条，渲染时间被总线时间掩盖。
+ */
+lv_disp_t *esp_lcd_st75256_lvgl_add_disp(const esp_lcd_st75256_lvgl_display_cfg_t *disp_cfg)
+{
+    esp_err_t ret = ESP_OK;
+    lv_disp_t *lv_disp = NULL;
+    st75256_lvgl_disp_t *disp = NULL;
+    ESP_GOTO_ON_FALSE(disp_cfg && disp_cfg->io_handle && disp_cfg->panel_handle && disp_cfg->hres && disp_cfg->vres,
+                      ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+    uint32_t screen_size = disp_cfg->hres * disp_cfg->vres;
+    uint32_t buffer_size = disp_cfg->strip_pages ? MIN(disp_cfg->hres * 8 * disp_cfg->strip_pages, screen_size) : disp_cfg->buffer_size;
+    // Landscape strips must hold at least one page (8 rows), portrait strips one row of 8-pixel groups
+    uint32_t min_size = disp_cfg->hres < disp_cfg->vres ? disp_cfg->hres : disp_cfg->hres * 8;
+    ESP_GOTO_ON_FALSE(buffer_size >= min_size && buffer_size <= screen_size,
+                      ESP_ERR_INVALID_ARG, err, TAG, "buffer_size must be %" PRIu32 "..%" PRIu32 " pixels",
+                      min_size, screen_size);
+    ESP_GOTO_ON_ERROR(esp_lcd_panel_st75256_set_input_format(disp_cfg->panel_handle, ESP_LCD_ST75256_INPUT_NATIVE), err, TAG, "set input format failed");
+    ESP_GOTO_ON_ERROR(st75256_lvgl_apply_rotation(disp_cfg->panel_handle, disp_cfg->hres < disp_cfg->vres, disp_cfg->rotation.mirror_x,
+                                                  disp_cfg->rotation.mirror_y, 0), err, TAG, "set panel orientation failed");
+
+    disp = calloc(1, sizeof(st75256_lvgl_disp_t));
+    ESP_GOTO_ON_FALSE(disp, ESP_ERR_NO_MEM, err, TAG, "no mem for display");
+    size_t buf_bytes = (buffer_size + 7) / 8;
+    disp->buf[0] = calloc(1, buf_bytes);
+    if (disp_cfg->double_buffer) {
+        disp->buf[1] = calloc(1, buf_bytes);
+    }
+    ESP_GOTO_ON_FALSE(disp->buf[0] && (disp->buf[1] || !disp_cfg->double_buffer), ESP_ERR_NO_MEM, err, TAG, "no mem for draw buffers");
+    disp->io = disp_cfg->io_handle;
+    disp->panel = disp_cfg->panel_handle;
+    disp->mirror_x = disp_cfg->rotation.mirror_x;
+    disp->mirror_y = disp_cfg->rotation.mirror_y;
+
+    lv_disp_draw_buf_init(&disp->draw_buf, disp->buf[0], disp->buf[1], buffer_size);
+    lv_disp_drv_init(&disp->drv);
+    disp->drv.hor_res = disp_cfg->hres;
+    disp->drv.ver_res = disp_cfg->vres;
+    disp->drv.flush_cb = st75256_lvgl_flush;
+    disp->drv.rounder_cb = esp_lcd_st75256_lvgl_rounder;
+    disp->drv.set_px_cb = esp_lcd_st75256_lvgl_set_px;
+    disp->drv.drv_update_cb = st75256_lvgl_update;
+    disp->drv.draw_buf = &disp->draw_buf;
+    disp->drv.user_data = disp;
+
+    const esp_lcd_panel_io_callbacks_t cbs = {
+        .on_color_trans_done = st75256_lvgl_flush_ready,
+    };
+    ESP_GOTO_ON_ERROR(esp_lcd_panel_io_register_event_callbacks(disp->io, &cbs, &disp->drv), err, TAG, "register IO callback failed");
+
+    lv_disp = lv_disp_drv_register(&disp->drv);
+    ESP_GOTO_ON_FALSE(lv_disp, ESP_ERR_NO_MEM, err, TAG, "register LVGL display failed");
+    ESP_LOGD(TAG, "display %" PRIu32 "x%" PRIu32 ", %u byte draw buffer%s", disp_cfg->hres, disp_cfg->vres,
+             (unsigned)buf_bytes, disp_cfg->double_buffer ? " x2" : "");
+    return lv_disp;
+
+err:
+    if (ret != ESP_OK && disp) {
+        const esp_lcd_panel_io_callbacks_t no_cbs = {0};
+        esp_lcd_panel_io_register_event_callbacks(disp->io, &no_cbs, NULL);
+        free(disp->buf[0]);
+        free(disp->buf[1]);
+        free(disp);
+    }
+    return NULL;
+}
+
+esp_err_t esp_lcd_st75256_lvgl_remove_disp(lv_disp_t *lv_disp)
+{
+    ESP_RETURN_ON_FALSE(lv_disp && lv_disp->driver, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st75256_lvgl_disp_t *disp = lv_disp->driver->user_data;
+    ESP_RETURN_ON_FALSE(disp && lv_disp->driver == &disp->drv, ESP_ERR_INVALID_ARG, TAG, "not an ST75256 LVGL display");
+
+    const esp_lcd_panel_io_callbacks_t no_cbs = {0};
+    esp_lcd_panel_io_register_event_callbacks(disp->io, &no_cbs, NULL);
+    lv_disp_remove(lv_disp);
+    free(disp->buf[0]);
+    free(disp->buf[1]);
+    free(disp);
+    return ESP_OK;
+}
+
+#endif /* LVGL_VERSION_MAJOR */
+
+esp_err_t esp_lcd_st75256_lvgl_scroll(esp_lcd_panel_handle_t panel, lv_obj_t *obj, int rows)
+{
+    ESP_RETURN_ON_FALSE(panel && obj, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    int line = 0;
+    esp_lcd_panel_st75256_geometry_t geometry;
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_st75256_get_scroll(panel, &line), TAG, "get scroll failed");
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_st75256_get_geometry(panel, &geometry), TAG, "get geometry failed");
+    const int lines = geometry.ddram_pages * 8;
+    line = ((line + rows) % lines + lines) % lines;
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_st75256_set_scroll(panel, line), TAG, "set scroll failed");
+    // Positive dy moves the content down in LVGL
+    lv_obj_scroll_by(obj, 0, -rows, LV_ANIM_OFF);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_st75256_lvgl_power_save_update(esp_lcd_panel_handle_t panel, lv_disp_t *disp, uint32_t inactive_ms)
+{
+    ESP_RETURN_ON_FALSE(panel && inactive_ms, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    bool power_save = false;
+    uint32_t panel_idle_ms = 0;
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_st75256_get_power_save(panel, &power_save), TAG, "get power save failed");
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_st75256_get_idle_time(panel, &panel_idle_ms), TAG, "get idle time failed");
+    // Time since the last input event, fed by the input devices registered with esp_lvgl_port
+#if LVGL_VERSION_MAJOR >= 9
+    uint32_t input_idle_ms = lv_display_get_inactive_time(disp);
+#else
+    uint32_t input_idle_ms = lv_disp_get_inactive_time(disp);
+#endif
+    // A screen that redraws by itself stays on: each draw would wake the panel right after it went to sleep
+    bool idle = input_idle_ms >= inactive_ms && panel_idle_ms >= inactive_ms;
+    if (idle == power_save) {
+        return ESP_OK;
+    }
+    return esp_lcd_panel_st75256_set_power_save(panel, idle);
+}
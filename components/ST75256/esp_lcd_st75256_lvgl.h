@@ -0,0 +1,217 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Your Name
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_lcd_types.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Configuration of an LVGL display with packed 1bpp draw buffers
+ */
+typedef struct {
+    esp_lcd_panel_io_handle_t io_handle;    /*!< Panel IO, its on_color_trans_done completes LVGL flushes */
+    esp_lcd_panel_handle_t panel_handle;    /*!< Monochrome panel returned by esp_lcd_new_panel_st75256() */
+    uint32_t hres;                          /*!< Horizontal resolution: panel geometry width in landscape, height in portrait (256 / 128 by default) */
+    uint32_t vres;                          /*!< Vertical resolution: panel geometry height in landscape, width in portrait (128 / 256 by default) */
+    /**
+     * @brief Draw buffer size in pixels, stored at 1 bit per pixel
+     *
+     * hres * vres renders a full screen per buffer (4 KB). With LVGL 8 smaller
+     * buffers render the invalidated area in page strips; landscape needs at least
+     * hres * 8. LVGL 9 needs a full-screen buffer.
+     */
+    uint32_t buffer_size;
+    /**
+     * @brief Render in bands of this many 8-pixel pages, 0 = use buffer_size (LVGL 8 only)
+     *
+     * Overrides buffer_size with hres * 8 * strip_pages pixels, e.g. 2 pages take
+     * 512 bytes per buffer in landscape. Together with double_buffer and the panel's
+     * flags.async_flush, LVGL renders the next band while the previous one is on the
+     * bus, so rendering no longer adds to the frame time of a bus-bound link.
+     */
+    uint8_t strip_pages;
+    bool double_buffer;                     /*!< Allocate a second buffer, LVGL renders while the other one is sent */
+    /**
+     * @brief Mirroring at rotation 0, hres < vres selects the panel's portrait mode
+     *
+     * The display sets the panel orientation itself and follows lv_disp_set_rotation()
+     * (lv_display_set_rotation() in LVGL 9) with the panel's scan direction, LVGL renders
+     * the rotated frame without software rotation. A strip buffer must also hold 8 rows
+     * of the rotated width (LVGL 8).
+     */
+    struct {
+        bool mirror_x;                      /*!< Mirror the X axis of the unrotated display */
+        bool mirror_y;                      /*!< Mirror the Y axis of the unrotated display */
+    } rotation;
+} esp_lcd_st75256_lvgl_display_cfg_t;
+
+#if LVGL_VERSION_MAJOR >= 9
+
+/**
+ * @brief Size of the palette LVGL 9 puts in front of I1 draw buffers
+ */
+#define ST75256_LVGL_I1_PALETTE_SIZE 8
+
+/**
+ * @brief Register a monochrome ST75256 panel with LVGL 9 rendering in LV_COLOR_FORMAT_I1
+ *
+ * LVGL renders 1 bit per pixel natively and the panel takes the buffer as
+ * ESP_LCD_ST75256_INPUT_I1: portrait frames are only inverted byte by byte,
+ * landscape frames are transposed in 8x8 blocks. A full-screen double buffer
+ * takes about 8 KB. Invalidated areas are rounded to whole pages.
+ *
+ * @note LVGL must be initialized with lvgl_port_init(), which runs the LVGL task
+ *       and tick. Call with the LVGL lock held (lvgl_port_lock()).
+ * @note Registers on_color_trans_done on the panel IO. LV_DRAW_BUF_STRIDE_ALIGN must be 1.
+ *
+ * @param[in] disp_cfg Display configuration
+ * @return
+ *          - LVGL display on success
+ *          - NULL if a parameter is invalid, the panel is in gray mode or out of memory
+ */
+lv_display_t *esp_lcd_st75256_lvgl_add_disp(const esp_lcd_st75256_lvgl_display_cfg_t *disp_cfg);
+
+/**
+ * @brief Remove a display added by esp_lcd_st75256_lvgl_add_disp() and free its buffers
+ *
+ * @note Call with the LVGL lock held (lvgl_port_lock()).
+ *
+ * @param[in] disp LVGL display returned by esp_lcd_st75256_lvgl_add_disp()
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_st75256_lvgl_remove_disp(lv_display_t *disp);
+
+#else /* LVGL 8 */
+
+/**
+ * @brief LVGL rounder for monochrome ST75256 panels
+ *
+ * Extends the area to whole 8-pixel pages along the page axis: Y in landscape
+ * (hor_res > ver_res), X in portrait.
+ */
+void esp_lcd_st75256_lvgl_rounder(lv_disp_drv_t *drv, lv_area_t *area);
+
+/**
+ * @brief LVGL set_px callback writing ST75256 DDRAM transmit order
+ *
+ * Pixels go straight into the page bytes the panel sends, so draw_bitmap needs
+ * no transpose in portrait mode. The draw buffer must be used with
+ * esp_lcd_st75256_lvgl_rounder() and a panel in ESP_LCD_ST75256_INPUT_NATIVE.
+ * Light colors clear the pixel and dark colors set it, as in esp_lvgl_port.
+ */
+void esp_lcd_st75256_lvgl_set_px(lv_disp_drv_t *drv, uint8_t *buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
+                                 lv_color_t color, lv_opa_t opa);
+
+/**
+ * @brief Render an LVGL display directly in ST75256 native format
+ *
+ * Installs esp_lcd_st75256_lvgl_rounder() and esp_lcd_st75256_lvgl_set_px()
+ * on a display registered with esp_lvgl_port (monochrome), switches the panel
+ * to ESP_LCD_ST75256_INPUT_NATIVE and turns off full refresh, so each frame is
+ * converted once while rendering and only invalidated pages are flushed.
+ *
+ * @note Call with the LVGL lock held (lvgl_port_lock()). Rotate with esp_lvgl_port's
+ *       rotation config and lv_disp_set_rotation(), which drive the panel's
+ *       swap_xy/mirror; LVGL software rotation (flags.sw_rotate) is not supported.
+ *
+ * @param[in] disp LVGL display returned by lvgl_port_add_disp()
+ * @param[in] panel LCD panel handle returned by esp_lcd_new_panel_st75256()
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_ERR_NOT_SUPPORTED if the panel is in gray mode or the display uses software rotation
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_st75256_lvgl_attach(lv_disp_t *disp, esp_lcd_panel_handle_t panel);
+
+/**
+ * @brief Register a monochrome ST75256 panel with LVGL using packed 1bpp draw buffers
+ *
+ * Unlike lvgl_port_add_disp(), which allocates one lv_color_t per pixel for
+ * monochrome displays, the draw buffers only hold the panel's native page bytes:
+ * a full-screen double buffer takes 8 KB instead of 64 KB. The display renders
+ * through esp_lcd_st75256_lvgl_set_px() and flushes invalidated pages only.
+ *
+ * @note LVGL must be initialized with lvgl_port_init(), which runs the LVGL task
+ *       and tick. Call with the LVGL lock held (lvgl_port_lock()).
+ * @note Registers on_color_trans_done on the panel IO.
+ *
+ * @param[in] disp_cfg Display configuration
+ * @return
+ *          - LVGL display on success
+ *          - NULL if a parameter is invalid, the panel is in gray mode or out of memory
+ */
+lv_disp_t *esp_lcd_st75256_lvgl_add_disp(const esp_lcd_st75256_lvgl_display_cfg_t *disp_cfg);
+
+/**
+ * @brief Remove a display added by esp_lcd_st75256_lvgl_add_disp() and free its buffers
+ *
+ * @note Call with the LVGL lock held (lvgl_port_lock()).
+ *
+ * @param[in] disp LVGL display returned by esp_lcd_st75256_lvgl_add_disp()
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_st75256_lvgl_remove_disp(lv_disp_t *disp);
+
+#endif /* LVGL_VERSION_MAJOR */
+
+/**
+ * @brief Scroll an LVGL object together with the panel's display start line
+ *
+ * Moves the object's content up by `rows` pixels (down if negative) with
+ * lv_obj_scroll_by() and the panel picture with esp_lcd_panel_st75256_set_scroll(),
+ * so the screen moves at once. LVGL still redraws the object, with flags.shadow_fb
+ * only the rows scrolled in then differ from the panel and reach the bus.
+ *
+ * @note The start line moves the whole screen: `obj` should cover the full display
+ *       (e.g. a log view on its own screen). Call with the LVGL lock held.
+ *
+ * @param[in] panel LCD panel handle returned by esp_lcd_new_panel_st75256()
+ * @param[in] obj Scrollable LVGL object covering the screen
+ * @param[in] rows Rows to scroll, a multiple of the page height (8 pixels, 4 in gray mode)
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_ERR_NOT_SUPPORTED if the panel can not scroll, see esp_lcd_panel_st75256_set_scroll()
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_st75256_lvgl_scroll(esp_lcd_panel_handle_t panel, lv_obj_t *obj, int rows);
+
+/**
+ * @brief Follow LVGL's inactivity time with the panel's power save
+ *
+ * Enters power save once no input device has been used on `disp` and nothing has
+ * been drawn for `inactive_ms` (an animation keeps the panel on), and leaves it at
+ * the next input, even if the UI does not redraw. Draws wake the panel by themselves.
+ * Call it from the LVGL task, e.g. from an lv_timer every few hundred milliseconds;
+ * between calls the LVGL task sleeps as long as esp_lvgl_port lets it.
+ *
+ * @note With this helper leave esp_lcd_panel_st75256_config_t.power_save_idle_ms at 0
+ *       or above `inactive_ms`, otherwise the flush idle timer and the input activity
+ *       take turns switching the panel. Call with the LVGL lock held.
+ *
+ * @param[in] panel LCD panel handle returned by esp_lcd_new_panel_st75256()
+ * @param[in] disp LVGL display whose input activity counts, NULL for the most recent input on any display
+ * @param[in] inactive_ms Input and draw inactivity after which the panel sleeps, must not be 0
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_st75256_lvgl_power_save_update(esp_lcd_panel_handle_t panel, lv_disp_t *disp, uint32_t inactive_ms);
+
+#ifdef __cplusplus
+}
+#endif
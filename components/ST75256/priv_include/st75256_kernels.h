@@ -0,0 +1,67 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Your Name
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Signature shared by the conversion kernels: `num_rows` source rows of `width` pixels into `dst`
+ */
+typedef void (*st75256_kernel_fn_t)(const uint8_t *src, int width, int num_rows, uint8_t *dst);
+
+/**
+ * @brief Transpose a portrait monochrome area from LVGL vertical pages to ST75256 column-major order
+ *
+ * `width` and `height` must be multiples of 8. `dst` receives width / 8 bytes per column, height columns.
+ */
+void st75256_remap_swapped(const uint8_t *src, int width, int height, uint8_t *dst);
+
+/**
+ * @brief Pack 8-bit LVGL color (row-major) into 2bpp pages of 4 rows, landscape order
+ *
+ * `num_rows` must be a multiple of 4. `dst` receives num_rows / 4 pages of `width` bytes.
+ */
+void st75256_pack_gray_pages(const uint8_t *src, int width, int num_rows, uint8_t *dst);
+
+/**
+ * @brief Pack 8-bit LVGL color (row-major) into 2bpp bytes of 4 horizontal pixels, portrait order
+ *
+ * `width` must be a multiple of 4. `dst` receives width / 4 bytes per row, `num_rows` rows.
+ */
+void st75256_pack_gray_rows(const uint8_t *src, int width, int num_rows, uint8_t *dst);
+
+/**
+ * @brief Convert LVGL v9 I1 (row-major, MSB left, 1 = light) into pages of 8 rows, landscape order
+ *
+ * Rows are (width + 7) / 8 bytes. `num_rows` must be a multiple of 8. `dst` receives
+ * num_rows / 8 pages of `width` bytes.
+ */
+void st75256_pack_i1_pages(const uint8_t *src, int width, int num_rows, uint8_t *dst);
+
+/**
+ * @brief Convert LVGL v9 I1 (row-major, MSB left, 1 = light) into portrait order
+ *
+ * `width` must be a multiple of 8. `dst` receives width / 8 bytes per row, `num_rows` rows.
+ */
+void st75256_pack_i1_rows(const uint8_t *src, int width, int num_rows, uint8_t *dst);
+
+/**
+ * @brief Variant of `kernel` specialized for areas exactly `width` pixels wide
+ *
+ * The screen widths of the common geometries (256 landscape, 128/160/208 portrait)
+ * have kernels built with the width as a constant. Returns `kernel` itself if there
+ * is none, or NULL for a NULL kernel. The result must only be called with that width.
+ */
+st75256_kernel_fn_t st75256_kernel_for_width(st75256_kernel_fn_t kernel, int width);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,224 @@
+/*
+ * Pixel format kernels of the ST75256 driver. They only depend on the C library,
+ * so they can be built and benchmarked off-target as well.
+ */
+#include <stdint.h>
+#include <string.h>
+#include "st75256_kernels.h"
+
+// LVGL 8-bit color (RGB332) -> ST75256 gray level (0 = off .. 3 = darkest)
+// level = 3 - luma / 64, luma = (77 * R + 150 * G + 29 * B) / 256 on 8-bit expanded channels
+static const uint8_t st75256_gray_level[256] = {
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 2, 3, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 1, 2, 1, 1, 1, 1, 1, 1, 1,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    3, 3, 3, 3, 3, 3, 3, 2, 3, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0,
+    3, 3, 3, 3, 3, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0,
+    3, 3, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+    3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+/**
+ * 8x8 位矩阵转置（64 位字内的 shift/mask 蝶形交换）
+ *
+ * 输入第 i 个字节的第 j 位 → 输出第 j 个字节的第 i 位
+ */
+static inline uint64_t st75256_transpose8x8(uint64_t x)
+{
+    uint64_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x = x ^ t ^ (t << 28);
+    return x;
+}
+
+/**
+ * 将 LVGL 的 swap_xy 显存格式转换为 ST75256 硬件页格式（只处理刷新区域）
+ *
+ * @param src     LVGL 显存指针：height / 8 页，每页 width 字节（区域自身的跨度）
+ * @param width   区域宽度（LVGL X，8 的倍数），对应硬件的 width / 8 页
+ * @param height  区域高度（LVGL Y，8 的倍数），对应硬件的 height 列
+ * @param dst     紧密排列的硬件窗口：每列 width / 8 字节，共 height 列（竖向扫描先递增页地址）
+ *
+ * 每次处理一个 8x8 块：同一页中相邻 8 列的 8 个字节组成一个 64 位字，转置后
+ * 第 b 个字节正好是目标中 LVGL_Y = page * 8 + b 那一列的 8 个像素。
+ * 每个目标字节都会被写到，所以调用前无需清空 dst，耗时也与图像内容无关。
+ */
+static inline __attribute__((always_inline)) void st75256_remap_swapped_impl(const uint8_t *src, int width, int height, uint8_t *dst)
+{
+    const int dst_stride = width / 8;
+
+    for (int page = 0; page < height / 8; page++) {
+        const uint8_t *in = &src[page * width];
+        uint8_t *out = &dst[page * 8 * dst_stride];
+        for (int x = 0; x < width; x += 8) {
+            uint64_t block;
+            memcpy(&block, &in[x], sizeof(block)); // little-endian: byte j = column x + j
+            if (block) {
+                block = st75256_transpose8x8(block);
+            }
+
+            for (int bit = 0; bit < 8; bit++) {
+                out[bit * dst_stride + x / 8] = (uint8_t)(block >> (bit * 8));
+            }
+        }
+    }
+}
+
+void st75256_remap_swapped(const uint8_t *src, int width, int height, uint8_t *dst)
+{
+    st75256_remap_swapped_impl(src, width, height, dst);
+}
+
+/**
+ * 灰度打包（landscape）：源为按行排列的 8 位色，每 4 行组成一页，
+ * 同一列的 4 个像素打包为 1 字节（上方像素在低位，每像素 2 位）。
+ *
+ * @param src       LVGL 显存指针：num_rows 行，每行 width 字节
+ * @param width     区域宽度（硬件列数）
+ * @param num_rows  区域高度（4 的倍数）
+ * @param dst       输出：num_rows / 4 页，每页 width 字节
+ */
+void st75256_pack_gray_pages(const uint8_t *src, int width, int num_rows, uint8_t *dst)
+{
+    for (int row = 0; row < num_rows; row += 4) {
+        const uint8_t *r0 = src + (size_t)row * width;
+        const uint8_t *r1 = r0 + width;
+        const uint8_t *r2 = r1 + width;
+        const uint8_t *r3 = r2 + width;
+        for (int col = 0; col < width; col++) {
+            *dst++ = st75256_gray_level[r0[col]] | (st75256_gray_level[r1[col]] << 2) |
+                     (st75256_gray_level[r2[col]] << 4) | (st75256_gray_level[r3[col]] << 6);
+        }
+    }
+}
+
+/**
+ * 灰度打包（portrait）：每个 LVGL 行是一个硬件列，行内相邻 4 个像素就是同一页的 4 行，
+ * 因此直接按顺序打包，不需要转置。
+ *
+ * @param src       LVGL 显存指针：num_rows 行，每行 width 字节
+ * @param width     区域宽度（4 的倍数），对应硬件的 width / 4 页
+ * @param num_rows  区域高度，对应硬件的 num_rows 列
+ * @param dst       输出：每列 width / 4 字节，共 num_rows 列（竖向扫描先递增页地址）
+ */
+void st75256_pack_gray_rows(const uint8_t *src, int width, int num_rows, uint8_t *dst)
+{
+    const size_t count = (size_t)width * num_rows;
+    for (size_t i = 0; i < count; i += 4) {
+        *dst++ = st75256_gray_level[src[i]] | (st75256_gray_level[src[i + 1]] << 2) |
+                 (st75256_gray_level[src[i + 2]] << 4) | (st75256_gray_level[src[i + 3]] << 6);
+    }
+}
+
+/**
+ * LVGL v9 I1 格式：按行排列，每字节 8 个水平像素（bit7 在左），位为 1 表示亮色（像素不点亮）。
+ * ST75256 的位为 1 表示点亮，因此转换时取反。
+ *
+ * 横屏：每 8 行组成一页，8 行 x 8 列的块取反后转置：输入第 r 行字节的第 (7 - j) 位
+ * 是第 j 列，转置后落在第 (7 - j) 个字节的第 r 位，正好是第 j 列的页字节。
+ *
+ * @param src       I1 像素（不含调色板）：num_rows 行，每行 (width + 7) / 8 字节
+ * @param width     区域宽度（硬件列数，任意值）
+ * @param num_rows  区域高度（8 的倍数）
+ * @param dst       输出：num_rows / 8 页，每页 width 字节
+ */
+static inline __attribute__((always_inline)) void st75256_pack_i1_pages_impl(const uint8_t *src, int width, int num_rows, uint8_t *dst)
+{
+    const int stride = (width + 7) / 8;
+
+    for (int row = 0; row < num_rows; row += 8) {
+        const uint8_t *in = src + (size_t)row * stride;
+        for (int x = 0; x < width; x += 8) {
+            uint64_t block = 0;
+            for (int r = 0; r < 8; r++) {
+                block |= (uint64_t)(uint8_t)~in[r * stride + x / 8] << (r * 8);
+            }
+            if (block) {
+                block = st75256_transpose8x8(block);
+            }
+
+            int cols = width - x < 8 ? width - x : 8;
+            for (int j = 0; j < cols; j++) {
+                dst[x + j] = (uint8_t)(block >> ((7 - j) * 8));
+            }
+        }
+        dst += width;
+    }
+}
+
+void st75256_pack_i1_pages(const uint8_t *src, int width, int num_rows, uint8_t *dst)
+{
+    st75256_pack_i1_pages_impl(src, width, num_rows, dst);
+}
+
+/**
+ * I1 竖屏：每个 LVGL 行是一个硬件列，行内的字节已经是页字节，只需取反并把 bit7 在左
+ * 翻转为 bit0 在左（与单色模式的页内位序一致）。
+ *
+ * @param src       I1 像素（不含调色板）：num_rows 行，每行 width / 8 字节
+ * @param width     区域宽度（8 的倍数），对应硬件的 width / 8 页
+ * @param num_rows  区域高度，对应硬件的 num_rows 列
+ * @param dst       输出：每列 width / 8 字节，共 num_rows 列
+ */
+void st75256_pack_i1_rows(const uint8_t *src, int width, int num_rows, uint8_t *dst)
+{
+    const size_t count = (size_t)width / 8 * num_rows;
+    for (size_t i = 0; i < count; i++) {
+        uint8_t b = ~src[i];
+        b = (b >> 4) | (b << 4);
+        b = ((b & 0xCC) >> 2) | ((b & 0x33) << 2);
+        b = ((b & 0xAA) >> 1) | ((b & 0x55) << 1);
+        dst[i] = b;
+    }
+}
+
+/**
+ * 常见几何尺寸的专用内核：宽度是编译期常量，编译器可以展开块循环、把跨度折叠成立即数，
+ * 通用的尺寸支持因此不会拖慢 256x128 的热路径。新增尺寸只需在下表加一行。
+ * 竖屏的转置宽度是可见行数（128 / 160 / 208），横屏的 I1 打包宽度是列数（256）。
+ */
+#define ST75256_SPECIALIZE(kernel, w)                                                       \
+    static void kernel##_w##w(const uint8_t *src, int width, int num_rows, uint8_t *dst)    \
+    {                                                                                       \
+        (void)width;                                                                        \
+        kernel##_impl(src, w, num_rows, dst);                                               \
+    }
+
+ST75256_SPECIALIZE(st75256_remap_swapped, 128)
+ST75256_SPECIALIZE(st75256_remap_swapped, 160)
+ST75256_SPECIALIZE(st75256_remap_swapped, 208)
+ST75256_SPECIALIZE(st75256_pack_i1_pages, 256)
+
+static const struct {
+    st75256_kernel_fn_t kernel;
+    int width;
+    st75256_kernel_fn_t specialized;
+} st75256_specialized_kernels[] = {
+    {st75256_remap_swapped, 128, st75256_remap_swapped_w128},
+    {st75256_remap_swapped, 160, st75256_remap_swapped_w160},
+    {st75256_remap_swapped, 208, st75256_remap_swapped_w208},
+    {st75256_pack_i1_pages, 256, st75256_pack_i1_pages_w256},
+};
+
+st75256_kernel_fn_t st75256_kernel_for_width(st75256_kernel_fn_t kernel, int width)
+{
+    for (size_t i = 0; i < sizeof(st75256_specialized_kernels) / sizeof(st75256_specialized_kernels[0]); i++) {
+        if (st75256_specialized_kernels[i].kernel == kernel && st75256_specialized_kernels[i].width == width) {
+            return st75256_specialized_kernels[i].specialized;
+        }
+    }
+    return kernel;
+}
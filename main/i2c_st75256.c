@@ -13,6 +13,8 @@
 #include "lvgl.h"
 #include "ui.h"
 #include "esp_lcd_st75256.h"
+#include "esp_lcd_panel_io_st75256.h"
+#include "esp_lcd_st75256_lvgl.h"
 
 // 引入 benchmark 头文件
 #include "lv_demo_benchmark.h"
@@ -26,12 +28,44 @@ extern void example_lvgl_demo_ui(lv_disp_t *disp);
 #define LCD_H_RES 256
 #define LCD_V_RES 128
 
+// 1 = 四级灰度模式：需要在 menuconfig 中把 LV_COLOR_DEPTH 设为 8
+#define ST75256_GRAY_MODE   0
+
+// 单色 + LVGL 8：>0 时按 N 页（8N 行）的条带渲染，双缓冲共 2 * N * 256 字节，
+// 配合 async_flush，一条在总线上发送时 LVGL 渲染下一条；0 = 全屏缓冲
+#define ST75256_LVGL_STRIP_PAGES 0
+
+// 单色：LVGL 显示旋转 0..3（× 90°），由面板扫描方向完成，不做软件旋转
+#define ST75256_LVGL_ROTATION 0
+
+#if ST75256_GRAY_MODE && LVGL_VERSION_MAJOR >= 9
+#error "Gray mode takes LVGL 8 RGB332 color, LVGL 9 has no such format"
+#endif
+
 #define I2C_MASTER_SCL_IO    5        // SCL 引脚
 #define I2C_MASTER_SDA_IO    4        // SDA 引脚
 #define I2C_MASTER_FREQ_HZ   800000   // 800 kHz
 #define I2C_MASTER_TIMEOUT_MS 1000    // 超时时间
 #define I2C_MASTER_PORT      I2C_NUM_0    // I2C 端口号
 
+// 省电（0x95，显存保持）：连续这么多毫秒没有刷新即进入，下一次刷新自动唤醒；0 = 关闭
+#define ST75256_POWER_SAVE_IDLE_MS 0
+// 单色：按 LVGL 的输入无操作时间进入省电，有输入立即唤醒（LVGL 任务中每 200 ms 检查一次）；0 = 关闭
+#define ST75256_POWER_SAVE_INACTIVE_MS 0
+
+// 自适应帧频（扩展指令 0xF0 的帧频代码，见数据手册帧频表）：连续刷新（动画）时用 ACTIVE 减轻拖影，
+// 画面静止 500 ms 后回到 IDLE 省电；两者都为 0 = 保持控制器默认帧频
+#define ST75256_FRAME_RATE_ACTIVE 0
+#define ST75256_FRAME_RATE_IDLE   0
+
+// 总线上还有其他设备（传感器等）时，限制屏幕单次 I2C 传输占用总线的时间（微秒），如 2000；0 = 不限制
+#define ST75256_BUS_SHARE_US 0
+
+// 1 = 每秒以 CSV 格式打印总线统计（esp_lcd_panel_st75256_get_stats()），并按 400k/800k/1M SCL 估算总线上限帧率；
+// 这是示例唯一的统计输出，驱动自带的日志任务（stats_log_period_ms）保持关闭
+#define ST75256_STATS_CSV    0
+#define ST75256_STATS_PERIOD_MS 1000
+
 static const char *I2C_TAG = "I2C_BUS";              // 日志标签
 
 // 全局变量
@@ -67,28 +101,35 @@ static esp_err_t install_st75256_panel(i2c_master_bus_handle_t i2c_bus,
     assert(i2c_bus && panel_handle && io_handle);
     ESP_LOGI("ST75256", "Install ST75256 panel");
 
-    // 创建 Panel IO
-    esp_lcd_panel_io_i2c_config_t io_config = {
+    // 创建 Panel IO（ST75256 专用：命令、参数和像素数据合并为一次 I2C 传输）
+    esp_lcd_panel_io_st75256_config_t io_config = {
         .dev_addr = ST75256_I2C_ADDR,
         .scl_speed_hz = I2C_MASTER_FREQ_HZ,
-        .control_phase_bytes = 1,
-        .lcd_cmd_bits = 8,
-        .lcd_param_bits = 8,
-        .dc_bit_offset = 6,
-        .flags = {
-            .disable_control_phase = 0, // ST75256: 0x00=CMD, 0x40=DATA
-        },
     };
-    ESP_RETURN_ON_ERROR(esp_lcd_new_panel_io_i2c(i2c_bus, &io_config, io_handle), "ST75256", "install panel IO failed");
+    ESP_RETURN_ON_ERROR(esp_lcd_new_panel_io_st75256(i2c_bus, &io_config, io_handle), "ST75256", "install panel IO failed");
 
     // ST75256 专用配置（256x128 模式） （可选）
     esp_lcd_panel_st75256_config_t st75256_config = {
         .orientation = 0,  // 0 = 256 columns × 128 rows (landscape)
+        .geometry = {
+            .width = LCD_H_RES,   // 其他尺寸的模组（如 256x160）改 LCD_H_RES / LCD_V_RES，
+            .height = LCD_V_RES,  // 必要时再填 DDRAM 页数（ddram_pages）与列偏移（column_offset）
+        },
+        .flags.shadow_fb = 1, // 驱动保存一份显存副本，只发送变化的区域
+        .flags.async_flush = 1, // 后台任务发送，LVGL 可同时渲染下一帧（需要上面的专用 Panel IO）
+        .flags.gray_mode = ST75256_GRAY_MODE,
+        .bus_share_max_hold_us = ST75256_BUS_SHARE_US, // 像素数据按页切片发送，片间让出总线
+        .power_save_idle_ms = ST75256_POWER_SAVE_IDLE_MS,
+        .frame_rate = {
+            .active = ST75256_FRAME_RATE_ACTIVE,
+            .idle = ST75256_FRAME_RATE_IDLE,
+        },
+        // 其他厂家的玻璃：.init_cmds / .init_cmds_size 提供自己的初始化表（对比度、电源、占空比等，格式见 ESP_LCD_ST75256_INIT_DELAY）
     };
 
     // 安装面板驱动（关键：传入 vendor_config）
     esp_lcd_panel_dev_config_t panel_config = {
-        .bits_per_pixel = 1,
+        .bits_per_pixel = ST75256_GRAY_MODE ? 8 : 1,   // 灰度模式输入 LVGL 8 位色
         .reset_gpio_num = ST75256_PIN_NUM_RST,
         .vendor_config = &st75256_config,  // 指向ST75256 专用配置
     };
@@ -102,6 +143,65 @@ static esp_err_t install_st75256_panel(i2c_master_bus_handle_t i2c_bus,
     return ESP_OK;
 }
 
+#if ST75256_GRAY_MODE
+static void st75256_gray_rounder(lv_disp_drv_t *drv, lv_area_t *area)
+{
+    area->y1 &= ~0x03;
+    area->y2 |= 0x03;
+}
+#endif
+
+#if ST75256_STATS_CSV
+// 总线时间估算：每字节 9 个 SCL 周期（8 位 + ACK），每个事务另加约 2 个周期（START/STOP）
+static double st75256_bus_fps(uint32_t flushes, uint64_t wire_bytes, uint32_t transactions, uint32_t scl_hz)
+{
+    double bus_s = (double)(wire_bytes * 9 + transactions * 2) / scl_hz;
+    return bus_s > 0 ? flushes / bus_s : 0;
+}
+
+static void st75256_stats_task(void *arg)
+{
+    esp_lcd_panel_handle_t panel = arg;
+    esp_lcd_panel_st75256_stats_t last = {0};
+    esp_lcd_panel_st75256_get_stats(panel, &last);
+
+    printf("time_ms,flushes,transactions,pixel_bytes,cmd_bytes,overhead_bytes,fps_400k,fps_800k,fps_1m,flush_interval_ms,frame_rate\n");
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(ST75256_STATS_PERIOD_MS));
+        esp_lcd_panel_st75256_stats_t now;
+        esp_lcd_panel_st75256_get_stats(panel, &now);
+
+        uint32_t flushes = now.flushes - last.flushes;
+        uint32_t transactions = now.transactions - last.transactions;
+        uint64_t pixel = now.pixel_bytes_sent - last.pixel_bytes_sent;
+        uint64_t cmd = now.cmd_bytes - last.cmd_bytes;
+        uint64_t overhead = now.overhead_bytes - last.overhead_bytes;
+        uint64_t wire = pixel + cmd + overhead;
+        printf("%lld,%" PRIu32 ",%" PRIu32 ",%llu,%llu,%llu,%.1f,%.1f,%.1f,%.1f,0x%02x\n",
+               esp_timer_get_time() / 1000, flushes, transactions,
+               (unsigned long long)pixel, (unsigned long long)cmd, (unsigned long long)overhead,
+               st75256_bus_fps(flushes, wire, transactions, 400000),
+               st75256_bus_fps(flushes, wire, transactions, 800000),
+               st75256_bus_fps(flushes, wire, transactions, 1000000),
+               now.flush_interval_us / 1000.0, now.frame_rate);
+        last = now;
+    }
+}
+#endif
+
+#if ST75256_POWER_SAVE_INACTIVE_MS && !ST75256_GRAY_MODE
+// LVGL 任务中运行，输入设备由 esp_lvgl_port 注册，LVGL 记录最后一次输入的时间
+static void st75256_power_save_timer_cb(lv_timer_t *timer)
+{
+#if LVGL_VERSION_MAJOR >= 9
+    esp_lcd_panel_handle_t panel = lv_timer_get_user_data(timer);
+#else
+    esp_lcd_panel_handle_t panel = timer->user_data;
+#endif
+    esp_lcd_st75256_lvgl_power_save_update(panel, NULL, ST75256_POWER_SAVE_INACTIVE_MS);
+}
+#endif
+
 static lv_disp_t *initialize_lvgl_display(esp_lcd_panel_handle_t panel_handle,
                                           esp_lcd_panel_io_handle_t io_handle)
 {
@@ -126,14 +226,15 @@ static lv_disp_t *initialize_lvgl_display(esp_lcd_panel_handle_t panel_handle,
     // 配置显示参数
     //当 ST75256 以256x128模式工作时: hres = LCD_H_RES（256），vres = LCD_V_RES（128），swap_xy=false
     //当 ST75256 以128x256模式工作时: hres = LCD_V_RES（128），vres = LCD_H_RES（256），swap_xy=true
+#if ST75256_GRAY_MODE
     const lvgl_port_display_cfg_t disp_cfg = {
         .io_handle = io_handle,
         .panel_handle = panel_handle,
-        .buffer_size = LCD_H_RES * LCD_V_RES, // 1bpp
+        .buffer_size = LCD_H_RES * LCD_V_RES, // 8 位色，每像素 1 字节
         .double_buffer = true,
         .hres = LCD_H_RES,
         .vres = LCD_V_RES,
-        .monochrome = true,
+        .monochrome = false,
         .rotation = {
             .swap_xy = false,
             .mirror_x = false,
@@ -147,7 +248,44 @@ static lv_disp_t *initialize_lvgl_display(esp_lcd_panel_handle_t panel_handle,
         return NULL;
     }
 
-    lv_disp_set_rotation(disp, LV_DISP_ROT_NONE);
+    // 灰度模式下每页 4 行，刷新区域的 Y 需要按 4 对齐
+    disp->driver->rounder_cb = st75256_gray_rounder;
+#else
+    // 单色模式：由驱动注册显示设备，缓冲区按 1bpp 紧凑存放（全屏双缓冲共 8 KB），只刷新变化的页。
+    // LVGL 8 通过 set_px 直接渲染成 ST75256 的页格式；LVGL 9 以 I1 格式渲染，由驱动转换
+    const esp_lcd_st75256_lvgl_display_cfg_t disp_cfg = {
+        .io_handle = io_handle,
+        .panel_handle = panel_handle,
+        .hres = LCD_H_RES,
+        .vres = LCD_V_RES,
+        .buffer_size = LCD_H_RES * LCD_V_RES, // 像素数
+        .strip_pages = ST75256_LVGL_STRIP_PAGES,
+        .double_buffer = true,
+        .rotation = {
+            .mirror_x = false,
+            .mirror_y = false,
+        },
+    };
+
+    lvgl_port_lock(0);
+    lv_disp_t *disp = esp_lcd_st75256_lvgl_add_disp(&disp_cfg);
+    if (disp) {
+#if LVGL_VERSION_MAJOR >= 9
+        lv_display_set_rotation(disp, ST75256_LVGL_ROTATION);
+#else
+        lv_disp_set_rotation(disp, ST75256_LVGL_ROTATION);
+#endif
+#if ST75256_POWER_SAVE_INACTIVE_MS
+        lv_timer_create(st75256_power_save_timer_cb, 200, panel_handle);
+#endif
+    }
+    lvgl_port_unlock();
+    if (!disp) {
+        ESP_LOGE("LVGL", "Failed to add display to LVGL");
+        return NULL;
+    }
+#endif
+
     return disp;
 }
 
@@ -200,6 +338,10 @@ void app_main(void)
         return;
     }
     
+#if ST75256_STATS_CSV
+    xTaskCreate(st75256_stats_task, "st75256_stats", 3072, panel_handle, 1, NULL);
+#endif
+
     // 启动 LVGL UI 示例
     ESP_LOGI("LVGL", "Start LVGL demo");
     
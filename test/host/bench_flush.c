@@ -0,0 +1,277 @@
+/*
+ * Bus traffic of lv_demo_benchmark-like scenes through the real LVGL flush path
+ *
+ * Every scene renders through esp_lcd_st75256_lvgl_add_disp() into the driver on a
+ * recording IO, for each driver mode: panel IO, landscape/portrait, full or partial
+ * refresh, with and without the shadow framebuffer diff. One CSV row per scene and
+ * mode on stdout, with the FPS the bus allows at 400 kHz, 800 kHz and 1 MHz SCL.
+ * The list_page scenes scroll the same list by a page per frame, once re-rendered
+ * and once with esp_lcd_panel_st75256_set_scroll() (landscape only).
+ *
+ *     bench_flush [frames]
+ */
+#include <inttypes.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+#include "esp_lcd_st75256_lvgl.h"
+#include "host_test.h"
+
+#define DEFAULT_FRAMES 60
+
+typedef struct {
+    int w;                    // LVGL resolution
+    int h;
+    int frame;
+} scene_ctx_t;
+
+typedef struct {
+    const char *name;
+    host_lvgl_pixel_cb_t pixel;
+    // Area LVGL invalidates between frame - 1 and frame in partial refresh, inclusive
+    void (*dirty)(const scene_ctx_t *ctx, lv_area_t *area);
+    int scroll_rows;          // Display start line moved before each frame, 0 = none
+} scene_t;
+
+// 5x7 glyphs in 6x10 cells, the character picked from the cell and a seed
+static int glyph_pixel(int x, int y, uint32_t seed)
+{
+    int cx = x % 6;
+    int cy = y % 10;
+    if (cx >= 5 || cy >= 7) {
+        return 0;
+    }
+    uint64_t code = ((uint64_t)(x / 6) * 0x9E3779B97F4A7C15ULL) ^ ((uint64_t)(y / 10) * 0xC2B2AE3D27D4EB4FULL) ^ (seed * 0x165667B19E3779F9ULL);
+    code ^= code >> 29;
+    code *= 0xBF58476D1CE4E5B9ULL;
+    code ^= code >> 32;
+    return (code >> (cx + 5 * cy)) & 1;
+}
+
+static void dirty_all(const scene_ctx_t *ctx, lv_area_t *area)
+{
+    *area = (lv_area_t) {0, 0, ctx->w - 1, ctx->h - 1};
+}
+
+// A screen of text LVGL redraws unchanged, e.g. a label set to the same string
+static int text_static_pixel(int x, int y, void *arg)
+{
+    return glyph_pixel(x, y, 1);
+}
+
+// A 6 digit counter in the top left corner
+#define COUNTER_X 8
+#define COUNTER_Y 8
+
+static int counter_pixel(int x, int y, void *arg)
+{
+    const scene_ctx_t *ctx = arg;
+    if (x < COUNTER_X || x >= COUNTER_X + 36 || y < COUNTER_Y || y >= COUNTER_Y + 10) {
+        return glyph_pixel(x, y, 2);
+    }
+    return glyph_pixel(x - COUNTER_X, y - COUNTER_Y, 100 + ctx->frame);
+}
+
+static void counter_dirty(const scene_ctx_t *ctx, lv_area_t *area)
+{
+    *area = (lv_area_t) {COUNTER_X, COUNTER_Y, COUNTER_X + 35, COUNTER_Y + 9};
+}
+
+// A 32x24 box moving across the screen
+#define RECT_W 32
+#define RECT_H 24
+
+static int rect_x(const scene_ctx_t *ctx, int frame)
+{
+    return (frame * 5) % (ctx->w - RECT_W);
+}
+
+static int rect_move_pixel(int x, int y, void *arg)
+{
+    const scene_ctx_t *ctx = arg;
+    int x0 = rect_x(ctx, ctx->frame);
+    int y0 = ctx->h / 3;
+    return x >= x0 && x < x0 + RECT_W && y >= y0 && y < y0 + RECT_H;
+}
+
+static void rect_move_dirty(const scene_ctx_t *ctx, lv_area_t *area)
+{
+    int old_x = rect_x(ctx, ctx->frame - 1);
+    int new_x = rect_x(ctx, ctx->frame);
+    *area = (lv_area_t) {MIN(old_x, new_x), ctx->h / 3, MAX(old_x, new_x) + RECT_W - 1, ctx->h / 3 + RECT_H - 1};
+}
+
+// A progress bar along the bottom filling up
+static int progress_pixel(int x, int y, void *arg)
+{
+    const scene_ctx_t *ctx = arg;
+    int bar_w = ctx->w - 16;
+    if (x < 8 || x >= 8 + bar_w || y < ctx->h - 12 || y >= ctx->h - 4) {
+        return 0;
+    }
+    int filled = (ctx->frame * 3) % (bar_w + 1);
+    bool border = y == ctx->h - 12 || y == ctx->h - 5 || x == 8 || x == 7 + bar_w;
+    return border || x - 8 < filled;
+}
+
+static void progress_dirty(const scene_ctx_t *ctx, lv_area_t *area)
+{
+    *area = (lv_area_t) {8, ctx->h - 12, ctx->w - 9, ctx->h - 5};
+}
+
+// A text list scrolled by 3 pixels per frame, without the hardware start line
+static int list_scroll_pixel(int x, int y, void *arg)
+{
+    const scene_ctx_t *ctx = arg;
+    return glyph_pixel(x, y + ctx->frame * 3, 3);
+}
+
+// A text list scrolled by a page per frame: re-rendered, or moved with the start line and only the page
+// scrolled in drawn
+#define LIST_PAGE_ROWS 8
+
+static int list_page_pixel(int x, int y, void *arg)
+{
+    const scene_ctx_t *ctx = arg;
+    return glyph_pixel(x, y + ctx->frame * LIST_PAGE_ROWS, 3);
+}
+
+static void list_page_hw_dirty(const scene_ctx_t *ctx, lv_area_t *area)
+{
+    *area = (lv_area_t) {0, ctx->h - LIST_PAGE_ROWS, ctx->w - 1, ctx->h - 1};
+}
+
+// Full screen 8x8 checkerboard changing phase every frame: every pixel byte differs
+static int checker_flip_pixel(int x, int y, void *arg)
+{
+    const scene_ctx_t *ctx = arg;
+    return ((x / 8 + y / 8 + ctx->frame) & 1);
+}
+
+static const scene_t s_scenes[] = {
+    {"text_static", text_static_pixel, dirty_all},
+    {"counter", counter_pixel, counter_dirty},
+    {"rect_move", rect_move_pixel, rect_move_dirty},
+    {"progress", progress_pixel, progress_dirty},
+    {"list_scroll", list_scroll_pixel, dirty_all},
+    {"list_page", list_page_pixel, dirty_all},
+    {"list_page_hw", list_page_pixel, list_page_hw_dirty, LIST_PAGE_ROWS},
+    {"checker_flip", checker_flip_pixel, dirty_all},
+};
+
+typedef struct {
+    bool stream_io;
+    bool portrait;
+    bool full_refresh;
+    bool shadow_fb;
+} bench_mode_t;
+
+// Same estimate as the example's CSV report: 9 SCL clocks per byte (8 bits + ACK), about 2 more per START/STOP
+static double bus_fps(int frames, uint64_t wire_bytes, uint32_t transactions, uint32_t scl_hz)
+{
+    double bus_s = (double)(wire_bytes * 9 + transactions * 2) / scl_hz;
+    return bus_s > 0 ? frames / bus_s : INFINITY;
+}
+
+static void bench_scene(const scene_t *scene, const bench_mode_t *mode, int frames)
+{
+    if (scene->scroll_rows && mode->portrait) {
+        return;               // The start line only scrolls landscape
+    }
+    host_panel_config_t config = {
+        .stream_io = mode->stream_io,
+        .config.flags.shadow_fb = mode->shadow_fb,
+    };
+    host_panel_t *hp = host_panel_new(&config);
+    scene_ctx_t ctx = {
+        .w = mode->portrait ? 128 : 256,
+        .h = mode->portrait ? 256 : 128,
+    };
+    const esp_lcd_st75256_lvgl_display_cfg_t disp_cfg = {
+        .io_handle = hp->io,
+        .panel_handle = hp->panel,
+        .hres = ctx.w,
+        .vres = ctx.h,
+        .buffer_size = ctx.w * ctx.h,
+    };
+    lv_disp_t *disp = esp_lcd_st75256_lvgl_add_disp(&disp_cfg);
+    TEST_ASSERT(disp);
+
+    // The first frame fills the screen (and the shadow), only the frames after it are counted
+    lv_area_t area;
+    dirty_all(&ctx, &area);
+    host_lvgl_refresh(disp, &area, scene->pixel, &ctx);
+    host_lvgl_wait_flush(disp);
+    TEST_ESP_OK(esp_lcd_panel_st75256_reset_stats(hp->panel));
+    if (hp->bus) {
+        mock_i2c_bus_clear(hp->bus);
+    }
+    int line = 0;
+    for (ctx.frame = 1; ctx.frame <= frames; ctx.frame++) {
+        if (scene->scroll_rows) {
+            line = (line + scene->scroll_rows) % ESP_LCD_ST75256_SCROLL_LINES;
+            TEST_ESP_OK(esp_lcd_panel_st75256_set_scroll(hp->panel, line));
+        }
+        if (mode->full_refresh) {
+            dirty_all(&ctx, &area);
+        } else {
+            scene->dirty(&ctx, &area);
+        }
+        host_lvgl_refresh(disp, &area, scene->pixel, &ctx);
+        host_lvgl_wait_flush(disp);
+    }
+
+    // The glass shows the last frame whatever the mode, scrolled or not
+    ctx.frame = frames;
+    uint8_t *expected = malloc(ctx.w * ctx.h);
+    TEST_ASSERT(expected);
+    for (int y = 0; y < ctx.h; y++) {
+        for (int x = 0; x < ctx.w; x++) {
+            expected[y * ctx.w + x] = scene->pixel(x, y, &ctx);
+        }
+    }
+    const host_orient_t orient = {.swap_xy = mode->portrait};
+    TEST_ASSERT_EQUAL(0, host_check_glass(hp, &orient, 0, 0, expected, ctx.w, ctx.h));
+    free(expected);
+
+    esp_lcd_panel_st75256_stats_t stats;
+    TEST_ESP_OK(esp_lcd_panel_st75256_get_stats(hp->panel, &stats));
+    uint64_t wire = stats.pixel_bytes_sent + stats.cmd_bytes + stats.overhead_bytes;
+    if (hp->bus) {
+        // The driver's accounting matches what the bus carried, address bytes included
+        TEST_ASSERT_EQUAL(hp->bus->log_len, stats.transactions);
+        TEST_ASSERT_EQUAL(hp->bus->bytes_len + hp->bus->log_len, wire);
+    }
+    printf("%s,%s,%s,%s,%s,%d,%" PRIu32 ",%" PRIu32 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%.1f,%.1f,%.1f\n",
+           scene->name, mode->stream_io ? "stream" : "generic", mode->portrait ? "portrait" : "landscape",
+           mode->full_refresh ? "full" : "partial", mode->shadow_fb ? "shadow" : "none", frames,
+           stats.flushes, stats.transactions, stats.pixel_bytes_sent, stats.pixel_bytes_saved, stats.cmd_bytes, stats.overhead_bytes,
+           bus_fps(frames, wire, stats.transactions, 400000), bus_fps(frames, wire, stats.transactions, 800000),
+           bus_fps(frames, wire, stats.transactions, 1000000));
+
+    TEST_ESP_OK(esp_lcd_st75256_lvgl_remove_disp(disp));
+    host_panel_del(hp);
+}
+
+int main(int argc, char **argv)
+{
+    int frames = argc > 1 ? atoi(argv[1]) : DEFAULT_FRAMES;
+    if (frames <= 0) {
+        fprintf(stderr, "usage: %s [frames]\n", argv[0]);
+        return 2;
+    }
+    printf("scene,io,orientation,refresh,diff,frames,flushes,transactions,pixel_bytes,pixel_bytes_saved,cmd_bytes,overhead_bytes,fps_400k,fps_800k,fps_1m\n");
+    for (size_t i = 0; i < sizeof(s_scenes) / sizeof(s_scenes[0]); i++) {
+        for (int m = 0; m < 16; m++) {
+            const bench_mode_t mode = {
+                .stream_io = m & 8,
+                .portrait = m & 4,
+                .full_refresh = m & 2,
+                .shadow_fb = m & 1,
+            };
+            bench_scene(&s_scenes[i], &mode, frames);
+        }
+    }
+    return 0;
+}
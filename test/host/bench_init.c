@@ -0,0 +1,133 @@
+/*
+ * Bus traffic of esp_lcd_panel_init() and of clearing the screen
+ *
+ * For each panel IO, counts the transactions and wire bytes (address and
+ * control bytes included) of a re-init, of the baseline driver's DDRAM clear
+ * (one tx_color per byte, 16 pages of 256 columns) replayed on the same IO, and
+ * of esp_lcd_panel_st75256_fill_rect() over the same 16 pages. One CSV row each
+ * on stdout, with the bus time at 400 kHz and 1 MHz SCL.
+ */
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+
+#define SCREEN_W     256
+#define SCREEN_H     128
+
+typedef struct {
+    uint32_t transactions;
+    uint64_t wire_bytes;
+} traffic_t;
+
+static void traffic_clear(host_panel_t *hp)
+{
+    if (hp->bus) {
+        mock_i2c_bus_clear(hp->bus);
+    } else {
+        mock_panel_io_clear(hp->io);
+    }
+}
+
+// Stream IO: the address and what follows it. Generic IO: the address, a control byte and the command, a
+// control byte and the payload.
+static traffic_t traffic_get(host_panel_t *hp)
+{
+    traffic_t traffic = {0};
+    if (hp->bus) {
+        traffic.transactions = hp->bus->log_len;
+        traffic.wire_bytes = hp->bus->bytes_len + hp->bus->log_len;
+        return traffic;
+    }
+    const mock_panel_io_t *io = mock_panel_io_get(hp->io);
+    traffic.transactions = io->log_len;
+    for (size_t i = 0; i < io->log_len; i++) {
+        const mock_panel_io_trans_t *trans = &io->log[i];
+        traffic.wire_bytes += 1 + (trans->cmd >= 0 ? 2 : 0) + (trans->size ? 1 + trans->size : 0);
+    }
+    return traffic;
+}
+
+// Same estimate as bench_flush: 9 SCL clocks per byte (8 bits + ACK), about 2 more per START/STOP
+static double bus_ms(const traffic_t *traffic, uint32_t scl_hz)
+{
+    return (double)(traffic->wire_bytes * 9 + traffic->transactions * 2) * 1000 / scl_hz;
+}
+
+// Step 14 of the baseline panel_st75256_init(), byte for byte
+static void baseline_clear(esp_lcd_panel_io_handle_t io)
+{
+    TEST_ESP_OK(esp_lcd_panel_io_tx_param(io, 0x30, NULL, 0));
+    TEST_ESP_OK(esp_lcd_panel_io_tx_param(io, 0x15, NULL, 0));
+    TEST_ESP_OK(esp_lcd_panel_io_tx_color(io, -1, (const uint8_t[]) {0, 255}, 2));
+    TEST_ESP_OK(esp_lcd_panel_io_tx_param(io, 0x75, NULL, 0));
+    TEST_ESP_OK(esp_lcd_panel_io_tx_color(io, -1, (const uint8_t[]) {0, 40}, 2));
+    TEST_ESP_OK(esp_lcd_panel_io_tx_param(io, 0x5C, NULL, 0));
+    static const uint8_t zero_byte = 0x00;
+    for (size_t i = 0; i < SCREEN_W * 16; i++) {
+        TEST_ESP_OK(esp_lcd_panel_io_tx_color(io, -1, &zero_byte, 1));
+    }
+}
+
+// Fill the screen with noise, so each clear has something to clear
+static void draw_noise(host_panel_t *hp, uint32_t seed)
+{
+    uint8_t *image = host_random_image(SCREEN_W, SCREEN_H, seed);
+    uint8_t *pages = host_pack_lvgl_pages(image, SCREEN_W, SCREEN_H);
+    TEST_ESP_OK(esp_lcd_panel_draw_bitmap(hp->panel, 0, 0, SCREEN_W, SCREEN_H, pages));
+    free(pages);
+    free(image);
+}
+
+static void expect_blank(const host_panel_t *hp)
+{
+    static uint8_t blank[SCREEN_W * SCREEN_H];
+    const host_orient_t orient = {0};
+    TEST_ASSERT_EQUAL(0, host_check_glass(hp, &orient, 0, 0, blank, SCREEN_W, SCREEN_H));
+}
+
+static void report(const char *io, const char *step, const traffic_t *traffic)
+{
+    printf("%s,%s,%" PRIu32 ",%" PRIu64 ",%.2f,%.2f\n", io, step, traffic->transactions, traffic->wire_bytes,
+           bus_ms(traffic, 400000), bus_ms(traffic, 1000000));
+}
+
+static void bench_io(bool stream_io)
+{
+    const char *io = stream_io ? "stream" : "generic";
+    host_panel_config_t config = {.stream_io = stream_io};
+    host_panel_t *hp = host_panel_new(&config);
+
+    draw_noise(hp, 1);
+    traffic_clear(hp);
+    TEST_ESP_OK(esp_lcd_panel_init(hp->panel));
+    traffic_t init = traffic_get(hp);
+    expect_blank(hp);
+
+    draw_noise(hp, 2);
+    traffic_clear(hp);
+    baseline_clear(hp->io);
+    traffic_t baseline = traffic_get(hp);
+    expect_blank(hp);
+
+    // The baseline clear went around the driver, which no longer knows the controller state
+    TEST_ESP_OK(esp_lcd_panel_init(hp->panel));
+    draw_noise(hp, 3);
+    traffic_clear(hp);
+    TEST_ESP_OK(esp_lcd_panel_st75256_fill_rect(hp->panel, 0, 0, SCREEN_W, SCREEN_H, 0x00));
+    traffic_t fill = traffic_get(hp);
+    expect_blank(hp);
+
+    report(io, "init", &init);
+    report(io, "clear_baseline", &baseline);
+    report(io, "clear_fill_rect", &fill);
+    host_panel_del(hp);
+}
+
+int main(void)
+{
+    printf("io,step,transactions,wire_bytes,bus_ms_400k,bus_ms_1m\n");
+    bench_io(false);
+    bench_io(true);
+    return 0;
+}
@@ -0,0 +1,187 @@
+/*
+ * Portrait remap kernel: the 8x8 block transpose against the bit-by-bit loop it
+ * replaced, on blank, text and checkerboard frames. Checks the output is bit exact
+ * first (random frames too), then prints one CSV row per frame and kernel.
+ *
+ *     bench_kernels [iterations]
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "st75256_kernels.h"
+
+#define FRAME_W 128           // Portrait 128x256: LVGL pages of 128 bytes, 32 of them
+#define FRAME_H 256
+#define FRAME_SIZE (FRAME_W * FRAME_H / 8)
+#define DEFAULT_ITERATIONS 2000
+
+/**
+ * The original bitwise kernel, kept as the reference: one full portrait frame,
+ * destination cleared by the caller, bits set one at a time, zero bytes skipped
+ */
+static void old_remap_swapped_frame(uint8_t *src, uint8_t *dst)
+{
+    for (int page = 0; page < 32; page++) {
+        for (int x = 0; x < 128; x++) {
+            uint8_t src_byte = src[x + page * 128];
+            if (src_byte == 0) {
+                continue;
+            }
+            for (int bit = 0; bit < 8; bit++) {
+                if (src_byte & (1 << bit)) {
+                    int lvgl_y = page * 8 + bit;
+                    int dst_byte = lvgl_y * 16 + x / 8;
+                    if (dst_byte < 0 || dst_byte >= 16 * 256) {
+                        continue;
+                    }
+                    dst[dst_byte] |= (1 << (x % 8));
+                }
+            }
+        }
+    }
+}
+
+// The old call site cleared the 4 KB buffer before every remap
+static void old_kernel(const uint8_t *src, int width, int height, uint8_t *dst)
+{
+    memset(dst, 0, FRAME_SIZE);
+    old_remap_swapped_frame((uint8_t *)src, dst);
+}
+
+typedef struct {
+    const char *name;
+    st75256_kernel_fn_t fn;
+} kernel_t;
+
+static uint32_t s_seed = 1;
+
+static uint8_t next_random(void)
+{
+    s_seed ^= s_seed << 13;
+    s_seed ^= s_seed >> 17;
+    s_seed ^= s_seed << 5;
+    return (uint8_t)s_seed;
+}
+
+static void frame_blank(uint8_t *frame)
+{
+    memset(frame, 0, FRAME_SIZE);
+}
+
+// Lines of 5x7 glyphs in 6x10 cells: mostly blank bytes, sparse bits
+static void frame_text(uint8_t *frame)
+{
+    memset(frame, 0, FRAME_SIZE);
+    for (int y = 0; y < FRAME_H; y++) {
+        for (int x = 0; x < FRAME_W; x++) {
+            if (x % 6 < 5 && y % 10 < 7 && (next_random() & 3) == 0) {
+                frame[(y / 8) * FRAME_W + x] |= 1 << (y % 8);
+            }
+        }
+    }
+}
+
+// 1x1 checkerboard: every byte 0x55 or 0xAA, every bit of the old loop is set
+static void frame_checkerboard(uint8_t *frame)
+{
+    for (int i = 0; i < FRAME_SIZE; i++) {
+        frame[i] = (i % FRAME_W) & 1 ? 0xAA : 0x55;
+    }
+}
+
+static void frame_random(uint8_t *frame)
+{
+    for (int i = 0; i < FRAME_SIZE; i++) {
+        frame[i] = next_random();
+    }
+}
+
+static const struct {
+    const char *name;
+    void (*fill)(uint8_t *frame);
+} s_frames[] = {
+    {"blank", frame_blank},
+    {"text", frame_text},
+    {"checkerboard", frame_checkerboard},
+};
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static int check_exact(const kernel_t *kernel, const uint8_t *frame, const char *frame_name)
+{
+    static uint8_t expected[FRAME_SIZE];
+    static uint8_t actual[FRAME_SIZE];
+    old_kernel(frame, FRAME_W, FRAME_H, expected);
+    memset(actual, 0xA5, sizeof(actual)); // The new kernels must write every byte
+    kernel->fn(frame, FRAME_W, FRAME_H, actual);
+    for (int i = 0; i < FRAME_SIZE; i++) {
+        if (actual[i] != expected[i]) {
+            fprintf(stderr, "%s differs on %s frame at byte %d: 0x%02x, expected 0x%02x\n",
+                    kernel->name, frame_name, i, actual[i], expected[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : DEFAULT_ITERATIONS;
+    if (iterations <= 0) {
+        fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return 2;
+    }
+    const kernel_t kernels[] = {
+        {"old_bitwise", old_kernel},
+        {"transpose", st75256_remap_swapped},
+        {"transpose_w128", st75256_kernel_for_width(st75256_remap_swapped, FRAME_W)},
+    };
+    const size_t num_kernels = sizeof(kernels) / sizeof(kernels[0]);
+    static uint8_t frame[FRAME_SIZE];
+    static uint8_t dst[FRAME_SIZE];
+
+    int failures = 0;
+    for (size_t k = 1; k < num_kernels; k++) {
+        for (size_t f = 0; f < sizeof(s_frames) / sizeof(s_frames[0]); f++) {
+            s_frames[f].fill(frame);
+            failures += check_exact(&kernels[k], frame, s_frames[f].name);
+        }
+        for (int i = 0; i < 100; i++) {
+            frame_random(frame);
+            failures += check_exact(&kernels[k], frame, "random");
+        }
+    }
+    if (failures) {
+        return 1;
+    }
+
+    printf("frame,kernel,iterations,ns_per_frame,speedup\n");
+    uint32_t sink = 0;
+    for (size_t f = 0; f < sizeof(s_frames) / sizeof(s_frames[0]); f++) {
+        s_frames[f].fill(frame);
+        double old_ns = 0;
+        for (size_t k = 0; k < num_kernels; k++) {
+            kernels[k].fn(frame, FRAME_W, FRAME_H, dst); // Warm up the caches
+            int64_t start = now_ns();
+            for (int i = 0; i < iterations; i++) {
+                kernels[k].fn(frame, FRAME_W, FRAME_H, dst);
+                sink += dst[i % FRAME_SIZE];
+            }
+            double ns = (double)(now_ns() - start) / iterations;
+            if (k == 0) {
+                old_ns = ns;
+            }
+            printf("%s,%s,%d,%.0f,%.2f\n", s_frames[f].name, kernels[k].name, iterations, ns, old_ns / ns);
+        }
+    }
+    // Keeps the kernel calls from being optimized away
+    fprintf(stderr, "checksum %" PRIu32 "\n", sink);
+    return 0;
+}
@@ -0,0 +1,155 @@
+/*
+ * Case runner and panel fixture shared by the host tests, see host_test.h
+ */
+#include <stdarg.h>
+#include <string.h>
+#include "esp_lcd_panel_io_st75256.h"
+#include "host_test.h"
+
+#define HOST_TEST_I2C_ADDRESS 0x3C
+
+static const char *s_current_case;
+
+void host_test_fail(const char *file, int line, const char *fmt, ...)
+{
+    va_list args;
+    fprintf(stderr, "%s:%d: %s: FAIL: ", file, line, s_current_case ? s_current_case : "?");
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+    fputc('\n', stderr);
+    exit(1);
+}
+
+int host_test_main(int argc, char **argv, const host_test_case_t *cases, size_t num_cases)
+{
+    bool found = false;
+    for (size_t i = 0; i < num_cases; i++) {
+        if (argc > 1 && strcmp(argv[1], cases[i].name)) {
+            continue;
+        }
+        found = true;
+        s_current_case = cases[i].name;
+        printf("%s ... ", cases[i].name);
+        fflush(stdout);
+        cases[i].run();
+        printf("ok\n");
+    }
+    if (!found) {
+        fprintf(stderr, "no test case named %s\n", argv[1]);
+        return 2;
+    }
+    return 0;
+}
+
+host_panel_t *host_panel_new(const host_panel_config_t *config)
+{
+    host_panel_t *hp = calloc(1, sizeof(host_panel_t));
+    TEST_ASSERT(hp);
+    hp->config = config->config;
+    const esp_lcd_panel_st75256_geometry_t *geometry = &config->config.geometry;
+    st75256_model_init(&hp->model, geometry->width ? geometry->width : 256, geometry->height ? geometry->height : 128,
+                       geometry->ddram_pages ? geometry->ddram_pages : 21, geometry->column_offset);
+    uint32_t scl_speed_hz = config->scl_speed_hz ? config->scl_speed_hz : 400000;
+    if (config->stream_io) {
+        hp->bus = mock_i2c_bus_new(&hp->model);
+        TEST_ASSERT(hp->bus);
+        esp_lcd_panel_io_st75256_config_t io_config = {
+            .dev_addr = HOST_TEST_I2C_ADDRESS,
+            .scl_speed_hz = scl_speed_hz,
+        };
+        TEST_ESP_OK(esp_lcd_new_panel_io_st75256(hp->bus, &io_config, &hp->io));
+    } else {
+        TEST_ESP_OK(mock_panel_io_new(&hp->model, scl_speed_hz, &hp->io));
+    }
+    esp_lcd_panel_dev_config_t panel_config = {
+        .reset_gpio_num = -1,
+        .bits_per_pixel = config->bits_per_pixel ? config->bits_per_pixel : 1,
+        .vendor_config = &hp->config,
+    };
+    TEST_ESP_OK(esp_lcd_new_panel_st75256(hp->io, &panel_config, &hp->panel));
+    TEST_ESP_OK(esp_lcd_panel_reset(hp->panel));
+    TEST_ESP_OK(esp_lcd_panel_init(hp->panel));
+    TEST_ESP_OK(esp_lcd_panel_disp_on_off(hp->panel, true));
+    return hp;
+}
+
+void host_panel_del(host_panel_t *hp)
+{
+    TEST_ESP_OK(esp_lcd_panel_del(hp->panel));
+    TEST_ESP_OK(esp_lcd_panel_io_del(hp->io));
+    if (hp->bus) {
+        mock_i2c_bus_del(hp->bus);
+    }
+    st75256_model_deinit(&hp->model);
+    free(hp);
+}
+
+void host_panel_orient(host_panel_t *hp, const host_orient_t *orient)
+{
+    TEST_ESP_OK(esp_lcd_panel_swap_xy(hp->panel, orient->swap_xy));
+    TEST_ESP_OK(esp_lcd_panel_mirror(hp->panel, orient->mirror_x, orient->mirror_y));
+    TEST_ESP_OK(esp_lcd_panel_set_gap(hp->panel, orient->x_gap, orient->y_gap));
+}
+
+void host_lvgl_to_glass(const host_panel_t *hp, const host_orient_t *orient, int x, int y, int *glass_x, int *glass_y)
+{
+    // Hardware columns and rows: swap_xy runs LVGL X along the rows
+    int col = orient->swap_xy ? y : x;
+    int row = orient->swap_xy ? x : y;
+    bool col_mirror = orient->swap_xy ? orient->mirror_y : orient->mirror_x;
+    bool row_mirror = orient->swap_xy ? orient->mirror_x : orient->mirror_y;
+    col += orient->swap_xy ? orient->y_gap : orient->x_gap;
+    row += orient->swap_xy ? orient->x_gap : orient->y_gap;
+    *glass_x = col_mirror ? hp->model.width - 1 - col : col;
+    *glass_y = row_mirror ? hp->model.height - 1 - row : row;
+}
+
+uint8_t *host_pack_lvgl_pages(const uint8_t *image, int w, int h)
+{
+    uint8_t *buf = calloc(1, w * h / 8);
+    TEST_ASSERT(buf);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            if (image[y * w + x]) {
+                buf[(y / 8) * w + x] |= 1 << (y % 8);
+            }
+        }
+    }
+    return buf;
+}
+
+uint8_t *host_random_image(int w, int h, uint32_t seed)
+{
+    uint8_t *image = malloc(w * h);
+    TEST_ASSERT(image);
+    uint32_t state = seed ? seed : 1;
+    for (int i = 0; i < w * h; i++) {
+        // xorshift32
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        image[i] = state & 0x01;
+    }
+    return image;
+}
+
+int host_check_glass(const host_panel_t *hp, const host_orient_t *orient, int x0, int y0, const uint8_t *image, int w, int h)
+{
+    int mismatches = 0;
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            int gx;
+            int gy;
+            host_lvgl_to_glass(hp, orient, x0 + x, y0 + y, &gx, &gy);
+            int shown = st75256_model_pixel(&hp->model, gx, gy);
+            if (shown != image[y * w + x]) {
+                if (mismatches++ < 8) {
+                    fprintf(stderr, "  lvgl (%d,%d) -> glass (%d,%d): expected %d, shows %d\n",
+                            x0 + x, y0 + y, gx, gy, image[y * w + x], shown);
+                }
+            }
+        }
+    }
+    return mismatches;
+}
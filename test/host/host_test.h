@@ -0,0 +1,134 @@
+/*
+ * Case runner and panel fixture shared by the host tests
+ *
+ * Each test program holds a table of cases. Run with a case name to run that
+ * case alone (ctest registers one test per case), without to run them all.
+ * Assertions print the failing expression and end the program.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_lcd_st75256.h"
+#include "mock_i2c_bus.h"
+#include "mock_panel_io.h"
+#include "st75256_model.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    const char *name;
+    void (*run)(void);
+} host_test_case_t;
+
+#define HOST_TEST_CASE(fn) {#fn, fn}
+
+/**
+ * @brief Run the case named in argv[1], or all cases
+ *
+ * @return Exit code: 0 if every case ran, 2 if no case has that name
+ */
+int host_test_main(int argc, char **argv, const host_test_case_t *cases, size_t num_cases);
+
+void host_test_fail(const char *file, int line, const char *fmt, ...) __attribute__((noreturn, format(printf, 3, 4)));
+
+#define TEST_ASSERT(cond) do {                                                           \
+        if (!(cond)) {                                                                   \
+            host_test_fail(__FILE__, __LINE__, "%s", #cond);                             \
+        }                                                                                \
+    } while (0)
+
+#define TEST_ASSERT_EQUAL(expected, actual) do {                                         \
+        long long expected_ = (long long)(expected);                                     \
+        long long actual_ = (long long)(actual);                                         \
+        if (expected_ != actual_) {                                                      \
+            host_test_fail(__FILE__, __LINE__, "%s == %s: expected %lld, got %lld",      \
+                           #expected, #actual, expected_, actual_);                      \
+        }                                                                                \
+    } while (0)
+
+#define TEST_ESP_OK(x) TEST_ASSERT_EQUAL(ESP_OK, (x))
+
+/**
+ * @brief Panel under test: the driver on a mock IO feeding a controller model
+ */
+typedef struct {
+    st75256_model_t model;
+    mock_i2c_bus_t *bus;      // Stream IO only, NULL with the generic IO
+    esp_lcd_panel_io_handle_t io;
+    esp_lcd_panel_handle_t panel;
+    esp_lcd_panel_st75256_config_t config;
+} host_panel_t;
+
+typedef struct {
+    bool stream_io;           // esp_lcd_new_panel_io_st75256() on a mock bus instead of the generic mock IO
+    uint32_t scl_speed_hz;    // 0 = 400 kHz
+    esp_lcd_panel_st75256_config_t config;
+    uint32_t bits_per_pixel;  // 0 = 1, or 8 in gray mode
+} host_panel_config_t;
+
+/**
+ * @brief Create, reset and init a panel and turn the display on
+ */
+host_panel_t *host_panel_new(const host_panel_config_t *config);
+
+/**
+ * @brief Delete the panel, its IO and the bus
+ */
+void host_panel_del(host_panel_t *hp);
+
+/**
+ * @brief Orientation and gap a test set on the panel
+ */
+typedef struct {
+    bool swap_xy;
+    bool mirror_x;
+    bool mirror_y;
+    int x_gap;
+    int y_gap;
+} host_orient_t;
+
+/**
+ * @brief Set swap_xy, mirror and gap on the panel
+ */
+void host_panel_orient(host_panel_t *hp, const host_orient_t *orient);
+
+/**
+ * @brief Glass pixel an LVGL pixel must show up on
+ *
+ * The gap is an offset in DDRAM addresses: it moves the picture towards
+ * higher addresses, which mirroring turns into the other glass direction.
+ */
+void host_lvgl_to_glass(const host_panel_t *hp, const host_orient_t *orient, int x, int y, int *glass_x, int *glass_y);
+
+/**
+ * @brief Pack a 0/1 image of w x h pixels into ESP_LCD_ST75256_INPUT_LVGL_PAGES, h a multiple of 8
+ *
+ * @return Buffer of w * h / 8 bytes, free() it
+ */
+uint8_t *host_pack_lvgl_pages(const uint8_t *image, int w, int h);
+
+/**
+ * @brief Deterministic pseudo random 0/1 image of w x h pixels, free() it
+ */
+uint8_t *host_random_image(int w, int h, uint32_t seed);
+
+/**
+ * @brief Pixels of an image drawn at (x0, y0) that the glass does not show as drawn
+ *
+ * @param[in] hp Panel
+ * @param[in] orient Orientation the image was drawn in
+ * @param[in] image 0/1 image of w x h pixels
+ * @return Number of mismatching pixels, the first few are printed
+ */
+int host_check_glass(const host_panel_t *hp, const host_orient_t *orient, int x0, int y0, const uint8_t *image, int w, int h);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,177 @@
+/*
+ * Mock I2C master bus for the host tests, see mock_i2c_bus.h
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "esp_timer.h"
+#include "host_shim.h"
+#include "mock_i2c_bus.h"
+
+struct i2c_master_dev_t {
+    mock_i2c_bus_t *bus;
+    uint16_t address;
+    uint32_t scl_speed_hz;
+};
+
+mock_i2c_bus_t *mock_i2c_bus_new(st75256_model_t *model)
+{
+    mock_i2c_bus_t *bus = calloc(1, sizeof(mock_i2c_bus_t));
+    if (bus) {
+        bus->model = model;
+        pthread_mutex_init(&bus->lock, NULL);
+    }
+    return bus;
+}
+
+void mock_i2c_bus_del(mock_i2c_bus_t *bus)
+{
+    pthread_mutex_destroy(&bus->lock);
+    free(bus->log);
+    free(bus->bytes);
+    free(bus);
+}
+
+void mock_i2c_bus_clear(mock_i2c_bus_t *bus)
+{
+    pthread_mutex_lock(&bus->lock);
+    bus->log_len = 0;
+    bus->bytes_len = 0;
+    bus->max_size = 0;
+    pthread_mutex_unlock(&bus->lock);
+}
+
+// Decode the ST75256 control bytes: Co = 1 carries one byte, Co = 0 makes the rest of the transaction one phase
+static void mock_i2c_bus_decode(st75256_model_t *model, const uint8_t *bytes, size_t size)
+{
+    size_t i = 0;
+    while (i < size) {
+        uint8_t ctrl = bytes[i++];
+        int a0 = (ctrl >> 6) & 0x01;
+        if (ctrl & 0x80) {
+            if (i < size) {
+                st75256_model_feed(model, a0, bytes[i++]);
+            }
+        } else {
+            while (i < size) {
+                st75256_model_feed(model, a0, bytes[i++]);
+            }
+        }
+    }
+}
+
+// One transaction under the bus lock: log, decode and take the wire time
+static void mock_i2c_bus_transfer(mock_i2c_bus_t *bus, uint16_t address, uint32_t scl_speed_hz,
+                                  i2c_master_transmit_multi_buffer_info_t *buffers, size_t num_buffers,
+                                  bool to_model, int64_t *wait_us)
+{
+    size_t size = 0;
+    for (size_t i = 0; i < num_buffers; i++) {
+        size += buffers[i].buffer_size;
+    }
+    if (bus->hook) {
+        bus->hook(bus, address, size, bus->hook_ctx);
+    }
+    int64_t request = esp_timer_get_time();
+    pthread_mutex_lock(&bus->lock);
+    if (bus->log_len == bus->log_cap) {
+        size_t cap = bus->log_cap ? bus->log_cap * 2 : 256;
+        mock_i2c_trans_t *log = realloc(bus->log, cap * sizeof(mock_i2c_trans_t));
+        if (!log) {
+            abort();
+        }
+        bus->log = log;
+        bus->log_cap = cap;
+    }
+    if (bus->bytes_len + size > bus->bytes_cap) {
+        size_t cap = bus->bytes_cap ? bus->bytes_cap : 4096;
+        while (cap < bus->bytes_len + size) {
+            cap *= 2;
+        }
+        uint8_t *bytes = realloc(bus->bytes, cap);
+        if (!bytes) {
+            abort();
+        }
+        bus->bytes = bytes;
+        bus->bytes_cap = cap;
+    }
+    mock_i2c_trans_t *trans = &bus->log[bus->log_len++];
+    trans->address = address;
+    trans->offset = bus->bytes_len;
+    trans->size = size;
+    trans->start_us = esp_timer_get_time();
+    for (size_t i = 0; i < num_buffers; i++) {
+        memcpy(bus->bytes + bus->bytes_len, buffers[i].write_buffer, buffers[i].buffer_size);
+        bus->bytes_len += buffers[i].buffer_size;
+    }
+    if (size + 1 > bus->max_size) {
+        bus->max_size = size + 1;
+    }
+    if (to_model && bus->model) {
+        mock_i2c_bus_decode(bus->model, bus->bytes + trans->offset, size);
+    }
+    host_time_advance((int64_t)(size + 1) * 9 * 1000000 / scl_speed_hz);
+    if (bus->real_ns_per_byte) {
+        int64_t ns = (int64_t)bus->real_ns_per_byte * (size + 1);
+        struct timespec ts = {ns / 1000000000, ns % 1000000000};
+        nanosleep(&ts, NULL);
+    }
+    trans->end_us = esp_timer_get_time();
+    pthread_mutex_unlock(&bus->lock);
+    if (wait_us) {
+        *wait_us = trans->start_us - request;
+    }
+}
+
+void mock_i2c_bus_client_transmit(mock_i2c_bus_t *bus, uint16_t address, size_t size, uint32_t scl_speed_hz, int64_t *wait_us)
+{
+    uint8_t *payload = calloc(1, size ? size : 1);
+    if (!payload) {
+        abort();
+    }
+    i2c_master_transmit_multi_buffer_info_t buffer = {
+        .write_buffer = payload,
+        .buffer_size = size,
+    };
+    mock_i2c_bus_transfer(bus, address, scl_speed_hz, &buffer, 1, false, wait_us);
+    free(payload);
+}
+
+esp_err_t i2c_master_bus_add_device(i2c_master_bus_handle_t bus_handle, const i2c_device_config_t *dev_config, i2c_master_dev_handle_t *ret_handle)
+{
+    if (!bus_handle || !dev_config || !dev_config->scl_speed_hz || !ret_handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct i2c_master_dev_t *dev = calloc(1, sizeof(struct i2c_master_dev_t));
+    if (!dev) {
+        return ESP_ERR_NO_MEM;
+    }
+    dev->bus = bus_handle;
+    dev->address = dev_config->device_address;
+    dev->scl_speed_hz = dev_config->scl_speed_hz;
+    *ret_handle = dev;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_rm_device(i2c_master_dev_handle_t handle)
+{
+    free(handle);
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_transmit(i2c_master_dev_handle_t i2c_dev, const uint8_t *write_buffer, size_t write_size, int xfer_timeout_ms)
+{
+    i2c_master_transmit_multi_buffer_info_t buffer = {
+        .write_buffer = (uint8_t *)write_buffer,
+        .buffer_size = write_size,
+    };
+    mock_i2c_bus_transfer(i2c_dev->bus, i2c_dev->address, i2c_dev->scl_speed_hz, &buffer, 1, true, NULL);
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_multi_buffer_transmit(i2c_master_dev_handle_t i2c_dev, i2c_master_transmit_multi_buffer_info_t *buffer_info_array,
+                                           size_t array_size, int xfer_timeout_ms)
+{
+    mock_i2c_bus_transfer(i2c_dev->bus, i2c_dev->address, i2c_dev->scl_speed_hz, buffer_info_array, array_size, true, NULL);
+    return ESP_OK;
+}
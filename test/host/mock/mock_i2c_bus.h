@@ -0,0 +1,91 @@
+/*
+ * Mock I2C master bus for the host tests
+ *
+ * Devices added with i2c_master_bus_add_device() transmit into the bus: each
+ * transaction is logged byte for byte, decoded with the ST75256 control bytes
+ * (Co/A0) into a controller model and advances the virtual clock by 9 SCL
+ * clocks per byte, address included. Transactions of all devices are serialized
+ * like on one physical bus.
+ */
+#pragma once
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "driver/i2c_master.h"
+#include "st75256_model.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief One logged transaction, START ... STOP
+ */
+typedef struct {
+    uint16_t address;
+    size_t offset;            // Of the bytes after the address in mock_i2c_bus_t.bytes
+    size_t size;              // Bytes after the address
+    int64_t start_us;         // Virtual time the bus was granted
+    int64_t end_us;
+} mock_i2c_trans_t;
+
+typedef struct i2c_master_bus_t mock_i2c_bus_t;
+
+/**
+ * @brief Called before a transaction goes on the bus, outside the bus lock
+ *
+ * Lets a test run code while a driver call is in the middle of a transfer.
+ */
+typedef void (*mock_i2c_bus_hook_t)(mock_i2c_bus_t *bus, uint16_t address, size_t size, void *ctx);
+
+struct i2c_master_bus_t {
+    st75256_model_t *model;   // Receives the transactions of every device but `client_address`
+    uint32_t real_ns_per_byte; // Also sleep this long per byte, for tests with real task overlap
+    mock_i2c_bus_hook_t hook;
+    void *hook_ctx;
+    pthread_mutex_t lock;     // Held for one transaction
+    mock_i2c_trans_t *log;
+    size_t log_len;
+    size_t log_cap;
+    uint8_t *bytes;
+    size_t bytes_len;
+    size_t bytes_cap;
+    size_t max_size;          // Longest transaction, address included
+};
+
+/**
+ * @brief Create a bus feeding a model
+ *
+ * @param[in] model Controller model, can be NULL
+ * @return The bus, NULL when out of memory
+ */
+mock_i2c_bus_t *mock_i2c_bus_new(st75256_model_t *model);
+
+/**
+ * @brief Free a bus, all devices must have been removed
+ */
+void mock_i2c_bus_del(mock_i2c_bus_t *bus);
+
+/**
+ * @brief Forget the logged transactions and the longest transaction size
+ */
+void mock_i2c_bus_clear(mock_i2c_bus_t *bus);
+
+/**
+ * @brief Transmit as another device on the bus, e.g. a sensor competing with the panel
+ *
+ * The bytes are logged but not fed to the model.
+ *
+ * @param[in] bus Bus
+ * @param[in] address Address of the other device
+ * @param[in] size Bytes after the address
+ * @param[in] scl_speed_hz SCL frequency of the other device
+ * @param[out] wait_us Virtual time spent waiting for the bus, can be NULL
+ */
+void mock_i2c_bus_client_transmit(mock_i2c_bus_t *bus, uint16_t address, size_t size, uint32_t scl_speed_hz, int64_t *wait_us);
+
+#ifdef __cplusplus
+}
+#endif
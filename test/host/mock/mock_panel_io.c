@@ -0,0 +1,132 @@
+/*
+ * Recording generic I2C panel IO for the host tests, see mock_panel_io.h
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <sys/cdefs.h>
+#include "esp_lcd_panel_io_interface.h"
+#include "esp_timer.h"
+#include "host_shim.h"
+#include "mock_panel_io.h"
+
+static void mock_panel_io_append(mock_panel_io_t *mock, const uint8_t *data, size_t size)
+{
+    if (mock->bytes_len + size > mock->bytes_cap) {
+        size_t cap = mock->bytes_cap ? mock->bytes_cap : 4096;
+        while (cap < mock->bytes_len + size) {
+            cap *= 2;
+        }
+        uint8_t *bytes = realloc(mock->bytes, cap);
+        if (!bytes) {
+            abort();
+        }
+        mock->bytes = bytes;
+        mock->bytes_cap = cap;
+    }
+    memcpy(mock->bytes + mock->bytes_len, data, size);
+    mock->bytes_len += size;
+}
+
+// Log one transaction and feed it to the model, the time covers address, control and payload bytes
+static void mock_panel_io_transfer(mock_panel_io_t *mock, mock_panel_io_kind_t kind, int cmd, const void *data, size_t size)
+{
+    if (mock->log_len == mock->log_cap) {
+        size_t cap = mock->log_cap ? mock->log_cap * 2 : 256;
+        mock_panel_io_trans_t *log = realloc(mock->log, cap * sizeof(mock_panel_io_trans_t));
+        if (!log) {
+            abort();
+        }
+        mock->log = log;
+        mock->log_cap = cap;
+    }
+    mock_panel_io_trans_t *trans = &mock->log[mock->log_len++];
+    trans->kind = kind;
+    trans->cmd = cmd;
+    trans->offset = mock->bytes_len;
+    trans->size = size;
+    trans->start_us = esp_timer_get_time();
+    if (size) {
+        mock_panel_io_append(mock, data, size);
+    }
+
+    if (cmd >= 0) {
+        st75256_model_feed(mock->model, 0, cmd);
+    }
+    for (size_t i = 0; i < size; i++) {
+        st75256_model_feed(mock->model, kind == MOCK_PANEL_IO_COLOR, ((const uint8_t *)data)[i]);
+    }
+    if (mock->scl_speed_hz) {
+        size_t wire_bytes = 2 + (cmd >= 0) + size;
+        host_time_advance((int64_t)wire_bytes * 9 * 1000000 / mock->scl_speed_hz);
+    }
+    trans->end_us = esp_timer_get_time();
+}
+
+static esp_err_t mock_panel_io_tx_param(esp_lcd_panel_io_t *io, int lcd_cmd, const void *param, size_t param_size)
+{
+    mock_panel_io_t *mock = __containerof(io, mock_panel_io_t, base);
+    mock_panel_io_transfer(mock, MOCK_PANEL_IO_PARAM, lcd_cmd, param, param_size);
+    return ESP_OK;
+}
+
+static esp_err_t mock_panel_io_tx_color(esp_lcd_panel_io_t *io, int lcd_cmd, const void *color, size_t color_size)
+{
+    mock_panel_io_t *mock = __containerof(io, mock_panel_io_t, base);
+    mock_panel_io_transfer(mock, MOCK_PANEL_IO_COLOR, lcd_cmd, color, color_size);
+    if (mock->on_color_trans_done) {
+        mock->color_done_count++;
+        mock->on_color_trans_done(io, NULL, mock->user_ctx);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t mock_panel_io_rx_param(esp_lcd_panel_io_t *io, int lcd_cmd, void *param, size_t param_size)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+static esp_err_t mock_panel_io_register_event_callbacks(esp_lcd_panel_io_t *io, const esp_lcd_panel_io_callbacks_t *cbs, void *user_ctx)
+{
+    mock_panel_io_t *mock = __containerof(io, mock_panel_io_t, base);
+    mock->on_color_trans_done = cbs->on_color_trans_done;
+    mock->user_ctx = user_ctx;
+    return ESP_OK;
+}
+
+static esp_err_t mock_panel_io_del(esp_lcd_panel_io_t *io)
+{
+    mock_panel_io_t *mock = __containerof(io, mock_panel_io_t, base);
+    free(mock->log);
+    free(mock->bytes);
+    free(mock);
+    return ESP_OK;
+}
+
+esp_err_t mock_panel_io_new(st75256_model_t *model, uint32_t scl_speed_hz, esp_lcd_panel_io_handle_t *ret_io)
+{
+    mock_panel_io_t *mock = calloc(1, sizeof(mock_panel_io_t));
+    if (!mock) {
+        return ESP_ERR_NO_MEM;
+    }
+    mock->model = model;
+    mock->scl_speed_hz = scl_speed_hz;
+    mock->base.rx_param = mock_panel_io_rx_param;
+    mock->base.tx_param = mock_panel_io_tx_param;
+    mock->base.tx_color = mock_panel_io_tx_color;
+    mock->base.del = mock_panel_io_del;
+    mock->base.register_event_callbacks = mock_panel_io_register_event_callbacks;
+    *ret_io = &mock->base;
+    return ESP_OK;
+}
+
+void mock_panel_io_clear(esp_lcd_panel_io_handle_t io)
+{
+    mock_panel_io_t *mock = mock_panel_io_get(io);
+    mock->log_len = 0;
+    mock->bytes_len = 0;
+}
+
+mock_panel_io_t *mock_panel_io_get(esp_lcd_panel_io_handle_t io)
+{
+    return __containerof(io, mock_panel_io_t, base);
+}
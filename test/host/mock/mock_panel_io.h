@@ -0,0 +1,74 @@
+/*
+ * Recording stand-in for ESP-IDF's generic I2C panel IO (esp_lcd_new_panel_io_i2c()
+ * with control_phase_bytes = 1 and dc_bit_offset = 6)
+ *
+ * Every tx_param/tx_color call is one transaction: tx_param sends the command and
+ * its parameters with A0 = 0, tx_color an optional command with A0 = 0 and the data
+ * with A0 = 1, then reports on_color_trans_done. The bytes go to a controller model.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_lcd_panel_io_interface.h"
+#include "st75256_model.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    MOCK_PANEL_IO_PARAM,      // esp_lcd_panel_io_tx_param()
+    MOCK_PANEL_IO_COLOR,      // esp_lcd_panel_io_tx_color()
+} mock_panel_io_kind_t;
+
+/**
+ * @brief One recorded transaction
+ */
+typedef struct {
+    mock_panel_io_kind_t kind;
+    int cmd;                  // -1 for none
+    size_t offset;            // Of the payload in mock_panel_io_t.bytes
+    size_t size;              // Payload bytes
+    int64_t start_us;         // Virtual time
+    int64_t end_us;
+} mock_panel_io_trans_t;
+
+typedef struct {
+    esp_lcd_panel_io_t base;
+    st75256_model_t *model;
+    uint32_t scl_speed_hz;    // Virtual time per transaction, 0 = transfers take no time
+    esp_lcd_panel_io_color_trans_done_cb_t on_color_trans_done;
+    void *user_ctx;
+    uint32_t color_done_count;
+    mock_panel_io_trans_t *log;
+    size_t log_len;
+    size_t log_cap;
+    uint8_t *bytes;           // Payloads of all logged transactions
+    size_t bytes_len;
+    size_t bytes_cap;
+} mock_panel_io_t;
+
+/**
+ * @brief Create a mock panel IO feeding a model
+ *
+ * @param[in] model Controller model, must outlive the IO
+ * @param[in] scl_speed_hz SCL frequency the transfers advance the virtual clock with, 0 = none
+ * @param[out] ret_io Returned IO, free it with esp_lcd_panel_io_del()
+ * @return ESP_OK or ESP_ERR_NO_MEM
+ */
+esp_err_t mock_panel_io_new(st75256_model_t *model, uint32_t scl_speed_hz, esp_lcd_panel_io_handle_t *ret_io);
+
+/**
+ * @brief Forget the recorded transactions
+ */
+void mock_panel_io_clear(esp_lcd_panel_io_handle_t io);
+
+/**
+ * @brief Mock IO behind a handle from mock_panel_io_new()
+ */
+mock_panel_io_t *mock_panel_io_get(esp_lcd_panel_io_handle_t io);
+
+#ifdef __cplusplus
+}
+#endif
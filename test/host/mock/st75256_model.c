@@ -0,0 +1,264 @@
+/*
+ * ST75256 controller model for the host tests, see st75256_model.h
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "st75256_model.h"
+
+void st75256_model_init(st75256_model_t *model, int width, int height, int ddram_pages, int column_offset)
+{
+    free(model->log);
+    memset(model, 0, sizeof(st75256_model_t));
+    model->width = width;
+    model->height = height;
+    model->ddram_rows = ddram_pages * 8;
+    model->column_offset = column_offset;
+    model->cur_cmd = -1;
+    model->col_end = ST75256_MODEL_COLUMNS - 1;
+    model->page_end = ST75256_MODEL_PAGES - 1;
+    model->data_order = 0x08;
+    model->display_mode = 0x10;
+    model->power_save = false;
+    // Stands for the random content of DDRAM after power-on
+    memset(model->ddram, 0xAA, sizeof(model->ddram));
+}
+
+void st75256_model_deinit(st75256_model_t *model)
+{
+    free(model->log);
+    model->log = NULL;
+    model->log_len = 0;
+    model->log_cap = 0;
+}
+
+void st75256_model_clear_log(st75256_model_t *model)
+{
+    model->log_len = 0;
+    model->cmd_bytes = 0;
+    model->param_bytes = 0;
+    model->data_bytes = 0;
+    model->ram_writes = 0;
+}
+
+bool st75256_model_gray(const st75256_model_t *model)
+{
+    return model->display_mode == 0x11;
+}
+
+static void st75256_model_log(st75256_model_t *model, uint8_t cmd)
+{
+    if (model->log_len == model->log_cap) {
+        size_t cap = model->log_cap ? model->log_cap * 2 : 256;
+        st75256_model_cmd_t *log = realloc(model->log, cap * sizeof(st75256_model_cmd_t));
+        if (!log) {
+            abort();
+        }
+        model->log = log;
+        model->log_cap = cap;
+    }
+    model->log[model->log_len++] = (st75256_model_cmd_t) {
+        .ext = model->ext,
+        .cmd = cmd,
+    };
+}
+
+// 0x5C auto-increment: columns first, or pages first with 0xBC bit2, wrapping inside the window
+static void st75256_model_ram_write(st75256_model_t *model, uint8_t byte)
+{
+    if (model->page < ST75256_MODEL_PAGES && model->col < ST75256_MODEL_COLUMNS) {
+        model->ddram[model->page][model->col] = byte;
+    }
+    model->data_bytes++;
+    if (model->scan_dir & 0x04) {
+        if (++model->page > model->page_end) {
+            model->page = model->page_start;
+            if (++model->col > model->col_end) {
+                model->col = model->col_start;
+            }
+        }
+    } else {
+        if (++model->col > model->col_end) {
+            model->col = model->col_start;
+            if (++model->page > model->page_end) {
+                model->page = model->page_start;
+            }
+        }
+    }
+}
+
+static void st75256_model_command(st75256_model_t *model, uint8_t cmd)
+{
+    model->cmd_bytes++;
+    model->cur_cmd = cmd;
+    model->num_params = 0;
+    st75256_model_log(model, cmd);
+    if (cmd == 0x30 || cmd == 0x31) {
+        model->ext = cmd & 0x01;
+        return;
+    }
+    if (model->ext) {
+        return;
+    }
+    switch (cmd) {
+    case 0x08:
+    case 0x0C:
+        model->data_order = cmd;
+        break;
+    case 0x94:
+    case 0x95:
+        model->power_save = cmd & 0x01;
+        break;
+    case 0xA6:
+    case 0xA7:
+        model->invert = cmd & 0x01;
+        break;
+    case 0xAE:
+    case 0xAF:
+        model->display_on = cmd & 0x01;
+        break;
+    case 0x5C:
+        model->ram_writes++;
+        model->col = model->col_start;
+        model->page = model->page_start;
+        break;
+    default:
+        break;
+    }
+}
+
+static void st75256_model_param(st75256_model_t *model, uint8_t byte)
+{
+    model->param_bytes++;
+    if (model->cur_cmd < 0) {
+        return;
+    }
+    st75256_model_cmd_t *entry = &model->log[model->log_len - 1];
+    if (entry->num_params < ST75256_MODEL_MAX_PARAMS) {
+        entry->params[entry->num_params++] = byte;
+    }
+    if (model->num_params < ST75256_MODEL_MAX_PARAMS) {
+        model->params[model->num_params] = byte;
+    }
+    int n = ++model->num_params;
+    const uint8_t *p = model->params;
+    if (model->ext) {
+        if (model->cur_cmd == 0xF0 && n <= 4) {
+            model->frame_rate[n - 1] = byte;
+        } else if (model->cur_cmd == 0x20 && n <= 16) {
+            model->gray_table[n - 1] = byte;
+        }
+        return;
+    }
+    switch (model->cur_cmd) {
+    case 0x15:
+        if (n == 2) {
+            model->col_start = p[0];
+            model->col_end = p[1];
+        }
+        break;
+    case 0x75:
+        if (n == 2) {
+            model->page_start = p[0];
+            model->page_end = p[1];
+        }
+        break;
+    case 0xBC:
+        if (n == 1) {
+            model->scan_dir = byte;
+        }
+        break;
+    case 0xF0:
+        if (n == 1) {
+            model->display_mode = byte;
+        }
+        break;
+    case 0xAB:
+        if (n == 1) {
+            model->start_line = byte;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void st75256_model_feed(st75256_model_t *model, int a0, uint8_t byte)
+{
+    if (!a0) {
+        st75256_model_command(model, byte);
+    } else if (!model->ext && model->cur_cmd == 0x5C) {
+        st75256_model_ram_write(model, byte);
+    } else {
+        st75256_model_param(model, byte);
+    }
+}
+
+const st75256_model_cmd_t *st75256_model_find(const st75256_model_t *model, int ext, uint8_t cmd)
+{
+    for (size_t i = model->log_len; i-- > 0;) {
+        if (model->log[i].ext == ext && model->log[i].cmd == cmd) {
+            return &model->log[i];
+        }
+    }
+    return NULL;
+}
+
+int st75256_model_count(const st75256_model_t *model, int ext, uint8_t cmd)
+{
+    int count = 0;
+    for (size_t i = 0; i < model->log_len; i++) {
+        count += model->log[i].ext == ext && model->log[i].cmd == cmd;
+    }
+    return count;
+}
+
+int st75256_model_pixel(const st75256_model_t *model, int x, int y)
+{
+    int row = (y + model->start_line) % model->ddram_rows;
+    int col = x + model->column_offset;
+    if (model->scan_dir & 0x02) {
+        col = ST75256_MODEL_COLUMNS - 1 - col;
+    }
+    // 0xBC bit0 reverses the page addresses only, the rows within a page follow the data order
+    int page_rows = st75256_model_gray(model) ? 4 : 8;
+    int page = row / page_rows;
+    if (model->scan_dir & 0x01) {
+        page = model->ddram_rows / page_rows - 1 - page;
+    }
+    bool msb = model->data_order == 0x08;
+    if (st75256_model_gray(model)) {
+        int shift = (msb ? 3 - row % 4 : row % 4) * 2;
+        int level = (model->ddram[page][col] >> shift) & 0x03;
+        return model->invert ? 3 - level : level;
+    }
+    int bit = msb ? 7 - row % 8 : row % 8;
+    int lit = (model->ddram[page][col] >> bit) & 0x01;
+    return lit ^ model->invert;
+}
+
+int st75256_model_dump_pnm(const st75256_model_t *model, FILE *stream)
+{
+    bool gray = st75256_model_gray(model);
+    size_t line_size = gray ? model->width : (model->width + 7) / 8;
+    uint8_t *line = malloc(line_size);
+    if (!line) {
+        return -1;
+    }
+    int ret = fprintf(stream, gray ? "P5\n%d %d\n3\n" : "P4\n%d %d\n", model->width, model->height) > 0 ? 0 : -1;
+    for (int y = 0; y < model->height && !ret; y++) {
+        memset(line, 0, line_size);
+        for (int x = 0; x < model->width; x++) {
+            int pixel = st75256_model_pixel(model, x, y);
+            if (gray) {
+                line[x] = 3 - pixel;
+            } else if (pixel) {
+                line[x / 8] |= 0x80 >> (x % 8);
+            }
+        }
+        if (fwrite(line, 1, line_size, stream) != line_size) {
+            ret = -1;
+        }
+    }
+    free(line);
+    return ret;
+}
@@ -0,0 +1,139 @@
+/*
+ * ST75256 controller model for the host tests
+ *
+ * Fed with the bytes the controller receives (A0 = 0 for commands, 1 for
+ * parameters and RAM data), it keeps the state the tests check: extension
+ * command set, RAM window and address counters, scan direction, data order,
+ * display mode, invert, start line and the DDRAM content, plus a log of the
+ * commands with their parameters.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ST75256_MODEL_COLUMNS     256
+#define ST75256_MODEL_PAGES       64    // Enough for 168 rows in 4-level gray mode
+#define ST75256_MODEL_MAX_PARAMS  16
+
+/**
+ * @brief One command as the controller received it
+ */
+typedef struct {
+    uint8_t ext;              // Extension command set, 0 = 0x30, 1 = 0x31
+    uint8_t cmd;
+    uint8_t num_params;       // Parameters received, RAM data is not counted
+    uint8_t params[ST75256_MODEL_MAX_PARAMS];
+} st75256_model_cmd_t;
+
+typedef struct {
+    // Glass wiring
+    int width;                // Visible columns
+    int height;               // Visible rows
+    int ddram_rows;           // Rows the COM scan runs over
+    int column_offset;        // First DDRAM column wired to the glass
+
+    // Controller state
+    uint8_t ext;
+    int cur_cmd;              // -1 before the first command
+    int num_params;
+    uint8_t params[ST75256_MODEL_MAX_PARAMS];
+    int col_start, col_end, page_start, page_end;
+    int col, page;            // Address counters of 0x5C
+    uint8_t scan_dir;         // 0xBC: bit0 reverses page addresses, bit1 column addresses, bit2 increments pages first
+    uint8_t data_order;       // 0x08 (MSB on top) or 0x0C (LSB on top)
+    uint8_t display_mode;     // 0xF0 in set 1: 0x10 monochrome, 0x11 4-level gray
+    uint8_t start_line;
+    bool invert;
+    bool display_on;
+    bool power_save;
+    uint8_t frame_rate[4];    // 0xF0 in set 2
+    uint8_t gray_table[16];   // 0x20 in set 2
+    uint8_t ddram[ST75256_MODEL_PAGES][ST75256_MODEL_COLUMNS];
+
+    // Byte counters
+    uint32_t cmd_bytes;       // A0 = 0
+    uint32_t param_bytes;     // A0 = 1 outside RAM writes
+    uint32_t data_bytes;      // RAM data
+    uint32_t ram_writes;      // 0x5C commands
+
+    st75256_model_cmd_t *log;
+    size_t log_len;
+    size_t log_cap;
+} st75256_model_t;
+
+/**
+ * @brief Reset the model to the controller's power-on state, DDRAM filled with 0xAA
+ *
+ * @param[in] model Model
+ * @param[in] width Visible columns
+ * @param[in] height Visible rows
+ * @param[in] ddram_pages DDRAM pages of 8 rows the rows are scanned over
+ * @param[in] column_offset First DDRAM column wired to the glass
+ */
+void st75256_model_init(st75256_model_t *model, int width, int height, int ddram_pages, int column_offset);
+
+/**
+ * @brief Free the command log
+ */
+void st75256_model_deinit(st75256_model_t *model);
+
+/**
+ * @brief Forget the logged commands and the byte counters, the controller state stays
+ */
+void st75256_model_clear_log(st75256_model_t *model);
+
+/**
+ * @brief Feed one byte as received by the controller
+ *
+ * @param[in] model Model
+ * @param[in] a0 0 for a command, 1 for a parameter or RAM data
+ * @param[in] byte The byte
+ */
+void st75256_model_feed(st75256_model_t *model, int a0, uint8_t byte);
+
+/**
+ * @brief Last logged command, NULL if it was not received since the last clear
+ */
+const st75256_model_cmd_t *st75256_model_find(const st75256_model_t *model, int ext, uint8_t cmd);
+
+/**
+ * @brief Count of a command in the log
+ */
+int st75256_model_count(const st75256_model_t *model, int ext, uint8_t cmd);
+
+/**
+ * @brief Pixel of the glass, as the current scan direction, start line and data order show it
+ *
+ * @param[in] model Model
+ * @param[in] x Glass column, 0 .. width - 1
+ * @param[in] y Glass row, 0 .. height - 1
+ * @return Monochrome: 1 for a lit pixel. Gray: the 2-bit level, 3 is darkest. Inversion is applied.
+ */
+int st75256_model_pixel(const st75256_model_t *model, int x, int y);
+
+/**
+ * @brief True when 0xF0 in set 1 selected 4-level gray mode
+ */
+bool st75256_model_gray(const st75256_model_t *model);
+
+/**
+ * @brief Write the glass as a binary PBM (monochrome) or PGM (gray, maxval 3) image
+ *
+ * Rendered from DDRAM with st75256_model_pixel(), so it shows what the controller
+ * received, in glass orientation (width x height). Display off and power save are
+ * ignored. PBM stores a lit pixel as 1 (black), PGM the darkest level as 0.
+ *
+ * @return 0 on success, -1 if writing to the stream failed
+ */
+int st75256_model_dump_pnm(const st75256_model_t *model, FILE *stream);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,392 @@
+/*
+ * The FreeRTOS calls of the ST75256 driver on POSIX threads
+ *
+ * Queues are a ring buffer under a mutex, semaphores and mutexes are queues of
+ * zero-size items. Event groups count how often bits were set, so that a waiter
+ * released by a set does not miss it when the bits are cleared again. Tasks are threads; vTaskDelete() of another task cancels it
+ * at its next blocking call (all of them are cancellation points here).
+ */
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "host_shim.h"
+
+struct host_queue {
+    pthread_mutex_t mutex;
+    pthread_cond_t changed;   // Broadcast on every send and receive
+    size_t item_size;
+    size_t length;
+    size_t count;
+    size_t head;
+    uint8_t *items;
+};
+
+struct host_task {
+    pthread_t thread;
+    TaskFunction_t code;
+    void *params;
+    pthread_mutex_t mutex;
+    pthread_cond_t notified;
+    uint32_t notify_value;
+};
+
+static __thread struct host_task *s_current_task;
+static struct host_task s_main_task = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .notified = PTHREAD_COND_INITIALIZER,
+};
+
+// Absolute real-time deadline `ticks` milliseconds from now
+static struct timespec host_deadline(TickType_t ticks)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += ticks / 1000;
+    ts.tv_nsec += (long)(ticks % 1000) * 1000000;
+    if (ts.tv_nsec >= 1000000000) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000;
+    }
+    return ts;
+}
+
+static void host_unlock_mutex(void *mutex)
+{
+    pthread_mutex_unlock(mutex);
+}
+
+// Wait for `ready(queue)` under the queue mutex, false on timeout. Cancelling the task here releases the mutex.
+static bool host_queue_wait(struct host_queue *queue, bool (*ready)(const struct host_queue *), TickType_t ticks)
+{
+    struct timespec deadline = host_deadline(ticks == portMAX_DELAY ? 0 : ticks);
+    bool ok = true;
+    pthread_cleanup_push(host_unlock_mutex, &queue->mutex);
+    while (!ready(queue)) {
+        if (ticks == 0) {
+            ok = false;
+            break;
+        }
+        if (ticks == portMAX_DELAY) {
+            pthread_cond_wait(&queue->changed, &queue->mutex);
+        } else if (pthread_cond_timedwait(&queue->changed, &queue->mutex, &deadline) == ETIMEDOUT) {
+            ok = ready(queue);
+            break;
+        }
+    }
+    pthread_cleanup_pop(0);
+    return ok;
+}
+
+static bool host_queue_has_room(const struct host_queue *queue)
+{
+    return queue->count < queue->length;
+}
+
+static bool host_queue_has_item(const struct host_queue *queue)
+{
+    return queue->count > 0;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    struct host_queue *queue = calloc(1, sizeof(struct host_queue));
+    if (!queue) {
+        return NULL;
+    }
+    queue->items = calloc(length, item_size ? item_size : 1);
+    if (!queue->items) {
+        free(queue);
+        return NULL;
+    }
+    pthread_mutex_init(&queue->mutex, NULL);
+    pthread_cond_init(&queue->changed, NULL);
+    queue->item_size = item_size;
+    queue->length = length;
+    return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    pthread_mutex_destroy(&queue->mutex);
+    pthread_cond_destroy(&queue->changed);
+    free(queue->items);
+    free(queue);
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait)
+{
+    pthread_mutex_lock(&queue->mutex);
+    if (!host_queue_wait(queue, host_queue_has_room, ticks_to_wait)) {
+        pthread_mutex_unlock(&queue->mutex);
+        return pdFALSE;
+    }
+    if (queue->item_size) {
+        memcpy(queue->items + (queue->head + queue->count) % queue->length * queue->item_size, item, queue->item_size);
+    }
+    queue->count++;
+    pthread_cond_broadcast(&queue->changed);
+    pthread_mutex_unlock(&queue->mutex);
+    return pdTRUE;
+}
+
+static BaseType_t host_queue_take(QueueHandle_t queue, void *item, TickType_t ticks_to_wait, bool remove)
+{
+    pthread_mutex_lock(&queue->mutex);
+    if (!host_queue_wait(queue, host_queue_has_item, ticks_to_wait)) {
+        pthread_mutex_unlock(&queue->mutex);
+        return pdFALSE;
+    }
+    if (queue->item_size && item) {
+        memcpy(item, queue->items + queue->head * queue->item_size, queue->item_size);
+    }
+    if (remove) {
+        queue->head = (queue->head + 1) % queue->length;
+        queue->count--;
+        pthread_cond_broadcast(&queue->changed);
+    }
+    pthread_mutex_unlock(&queue->mutex);
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait)
+{
+    return host_queue_take(queue, item, ticks_to_wait, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void *item, TickType_t ticks_to_wait)
+{
+    return host_queue_take(queue, item, ticks_to_wait, false);
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    pthread_mutex_lock(&queue->mutex);
+    UBaseType_t count = queue->count;
+    pthread_mutex_unlock(&queue->mutex);
+    return count;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    SemaphoreHandle_t sem = xQueueCreate(1, 0);
+    if (sem) {
+        xSemaphoreGive(sem);
+    }
+    return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return xQueueCreate(1, 0);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks_to_wait)
+{
+    return xQueueReceive(sem, NULL, ticks_to_wait);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    return xQueueSend(sem, NULL, 0);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem)
+{
+    vQueueDelete(sem);
+}
+
+struct host_event_group {
+    pthread_mutex_t mutex;
+    pthread_cond_t changed;   // Broadcast on every set
+    EventBits_t bits;
+    uint32_t sets;            // Times bits were set, wakes the waiters of that moment
+    EventBits_t last_set;     // Bits of the last set, they count for the waiters it woke
+};
+
+EventGroupHandle_t xEventGroupCreate(void)
+{
+    struct host_event_group *group = calloc(1, sizeof(struct host_event_group));
+    if (!group) {
+        return NULL;
+    }
+    pthread_mutex_init(&group->mutex, NULL);
+    pthread_cond_init(&group->changed, NULL);
+    return group;
+}
+
+void vEventGroupDelete(EventGroupHandle_t group)
+{
+    pthread_mutex_destroy(&group->mutex);
+    pthread_cond_destroy(&group->changed);
+    free(group);
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    pthread_mutex_lock(&group->mutex);
+    group->bits |= bits;
+    group->sets++;
+    group->last_set = bits;
+    EventBits_t now = group->bits;
+    pthread_cond_broadcast(&group->changed);
+    pthread_mutex_unlock(&group->mutex);
+    return now;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    pthread_mutex_lock(&group->mutex);
+    EventBits_t before = group->bits;
+    group->bits &= ~bits;
+    pthread_mutex_unlock(&group->mutex);
+    return before;
+}
+
+// Bits of `have` that satisfy the wait, 0 if they are not all (or none) set
+static EventBits_t host_event_match(EventBits_t have, EventBits_t bits, BaseType_t wait_for_all)
+{
+    EventBits_t set = have & bits;
+    return (wait_for_all ? set == bits : set != 0) ? set : 0;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clear_on_exit,
+                                BaseType_t wait_for_all, TickType_t ticks_to_wait)
+{
+    struct timespec deadline = host_deadline(ticks_to_wait == portMAX_DELAY ? 0 : ticks_to_wait);
+    pthread_mutex_lock(&group->mutex);
+    uint32_t sets = group->sets;
+    EventBits_t match = host_event_match(group->bits, bits, wait_for_all);
+    pthread_cleanup_push(host_unlock_mutex, &group->mutex);
+    while (!match && ticks_to_wait) {
+        if (ticks_to_wait == portMAX_DELAY) {
+            pthread_cond_wait(&group->changed, &group->mutex);
+        } else if (pthread_cond_timedwait(&group->changed, &group->mutex, &deadline) == ETIMEDOUT) {
+            break;
+        }
+        if (group->sets != sets) {
+            // Released by the set, even if the bits were cleared again since
+            sets = group->sets;
+            match = host_event_match(group->bits | group->last_set, bits, wait_for_all);
+        }
+    }
+    pthread_cleanup_pop(0);
+    EventBits_t now = group->bits;
+    if (match && clear_on_exit) {
+        group->bits &= ~bits;
+    }
+    pthread_mutex_unlock(&group->mutex);
+    return now | match;
+}
+
+static void *host_task_main(void *arg)
+{
+    struct host_task *task = arg;
+    s_current_task = task;
+    task->code(task->params);
+    return NULL;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t task_code, const char *name, uint32_t stack_depth, void *params,
+                       UBaseType_t priority, TaskHandle_t *created_task)
+{
+    (void)name;
+    (void)stack_depth;
+    (void)priority;
+    struct host_task *task = calloc(1, sizeof(struct host_task));
+    if (!task) {
+        return pdFAIL;
+    }
+    task->code = task_code;
+    task->params = params;
+    pthread_mutex_init(&task->mutex, NULL);
+    pthread_cond_init(&task->notified, NULL);
+    // The handle is valid before the task runs, as with FreeRTOS
+    if (created_task) {
+        *created_task = task;
+    }
+    if (pthread_create(&task->thread, NULL, host_task_main, task) != 0) {
+        free(task);
+        return pdFAIL;
+    }
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if (!task || task == s_current_task) {
+        // Deleting itself: nobody joins the thread, the handle must not be used any more
+        task = s_current_task;
+        pthread_mutex_destroy(&task->mutex);
+        pthread_cond_destroy(&task->notified);
+        free(task);
+        pthread_detach(pthread_self());
+        pthread_exit(NULL);
+    }
+    pthread_cancel(task->thread);
+    pthread_join(task->thread, NULL);
+    pthread_mutex_destroy(&task->mutex);
+    pthread_cond_destroy(&task->notified);
+    free(task);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    host_time_advance((int64_t)ticks * 1000);
+    // Polling loops (st75256_lock()) give the other threads a real chance to run
+    struct timespec ts = {0, 50000};
+    nanosleep(&ts, NULL);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(esp_timer_get_time() / 1000);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return s_current_task ? s_current_task : &s_main_task;
+}
+
+void taskYIELD(void)
+{
+    sched_yield();
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    pthread_mutex_lock(&task->mutex);
+    task->notify_value++;
+    pthread_cond_broadcast(&task->notified);
+    pthread_mutex_unlock(&task->mutex);
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait)
+{
+    struct host_task *task = xTaskGetCurrentTaskHandle();
+    struct timespec deadline = host_deadline(ticks_to_wait == portMAX_DELAY ? 0 : ticks_to_wait);
+    pthread_mutex_lock(&task->mutex);
+    pthread_cleanup_push(host_unlock_mutex, &task->mutex);
+    while (!task->notify_value && ticks_to_wait) {
+        if (ticks_to_wait == portMAX_DELAY) {
+            pthread_cond_wait(&task->notified, &task->mutex);
+        } else if (pthread_cond_timedwait(&task->notified, &task->mutex, &deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+    pthread_cleanup_pop(0);
+    uint32_t value = task->notify_value;
+    if (value) {
+        task->notify_value = clear_on_exit ? 0 : value - 1;
+    }
+    pthread_mutex_unlock(&task->mutex);
+    return value;
+}
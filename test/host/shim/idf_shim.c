@@ -0,0 +1,300 @@
+/*
+ * ESP-IDF services the ST75256 driver uses, for the host build: error names,
+ * logging, GPIO, the esp_lcd dispatch functions, a virtual clock and esp_timer.
+ */
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "driver/gpio.h"
+#include "esp_lcd_panel_interface.h"
+#include "esp_lcd_panel_io_interface.h"
+#include "esp_lcd_panel_ops.h"
+#include "host_shim.h"
+
+#define HOST_MAX_TIMERS 256   // Never reused, one per panel created: the benchmarks create one panel per run
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+    case ESP_OK:
+        return "ESP_OK";
+    case ESP_FAIL:
+        return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:
+        return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:
+        return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE:
+        return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE:
+        return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:
+        return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED:
+        return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT:
+        return "ESP_ERR_TIMEOUT";
+    default:
+        return "UNKNOWN ERROR";
+    }
+}
+
+void host_abort_on_error(esp_err_t code, const char *file, int line, const char *expr)
+{
+    fprintf(stderr, "%s:%d: %s failed: %s\n", file, line, expr, esp_err_to_name(code));
+    abort();
+}
+
+void esp_log_level_set(const char *tag, esp_log_level_t level)
+{
+    (void)tag;
+    (void)level;
+}
+
+int host_log_enabled(esp_log_level_t level)
+{
+    // Tests provoke errors on purpose, HOST_LOG_QUIET hides them
+    if (level <= ESP_LOG_WARN) {
+        return !getenv("HOST_LOG_QUIET");
+    }
+    return level == ESP_LOG_INFO && getenv("HOST_LOG_INFO");
+}
+
+esp_err_t gpio_config(const gpio_config_t *config)
+{
+    (void)config;
+    return ESP_OK;
+}
+
+esp_err_t gpio_reset_pin(int gpio_num)
+{
+    (void)gpio_num;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(int gpio_num, uint32_t level)
+{
+    (void)gpio_num;
+    (void)level;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_reset(esp_lcd_panel_handle_t panel)
+{
+    return panel->reset(panel);
+}
+
+esp_err_t esp_lcd_panel_init(esp_lcd_panel_handle_t panel)
+{
+    return panel->init(panel);
+}
+
+esp_err_t esp_lcd_panel_del(esp_lcd_panel_handle_t panel)
+{
+    return panel->del(panel);
+}
+
+esp_err_t esp_lcd_panel_draw_bitmap(esp_lcd_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end, const void *color_data)
+{
+    return panel->draw_bitmap(panel, x_start, y_start, x_end, y_end, color_data);
+}
+
+esp_err_t esp_lcd_panel_mirror(esp_lcd_panel_handle_t panel, bool mirror_x, bool mirror_y)
+{
+    return panel->mirror(panel, mirror_x, mirror_y);
+}
+
+esp_err_t esp_lcd_panel_swap_xy(esp_lcd_panel_handle_t panel, bool swap_axes)
+{
+    return panel->swap_xy(panel, swap_axes);
+}
+
+esp_err_t esp_lcd_panel_set_gap(esp_lcd_panel_handle_t panel, int x_gap, int y_gap)
+{
+    return panel->set_gap(panel, x_gap, y_gap);
+}
+
+esp_err_t esp_lcd_panel_invert_color(esp_lcd_panel_handle_t panel, bool invert_color_data)
+{
+    return panel->invert_color(panel, invert_color_data);
+}
+
+esp_err_t esp_lcd_panel_disp_on_off(esp_lcd_panel_handle_t panel, bool on_off)
+{
+    return panel->disp_on_off(panel, on_off);
+}
+
+esp_err_t esp_lcd_panel_io_rx_param(esp_lcd_panel_io_handle_t io, int lcd_cmd, void *param, size_t param_size)
+{
+    return io->rx_param(io, lcd_cmd, param, param_size);
+}
+
+esp_err_t esp_lcd_panel_io_tx_param(esp_lcd_panel_io_handle_t io, int lcd_cmd, const void *param, size_t param_size)
+{
+    return io->tx_param(io, lcd_cmd, param, param_size);
+}
+
+esp_err_t esp_lcd_panel_io_tx_color(esp_lcd_panel_io_handle_t io, int lcd_cmd, const void *color, size_t color_size)
+{
+    return io->tx_color(io, lcd_cmd, color, color_size);
+}
+
+esp_err_t esp_lcd_panel_io_del(esp_lcd_panel_io_handle_t io)
+{
+    return io->del(io);
+}
+
+esp_err_t esp_lcd_panel_io_register_event_callbacks(esp_lcd_panel_io_handle_t io, const esp_lcd_panel_io_callbacks_t *cbs, void *user_ctx)
+{
+    return io->register_event_callbacks(io, cbs, user_ctx);
+}
+
+// Virtual clock, in microseconds
+static int64_t s_time_us;
+
+void host_time_advance(int64_t us)
+{
+    __atomic_add_fetch(&s_time_us, us, __ATOMIC_SEQ_CST);
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return __atomic_add_fetch(&s_time_us, 1, __ATOMIC_SEQ_CST);
+}
+
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void *arg;
+    int64_t deadline;
+    bool active;
+    bool deleted;             // Kept after esp_timer_delete() to catch late use
+};
+
+static pthread_mutex_t s_timer_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct esp_timer s_timers[HOST_MAX_TIMERS];
+static int s_num_timers;
+static int s_use_after_delete;
+
+// Count and refuse calls on a deleted timer, under s_timer_mutex
+static bool host_timer_usable(esp_timer_handle_t timer)
+{
+    if (timer->deleted) {
+        s_use_after_delete++;
+        fprintf(stderr, "esp_timer %p used after esp_timer_delete()\n", (void *)timer);
+        return false;
+    }
+    return true;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle)
+{
+    if (!create_args || !create_args->callback || !out_handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&s_timer_mutex);
+    if (s_num_timers == HOST_MAX_TIMERS) {
+        pthread_mutex_unlock(&s_timer_mutex);
+        return ESP_ERR_NO_MEM;
+    }
+    esp_timer_handle_t timer = &s_timers[s_num_timers++];
+    timer->callback = create_args->callback;
+    timer->arg = create_args->arg;
+    *out_handle = timer;
+    pthread_mutex_unlock(&s_timer_mutex);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    esp_err_t ret = ESP_OK;
+    pthread_mutex_lock(&s_timer_mutex);
+    if (!host_timer_usable(timer) || timer->active) {
+        ret = ESP_ERR_INVALID_STATE;
+    } else {
+        timer->active = true;
+        timer->deadline = __atomic_load_n(&s_time_us, __ATOMIC_SEQ_CST) + (int64_t)timeout_us;
+    }
+    pthread_mutex_unlock(&s_timer_mutex);
+    return ret;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    esp_err_t ret = ESP_OK;
+    pthread_mutex_lock(&s_timer_mutex);
+    if (!host_timer_usable(timer) || !timer->active) {
+        ret = ESP_ERR_INVALID_STATE;
+    }
+    timer->active = false;
+    pthread_mutex_unlock(&s_timer_mutex);
+    return ret;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    esp_err_t ret = ESP_OK;
+    pthread_mutex_lock(&s_timer_mutex);
+    if (!host_timer_usable(timer) || timer->active) {
+        ret = ESP_ERR_INVALID_STATE;
+    } else {
+        timer->deleted = true;
+    }
+    pthread_mutex_unlock(&s_timer_mutex);
+    return ret;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer)
+{
+    pthread_mutex_lock(&s_timer_mutex);
+    bool active = host_timer_usable(timer) && timer->active;
+    pthread_mutex_unlock(&s_timer_mutex);
+    return active;
+}
+
+int host_timer_run_due(void)
+{
+    int run = 0;
+    for (int i = 0; i < HOST_MAX_TIMERS; i++) {
+        esp_timer_handle_t timer = &s_timers[i];
+        pthread_mutex_lock(&s_timer_mutex);
+        bool due = i < s_num_timers && !timer->deleted && timer->active &&
+                   __atomic_load_n(&s_time_us, __ATOMIC_SEQ_CST) >= timer->deadline;
+        if (due) {
+            timer->active = false;
+        }
+        pthread_mutex_unlock(&s_timer_mutex);
+        if (due) {
+            timer->callback(timer->arg);
+            run++;
+        }
+    }
+    return run;
+}
+
+void host_timer_fire(esp_timer_handle_t timer)
+{
+    pthread_mutex_lock(&s_timer_mutex);
+    timer->active = false;
+    pthread_mutex_unlock(&s_timer_mutex);
+    timer->callback(timer->arg);
+}
+
+esp_timer_handle_t host_timer_last(void)
+{
+    pthread_mutex_lock(&s_timer_mutex);
+    esp_timer_handle_t timer = s_num_timers ? &s_timers[s_num_timers - 1] : NULL;
+    pthread_mutex_unlock(&s_timer_mutex);
+    return timer;
+}
+
+int host_timer_use_after_delete(void)
+{
+    pthread_mutex_lock(&s_timer_mutex);
+    int count = s_use_after_delete;
+    pthread_mutex_unlock(&s_timer_mutex);
+    return count;
+}
@@ -0,0 +1,21 @@
+/*
+ * Host build stand-in for ESP-IDF's driver/gpio.h, pins do nothing
+ */
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef enum {
+    GPIO_MODE_DISABLE = 0,
+    GPIO_MODE_OUTPUT = 2,
+} gpio_mode_t;
+
+typedef struct {
+    uint64_t pin_bit_mask;
+    gpio_mode_t mode;
+} gpio_config_t;
+
+esp_err_t gpio_config(const gpio_config_t *config);
+esp_err_t gpio_reset_pin(int gpio_num);
+esp_err_t gpio_set_level(int gpio_num, uint32_t level);
@@ -0,0 +1,11 @@
+/*
+ * Host build stand-in for ESP-IDF's esp_compiler.h
+ */
+#pragma once
+
+#define likely(x)   __builtin_expect(!!(x), 1)
+#define unlikely(x) __builtin_expect(!!(x), 0)
+
+// The IDF macros silence GCC's static analyzer, which the host build does not run
+#define ESP_COMPILER_DIAGNOSTIC_PUSH_IGNORE(warning)
+#define ESP_COMPILER_DIAGNOSTIC_POP(warning)
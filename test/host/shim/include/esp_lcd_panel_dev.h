@@ -0,0 +1,19 @@
+/*
+ * Host build stand-in for ESP-IDF's esp_lcd_panel_dev.h
+ */
+#pragma once
+
+#include "esp_lcd_types.h"
+
+typedef struct {
+    int reset_gpio_num;
+    union {
+        lcd_rgb_element_order_t rgb_ele_order;
+        esp_lcd_color_space_t color_space;
+    };
+    uint32_t bits_per_pixel;
+    struct {
+        uint32_t reset_active_high: 1;
+    } flags;
+    void *vendor_config;
+} esp_lcd_panel_dev_config_t;
@@ -0,0 +1,22 @@
+/*
+ * Host build stand-in for ESP-IDF's esp_lcd_types.h
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct esp_lcd_panel_io_t *esp_lcd_panel_io_handle_t;
+typedef struct esp_lcd_panel_t *esp_lcd_panel_handle_t;
+
+typedef enum {
+    ESP_LCD_COLOR_SPACE_RGB,
+    ESP_LCD_COLOR_SPACE_BGR,
+    ESP_LCD_COLOR_SPACE_MONOCHROME,
+} esp_lcd_color_space_t;
+
+typedef enum {
+    LCD_RGB_ELEMENT_ORDER_RGB,
+    LCD_RGB_ELEMENT_ORDER_BGR,
+} lcd_rgb_element_order_t;
@@ -0,0 +1,31 @@
+/*
+ * Host build stand-in for ESP-IDF's esp_log.h: errors and warnings go to stderr,
+ * info only with HOST_LOG_INFO set in the environment, debug never
+ */
+#pragma once
+
+#include <stdio.h>
+
+typedef enum {
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE,
+} esp_log_level_t;
+
+void esp_log_level_set(const char *tag, esp_log_level_t level);
+int host_log_enabled(esp_log_level_t level);
+
+#define ESP_LOG_LEVEL(level, letter, tag, format, ...) do {                          \
+        if (host_log_enabled(level)) {                                               \
+            fprintf(stderr, letter " %s: " format "\n", tag, ##__VA_ARGS__);         \
+        }                                                                            \
+    } while (0)
+
+#define ESP_LOGE(tag, format, ...) ESP_LOG_LEVEL(ESP_LOG_ERROR, "E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) ESP_LOG_LEVEL(ESP_LOG_WARN, "W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) ESP_LOG_LEVEL(ESP_LOG_INFO, "I", tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) ESP_LOG_LEVEL(ESP_LOG_DEBUG, "D", tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) ESP_LOG_LEVEL(ESP_LOG_VERBOSE, "V", tag, format, ##__VA_ARGS__)
@@ -0,0 +1,22 @@
+/*
+ * Host build stand-in for FreeRTOS.h, implemented on POSIX threads (freertos_posix.c)
+ *
+ * One tick is one millisecond of virtual time, see host_shim.h.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#define pdTRUE                  1
+#define pdFALSE                 0
+#define pdPASS                  pdTRUE
+#define pdFAIL                  pdFALSE
+#define portMAX_DELAY           ((TickType_t)0xffffffffUL)
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(ms))
+#define configMAX_PRIORITIES    25
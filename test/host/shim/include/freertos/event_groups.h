@@ -0,0 +1,19 @@
+/*
+ * Host build stand-in for FreeRTOS event_groups.h
+ *
+ * As with FreeRTOS, setting a bit releases every task waiting for it at that
+ * moment, even if another task clears it again before they run.
+ */
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct host_event_group *EventGroupHandle_t;
+typedef uint32_t EventBits_t;
+
+EventGroupHandle_t xEventGroupCreate(void);
+void vEventGroupDelete(EventGroupHandle_t group);
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits);
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits);
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clear_on_exit,
+                                BaseType_t wait_for_all, TickType_t ticks_to_wait);
@@ -0,0 +1,54 @@
+/*
+ * Controls of the host shims that have no ESP-IDF counterpart
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_timer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Move the virtual clock forward, returned by esp_timer_get_time()
+ *
+ * Every esp_timer_get_time() call also moves it by 1 us, so consecutive readings
+ * always differ, like on a real target.
+ */
+void host_time_advance(int64_t us);
+
+/**
+ * @brief Run the callbacks of all esp_timers that are due at the current virtual time
+ *
+ * The callbacks run in the calling thread, as they would in the esp_timer task.
+ *
+ * @return Number of callbacks run
+ */
+int host_timer_run_due(void);
+
+/**
+ * @brief Run the callback of a timer right away, whether it is due or not
+ *
+ * Stands for a timer that expired just before the caller looked, e.g. while
+ * another task is inside the driver.
+ */
+void host_timer_fire(esp_timer_handle_t timer);
+
+/**
+ * @brief esp_timer handle created last, NULL if none
+ */
+esp_timer_handle_t host_timer_last(void);
+
+/**
+ * @brief Calls that used an esp_timer after esp_timer_delete() since the program started
+ *
+ * Deleted timers are kept, so such a call is counted instead of touching freed memory.
+ */
+int host_timer_use_after_delete(void);
+
+#ifdef __cplusplus
+}
+#endif
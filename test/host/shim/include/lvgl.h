@@ -0,0 +1,130 @@
+/*
+ * Host build stand-in for the parts of LVGL 8 the ST75256 LVGL glue uses
+ *
+ * lv_disp_drv_register() keeps the driver, host_lvgl_refresh() then renders
+ * through its rounder/set_px/flush callbacks the way lv_refr.c does.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LVGL_VERSION_MAJOR 8
+
+typedef int16_t lv_coord_t;
+typedef uint8_t lv_opa_t;
+
+typedef union {
+    uint8_t full;
+} lv_color_t;
+
+typedef struct {
+    lv_coord_t x1;
+    lv_coord_t y1;
+    lv_coord_t x2;
+    lv_coord_t y2;
+} lv_area_t;
+
+typedef enum {
+    LV_DISP_ROT_NONE = 0,
+    LV_DISP_ROT_90,
+    LV_DISP_ROT_180,
+    LV_DISP_ROT_270,
+} lv_disp_rot_t;
+
+typedef enum {
+    LV_ANIM_OFF,
+    LV_ANIM_ON,
+} lv_anim_enable_t;
+
+typedef struct {
+    void *buf1;
+    void *buf2;
+    void *buf_act;
+    uint32_t size;            // In pixels
+} lv_disp_draw_buf_t;
+
+typedef struct _lv_disp_drv_t {
+    lv_coord_t hor_res;
+    lv_coord_t ver_res;
+    uint32_t full_refresh : 1;
+    uint32_t sw_rotate : 1;
+    uint32_t rotated : 2;
+    lv_disp_draw_buf_t *draw_buf;
+    void (*flush_cb)(struct _lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p);
+    void (*rounder_cb)(struct _lv_disp_drv_t *drv, lv_area_t *area);
+    void (*set_px_cb)(struct _lv_disp_drv_t *drv, uint8_t *buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
+                      lv_color_t color, lv_opa_t opa);
+    void (*drv_update_cb)(struct _lv_disp_drv_t *drv);
+    void *user_data;
+    volatile int flushing;
+} lv_disp_drv_t;
+
+typedef struct _lv_disp_t {
+    lv_disp_drv_t *driver;
+    uint32_t inactive_ms;     // Returned by lv_disp_get_inactive_time()
+} lv_disp_t;
+
+typedef struct _lv_obj_t lv_obj_t;
+
+static inline uint8_t lv_color_to1(lv_color_t color)
+{
+    return color.full != 0;
+}
+
+static inline lv_color_t lv_color_hex(uint32_t c)
+{
+    lv_color_t color = {.full = c != 0};
+    return color;
+}
+
+void lv_disp_draw_buf_init(lv_disp_draw_buf_t *draw_buf, void *buf1, void *buf2, uint32_t size_in_px_cnt);
+void lv_disp_drv_init(lv_disp_drv_t *driver);
+lv_disp_t *lv_disp_drv_register(lv_disp_drv_t *driver);
+void lv_disp_remove(lv_disp_t *disp);
+void lv_disp_flush_ready(lv_disp_drv_t *disp_drv);
+void lv_disp_set_rotation(lv_disp_t *disp, lv_disp_rot_t rotation);
+lv_obj_t *lv_disp_get_scr_act(lv_disp_t *disp);
+void lv_obj_invalidate(const lv_obj_t *obj);
+void lv_obj_scroll_by(lv_obj_t *obj, lv_coord_t dx, lv_coord_t dy, lv_anim_enable_t anim_en);
+uint32_t lv_disp_get_inactive_time(const lv_disp_t *disp);
+
+/**
+ * @brief Pixel source for host_lvgl_refresh(), returns 1 for a lit pixel
+ *
+ * Coordinates are in the rotated resolution LVGL renders in.
+ */
+typedef int (*host_lvgl_pixel_cb_t)(int x, int y, void *ctx);
+
+/**
+ * @brief Render and flush one invalidated area like lv_refr.c
+ *
+ * Applies the rounder, splits the area into strips that fit the draw buffer,
+ * writes every pixel through set_px_cb and waits for lv_disp_flush_ready() of a
+ * strip before reusing its buffer (alternating buffers when there are two).
+ *
+ * @param[in] disp Display from lv_disp_drv_register()
+ * @param[in] area Area to redraw, inclusive, in the rotated resolution
+ * @param[in] pixel Pixel source
+ * @param[in] ctx Passed to pixel
+ * @return Number of flush_cb calls
+ */
+int host_lvgl_refresh(lv_disp_t *disp, const lv_area_t *area, host_lvgl_pixel_cb_t pixel, void *ctx);
+
+/**
+ * @brief Wait until the last flush of the display was reported ready
+ */
+void host_lvgl_wait_flush(lv_disp_t *disp);
+
+/**
+ * @brief Set the value returned by lv_disp_get_inactive_time(), for all displays when disp is NULL
+ */
+void host_lvgl_set_inactive_time(lv_disp_t *disp, uint32_t ms);
+
+#ifdef __cplusplus
+}
+#endif
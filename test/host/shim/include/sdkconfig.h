@@ -0,0 +1,6 @@
+/*
+ * Host build stand-in for the generated sdkconfig.h
+ */
+#pragma once
+
+#define CONFIG_IDF_TARGET "linux"
@@ -0,0 +1,11 @@
+/*
+ * Host build: the C library's sys/cdefs.h plus newlib's __containerof
+ */
+#pragma once
+
+#include_next <sys/cdefs.h>
+#include <stddef.h>
+
+#ifndef __containerof
+#define __containerof(ptr, type, member) ((type *)((char *)(ptr) - offsetof(type, member)))
+#endif
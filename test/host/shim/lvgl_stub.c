@@ -0,0 +1,163 @@
+/*
+ * LVGL 8 display and refresh stand-in for the host build, see lvgl.h
+ */
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lvgl.h"
+
+static uint32_t s_inactive_ms;
+
+void lv_disp_draw_buf_init(lv_disp_draw_buf_t *draw_buf, void *buf1, void *buf2, uint32_t size_in_px_cnt)
+{
+    memset(draw_buf, 0, sizeof(lv_disp_draw_buf_t));
+    draw_buf->buf1 = buf1;
+    draw_buf->buf2 = buf2;
+    draw_buf->buf_act = buf1;
+    draw_buf->size = size_in_px_cnt;
+}
+
+void lv_disp_drv_init(lv_disp_drv_t *driver)
+{
+    memset(driver, 0, sizeof(lv_disp_drv_t));
+}
+
+lv_disp_t *lv_disp_drv_register(lv_disp_drv_t *driver)
+{
+    lv_disp_t *disp = calloc(1, sizeof(lv_disp_t));
+    if (disp) {
+        disp->driver = driver;
+        disp->inactive_ms = s_inactive_ms;
+    }
+    return disp;
+}
+
+void lv_disp_remove(lv_disp_t *disp)
+{
+    free(disp);
+}
+
+void lv_disp_flush_ready(lv_disp_drv_t *disp_drv)
+{
+    __atomic_store_n(&disp_drv->flushing, 0, __ATOMIC_SEQ_CST);
+}
+
+void lv_disp_set_rotation(lv_disp_t *disp, lv_disp_rot_t rotation)
+{
+    disp->driver->rotated = rotation;
+    if (disp->driver->drv_update_cb) {
+        disp->driver->drv_update_cb(disp->driver);
+    }
+}
+
+lv_obj_t *lv_disp_get_scr_act(lv_disp_t *disp)
+{
+    (void)disp;
+    return NULL;
+}
+
+void lv_obj_invalidate(const lv_obj_t *obj)
+{
+    (void)obj;
+}
+
+void lv_obj_scroll_by(lv_obj_t *obj, lv_coord_t dx, lv_coord_t dy, lv_anim_enable_t anim_en)
+{
+    (void)obj;
+    (void)dx;
+    (void)dy;
+    (void)anim_en;
+}
+
+uint32_t lv_disp_get_inactive_time(const lv_disp_t *disp)
+{
+    return disp ? disp->inactive_ms : s_inactive_ms;
+}
+
+void host_lvgl_set_inactive_time(lv_disp_t *disp, uint32_t ms)
+{
+    if (disp) {
+        disp->inactive_ms = ms;
+    } else {
+        s_inactive_ms = ms;
+    }
+}
+
+void host_lvgl_wait_flush(lv_disp_t *disp)
+{
+    while (__atomic_load_n(&disp->driver->flushing, __ATOMIC_SEQ_CST)) {
+        sched_yield();
+    }
+}
+
+// Rows of the area that fit the draw buffer and stay whole after rounding, as get_max_row() in lv_refr.c
+static int host_lvgl_max_row(lv_disp_drv_t *drv, int area_w, int area_h)
+{
+    int max_row = drv->draw_buf->size / area_w;
+    if (max_row > area_h) {
+        max_row = area_h;
+    }
+    if (drv->rounder_cb) {
+        lv_area_t tmp = {0};
+        int h_tmp = max_row;
+        do {
+            tmp.y1 = 0;
+            tmp.y2 = h_tmp - 1;
+            drv->rounder_cb(drv, &tmp);
+            if (tmp.y2 - tmp.y1 + 1 <= max_row) {
+                break;
+            }
+            h_tmp--;
+        } while (h_tmp > 0);
+        max_row = h_tmp > 0 ? tmp.y2 + 1 : 0;
+    }
+    return max_row;
+}
+
+int host_lvgl_refresh(lv_disp_t *disp, const lv_area_t *area, host_lvgl_pixel_cb_t pixel, void *ctx)
+{
+    lv_disp_drv_t *drv = disp->driver;
+    bool rotated = drv->rotated == LV_DISP_ROT_90 || drv->rotated == LV_DISP_ROT_270;
+    int hor_res = rotated ? drv->ver_res : drv->hor_res;
+    int ver_res = rotated ? drv->hor_res : drv->ver_res;
+    lv_area_t inv = *area;
+    if (drv->rounder_cb) {
+        drv->rounder_cb(drv, &inv);
+    }
+    inv.x1 = inv.x1 < 0 ? 0 : inv.x1;
+    inv.y1 = inv.y1 < 0 ? 0 : inv.y1;
+    inv.x2 = inv.x2 >= hor_res ? hor_res - 1 : inv.x2;
+    inv.y2 = inv.y2 >= ver_res ? ver_res - 1 : inv.y2;
+    int w = inv.x2 - inv.x1 + 1;
+    int max_row = host_lvgl_max_row(drv, w, inv.y2 - inv.y1 + 1);
+    if (max_row <= 0) {
+        return 0;
+    }
+
+    int flushes = 0;
+    for (int row = inv.y1; row <= inv.y2; row += max_row) {
+        lv_area_t strip = {inv.x1, row, inv.x2, row + max_row - 1};
+        if (strip.y2 > inv.y2) {
+            strip.y2 = inv.y2;
+        }
+        // With one buffer the previous strip must be on the bus before it is overwritten
+        if (!drv->draw_buf->buf2) {
+            host_lvgl_wait_flush(disp);
+        }
+        uint8_t *buf = drv->draw_buf->buf_act;
+        for (int y = strip.y1; y <= strip.y2; y++) {
+            for (int x = strip.x1; x <= strip.x2; x++) {
+                lv_color_t color = {.full = !pixel(x, y, ctx)};
+                drv->set_px_cb(drv, buf, w, x - strip.x1, y - strip.y1, color, 0xFF);
+            }
+        }
+        host_lvgl_wait_flush(disp);
+        __atomic_store_n(&drv->flushing, 1, __ATOMIC_SEQ_CST);
+        drv->flush_cb(drv, &strip, (lv_color_t *)buf);
+        flushes++;
+        if (drv->draw_buf->buf2) {
+            drv->draw_buf->buf_act = buf == drv->draw_buf->buf1 ? drv->draw_buf->buf2 : drv->draw_buf->buf1;
+        }
+    }
+    return flushes;
+}
@@ -0,0 +1,142 @@
+/*
+ * Async flush against a slow bus: LVGL renders the next strip while the previous
+ * one is on the wire, so a frame costs about max(render, bus) instead of the sum
+ */
+#include <string.h>
+#include <time.h>
+#include "esp_lcd_st75256_lvgl.h"
+#include "host_test.h"
+
+#define SCREEN_W 256
+#define SCREEN_H 128
+#define STRIP_PAGES 2
+#define FRAMES 4
+#define BUS_NS_PER_BYTE 4000  // A 512 byte strip holds the bus about 2 ms
+#define RENDER_PAGE_NS 1000000 // A 2 page strip takes about 2 ms to render
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+typedef struct {
+    int frame;
+} render_ctx_t;
+
+// Render time is slept rather than spun, like the bus time: on a single core host a spinning
+// renderer could keep the flush task off the CPU and hide the pipelining this test is about
+static int render_pixel(int x, int y, void *arg)
+{
+    const render_ctx_t *ctx = arg;
+    if (x == 0 && y % 8 == 0) {
+        struct timespec ts = {0, RENDER_PAGE_NS};
+        nanosleep(&ts, NULL);
+    }
+    return ((x + y * 3 + ctx->frame * 7) % 11) < 4;
+}
+
+static bool count_done(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+{
+    __atomic_add_fetch((int *)user_ctx, 1, __ATOMIC_SEQ_CST);
+    return false;
+}
+
+// Real time of FRAMES full frames rendered in strips into a double buffer
+static int64_t run_frames(bool async_flush)
+{
+    host_panel_config_t config = {
+        .stream_io = true,
+        .config.flags.async_flush = async_flush,
+    };
+    host_panel_t *hp = host_panel_new(&config);
+    const esp_lcd_st75256_lvgl_display_cfg_t disp_cfg = {
+        .io_handle = hp->io,
+        .panel_handle = hp->panel,
+        .hres = SCREEN_W,
+        .vres = SCREEN_H,
+        .strip_pages = STRIP_PAGES,
+        .double_buffer = true,
+    };
+    lv_disp_t *disp = esp_lcd_st75256_lvgl_add_disp(&disp_cfg);
+    TEST_ASSERT(disp);
+    hp->bus->real_ns_per_byte = BUS_NS_PER_BYTE;
+
+    render_ctx_t ctx = {0};
+    const lv_area_t area = {0, 0, SCREEN_W - 1, SCREEN_H - 1};
+    int64_t start = now_ns();
+    int flushes = 0;
+    for (ctx.frame = 0; ctx.frame < FRAMES; ctx.frame++) {
+        flushes += host_lvgl_refresh(disp, &area, render_pixel, &ctx);
+    }
+    host_lvgl_wait_flush(disp);
+    int64_t elapsed = now_ns() - start;
+    hp->bus->real_ns_per_byte = 0;
+    TEST_ASSERT_EQUAL(FRAMES * SCREEN_H / (8 * STRIP_PAGES), flushes);
+
+    // Every strip reached the glass, the last frame is what it shows
+    ctx.frame = FRAMES - 1;
+    static uint8_t expected[SCREEN_W * SCREEN_H];
+    for (int y = 0; y < SCREEN_H; y++) {
+        for (int x = 0; x < SCREEN_W; x++) {
+            expected[y * SCREEN_W + x] = ((x + y * 3 + ctx.frame * 7) % 11) < 4;
+        }
+    }
+    const host_orient_t orient = {0};
+    TEST_ASSERT_EQUAL(0, host_check_glass(hp, &orient, 0, 0, expected, SCREEN_W, SCREEN_H));
+
+    TEST_ESP_OK(esp_lcd_st75256_lvgl_remove_disp(disp));
+    host_panel_del(hp);
+    return elapsed;
+}
+
+static void test_render_overlaps_transfer(void)
+{
+    int64_t blocking_ns = run_frames(false);
+    int64_t async_ns = run_frames(true);
+    printf("blocking %.1f ms/frame, async %.1f ms/frame ... ", blocking_ns / 1e6 / FRAMES, async_ns / 1e6 / FRAMES);
+    // Blocking: render + bus per strip. Async: the larger of the two, plus one strip to fill the pipeline.
+    TEST_ASSERT(async_ns * 10 < blocking_ns * 8);
+}
+
+// on_color_trans_done fires once per flush, when the strip has left, not when it was queued
+static void test_done_after_transfer(void)
+{
+    host_panel_config_t config = {
+        .stream_io = true,
+        .config.flags.async_flush = true,
+    };
+    host_panel_t *hp = host_panel_new(&config);
+    int done = 0;
+    const esp_lcd_panel_io_callbacks_t cbs = {.on_color_trans_done = count_done};
+    TEST_ESP_OK(esp_lcd_panel_io_register_event_callbacks(hp->io, &cbs, &done));
+    hp->bus->real_ns_per_byte = BUS_NS_PER_BYTE;
+
+    static uint8_t pages[SCREEN_W * SCREEN_H / 8];
+    memset(pages, 0x5A, sizeof(pages));
+    int64_t start = now_ns();
+    TEST_ESP_OK(esp_lcd_panel_draw_bitmap(hp->panel, 0, 0, SCREEN_W, SCREEN_H, pages));
+    int64_t queued = now_ns() - start;
+    // draw_bitmap returned long before the 4 KB could be on a bus this slow
+    TEST_ASSERT(queued < BUS_NS_PER_BYTE * (int64_t)sizeof(pages) / 4);
+    while (!__atomic_load_n(&done, __ATOMIC_SEQ_CST)) {
+        struct timespec ts = {0, 100000};
+        nanosleep(&ts, NULL);
+    }
+    int64_t completed = now_ns() - start;
+    TEST_ASSERT(completed >= BUS_NS_PER_BYTE * (int64_t)sizeof(pages));
+    TEST_ASSERT_EQUAL(1, done);
+    hp->bus->real_ns_per_byte = 0;
+    host_panel_del(hp);
+}
+
+static const host_test_case_t cases[] = {
+    HOST_TEST_CASE(test_render_overlaps_transfer),
+    HOST_TEST_CASE(test_done_after_transfer),
+};
+
+int main(int argc, char **argv)
+{
+    return host_test_main(argc, argv, cases, sizeof(cases) / sizeof(cases[0]));
+}
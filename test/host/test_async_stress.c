@@ -0,0 +1,361 @@
+/*
+ * Async flush under load: several producers share the flush queue, `on_done`
+ * calls back into the panel from the flush task without blocking on it, locking
+ * calls get through a queue that never drains, and del waits for the flush task
+ */
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "host_test.h"
+
+#define SCREEN_W 256
+#define SCREEN_H 128
+#define QUEUE_LEN 8           // ST75256_FLUSH_QUEUE_LEN
+#define PRODUCERS 4
+#define BAND_W (SCREEN_W / PRODUCERS)
+#define DRAWS 150
+
+static host_panel_t *new_async_panel(bool shadow_fb)
+{
+    host_panel_config_t config = {
+        .stream_io = true,
+        .config.flags = {.async_flush = true, .shadow_fb = shadow_fb},
+    };
+    return host_panel_new(&config);
+}
+
+// Completion of one queued draw, signalled from the flush task
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    int done;
+} completion_t;
+
+static void completion_signal(completion_t *completion)
+{
+    pthread_mutex_lock(&completion->mutex);
+    completion->done++;
+    pthread_cond_broadcast(&completion->cond);
+    pthread_mutex_unlock(&completion->mutex);
+}
+
+static void completion_wait(completion_t *completion, int count)
+{
+    pthread_mutex_lock(&completion->mutex);
+    while (completion->done < count) {
+        pthread_cond_wait(&completion->cond, &completion->mutex);
+    }
+    pthread_mutex_unlock(&completion->mutex);
+}
+
+// Holds the first transfer after `armed` until the test releases it
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool armed;
+    bool entered;
+    bool released;
+} bus_gate_t;
+
+static void gate_hook(mock_i2c_bus_t *bus, uint16_t address, size_t size, void *ctx)
+{
+    bus_gate_t *gate = ctx;
+    pthread_mutex_lock(&gate->mutex);
+    if (gate->armed && !gate->entered) {
+        gate->entered = true;
+        pthread_cond_broadcast(&gate->cond);
+        while (!gate->released) {
+            pthread_cond_wait(&gate->cond, &gate->mutex);
+        }
+    }
+    pthread_mutex_unlock(&gate->mutex);
+}
+
+typedef struct {
+    host_panel_t *hp;
+    completion_t completion;
+    const uint8_t *pages;
+    esp_err_t requeue_ret;
+    esp_err_t stats_ret;
+} requeue_ctx_t;
+
+static void requeue_done(esp_lcd_panel_handle_t panel, void *user_ctx)
+{
+    requeue_ctx_t *ctx = user_ctx;
+    if (!ctx->completion.done) {
+        // The queue is full: this must fail right away instead of waiting on the flush task
+        ctx->requeue_ret = esp_lcd_panel_st75256_queue_bitmap(panel, 0, 0, 8, 8, ctx->pages, requeue_done, ctx);
+        esp_lcd_panel_st75256_stats_t stats;
+        ctx->stats_ret = esp_lcd_panel_st75256_get_stats(panel, &stats);
+    }
+    completion_signal(&ctx->completion);
+}
+
+static void test_on_done_full_queue(void)
+{
+    host_panel_t *hp = new_async_panel(false);
+    bus_gate_t gate = {.mutex = PTHREAD_MUTEX_INITIALIZER, .cond = PTHREAD_COND_INITIALIZER, .armed = true};
+    hp->bus->hook = gate_hook;
+    hp->bus->hook_ctx = &gate;
+    uint8_t pages[8];
+    memset(pages, 0xFF, sizeof(pages));
+    requeue_ctx_t ctx = {
+        .hp = hp,
+        .completion = {.mutex = PTHREAD_MUTEX_INITIALIZER, .cond = PTHREAD_COND_INITIALIZER},
+        .pages = pages,
+        .requeue_ret = ESP_FAIL,
+        .stats_ret = ESP_FAIL,
+    };
+
+    // The flush task is stuck in the first draw while the queue fills up behind it
+    TEST_ESP_OK(esp_lcd_panel_st75256_queue_bitmap(hp->panel, 0, 0, 8, 8, pages, requeue_done, &ctx));
+    pthread_mutex_lock(&gate.mutex);
+    while (!gate.entered) {
+        pthread_cond_wait(&gate.cond, &gate.mutex);
+    }
+    pthread_mutex_unlock(&gate.mutex);
+    for (int i = 0; i < QUEUE_LEN; i++) {
+        TEST_ESP_OK(esp_lcd_panel_st75256_fill_rect(hp->panel, 8 * i, 64, 8 * i + 8, 72, 0xFF));
+    }
+    pthread_mutex_lock(&gate.mutex);
+    gate.released = true;
+    pthread_cond_broadcast(&gate.cond);
+    pthread_mutex_unlock(&gate.mutex);
+
+    completion_wait(&ctx.completion, 1);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ctx.requeue_ret);
+    TEST_ESP_OK(ctx.stats_ret);
+    // A locking call from here waits for the fills, on_done queued nothing more
+    esp_lcd_panel_st75256_stats_t stats;
+    TEST_ESP_OK(esp_lcd_panel_st75256_get_stats(hp->panel, &stats));
+    TEST_ASSERT_EQUAL(1, ctx.completion.done);
+    for (int x = 0; x < 8 * QUEUE_LEN; x++) {
+        TEST_ASSERT_EQUAL(1, st75256_model_pixel(&hp->model, x, 64));
+    }
+    host_panel_del(hp);
+}
+
+// One producer: draws into its own band, waits for each on_done before reusing its buffer
+typedef struct {
+    host_panel_t *hp;
+    int index;
+    completion_t completion;
+    uint8_t *image;           // Last image drawn, what the band must show
+    int chained;              // Draws queued from on_done
+    int chain_full;           // on_done found the queue full
+    bool last_chained;        // The fill after the latest draw was queued
+    int errors;
+} producer_t;
+
+static void producer_done(esp_lcd_panel_handle_t panel, void *user_ctx)
+{
+    producer_t *producer = user_ctx;
+    // Calls that take the panel or queue from the flush task must not wait for it
+    esp_lcd_panel_st75256_stats_t stats;
+    if (esp_lcd_panel_st75256_get_stats(panel, &stats) != ESP_OK) {
+        producer->errors++;
+    }
+    if (producer->index == 0) {
+        // A harmless extra job from on_done: a fill the next draw of the band covers
+        esp_err_t ret = esp_lcd_panel_st75256_fill_rect(panel, 0, 0, 8, 8, 0x00);
+        producer->last_chained = ret == ESP_OK;
+        if (ret == ESP_OK) {
+            producer->chained++;
+        } else if (ret == ESP_ERR_INVALID_STATE) {
+            producer->chain_full++;
+        } else {
+            producer->errors++;
+        }
+    }
+    completion_signal(&producer->completion);
+}
+
+static void *producer_run(void *arg)
+{
+    producer_t *producer = arg;
+    int x0 = producer->index * BAND_W;
+    for (int i = 0; i < DRAWS; i++) {
+        free(producer->image);
+        producer->image = host_random_image(BAND_W, SCREEN_H, producer->index * 1000 + i + 1);
+        uint8_t *pages = host_pack_lvgl_pages(producer->image, BAND_W, SCREEN_H);
+        if (esp_lcd_panel_st75256_queue_bitmap(producer->hp->panel, x0, 0, x0 + BAND_W, SCREEN_H, pages, producer_done, producer) != ESP_OK) {
+            producer->errors++;
+            free(pages);
+            break;
+        }
+        if (i % 16 == 0 && producer->index == 1) {
+            // Settings are queued in order with the draws
+            if (esp_lcd_panel_invert_color(producer->hp->panel, true) != ESP_OK ||
+                    esp_lcd_panel_invert_color(producer->hp->panel, false) != ESP_OK) {
+                producer->errors++;
+            }
+        }
+        completion_wait(&producer->completion, i + 1);
+        free(pages);
+    }
+    return NULL;
+}
+
+static void test_concurrent_producers(void)
+{
+    for (int shadow_fb = 0; shadow_fb < 2; shadow_fb++) {
+        host_panel_t *hp = new_async_panel(shadow_fb);
+        producer_t producers[PRODUCERS];
+        pthread_t threads[PRODUCERS];
+        for (int i = 0; i < PRODUCERS; i++) {
+            producers[i] = (producer_t) {
+                .hp = hp,
+                .index = i,
+                .completion = {.mutex = PTHREAD_MUTEX_INITIALIZER, .cond = PTHREAD_COND_INITIALIZER},
+            };
+            TEST_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL, producer_run, &producers[i]));
+        }
+        for (int i = 0; i < PRODUCERS; i++) {
+            pthread_join(threads[i], NULL);
+        }
+
+        // A locking call waits for every queued job, the chained fill of band 0 included
+        esp_lcd_panel_st75256_stats_t stats;
+        TEST_ESP_OK(esp_lcd_panel_st75256_get_stats(hp->panel, &stats));
+        const host_orient_t orient = {0};
+        for (int i = 0; i < PRODUCERS; i++) {
+            TEST_ASSERT_EQUAL(0, producers[i].errors);
+            TEST_ASSERT_EQUAL(DRAWS, producers[i].completion.done);
+            if (i == 0) {
+                TEST_ASSERT_EQUAL(DRAWS, producers[i].chained + producers[i].chain_full);
+                for (int y = 0; y < 8 && producers[i].last_chained; y++) {
+                    // The last fill ran after the last draw of the band
+                    memset(producers[i].image + y * BAND_W, 0, 8);
+                }
+            }
+            TEST_ASSERT_EQUAL(0, host_check_glass(hp, &orient, i * BAND_W, 0, producers[i].image, BAND_W, SCREEN_H));
+            free(producers[i].image);
+        }
+        TEST_ASSERT(!hp->model.invert);
+        host_panel_del(hp);
+    }
+}
+
+static void sleep_ms(int ms)
+{
+    struct timespec ts = {ms / 1000, (ms % 1000) * 1000000L};
+    nanosleep(&ts, NULL);
+}
+
+// Keeps the flush queue full of full screen draws until told to stop
+typedef struct {
+    host_panel_t *hp;
+    const uint8_t *pages;
+    volatile bool stop;
+    int errors;
+} flooder_t;
+
+static void *flooder_run(void *arg)
+{
+    flooder_t *flooder = arg;
+    while (!flooder->stop) {
+        if (esp_lcd_panel_draw_bitmap(flooder->hp->panel, 0, 0, SCREEN_W, SCREEN_H, flooder->pages) != ESP_OK) {
+            flooder->errors++;
+        }
+    }
+    return NULL;
+}
+
+typedef struct {
+    host_panel_t *hp;
+    int calls;
+    volatile bool done;
+} locker_t;
+
+static void *locker_run(void *arg)
+{
+    locker_t *locker = arg;
+    esp_lcd_panel_st75256_stats_t stats;
+    int start_line;
+    uint32_t idle_ms;
+    for (int i = 0; i < 10; i++) {
+        locker->calls += esp_lcd_panel_st75256_get_stats(locker->hp->panel, &stats) == ESP_OK;
+        locker->calls += esp_lcd_panel_st75256_get_scroll(locker->hp->panel, &start_line) == ESP_OK;
+        locker->calls += esp_lcd_panel_st75256_get_idle_time(locker->hp->panel, &idle_ms) == ESP_OK;
+    }
+    locker->done = true;
+    return NULL;
+}
+
+// Producers that never let the queue drain: a locking call only waits for the jobs queued before it
+static void test_lock_under_flood(void)
+{
+    host_panel_t *hp = new_async_panel(false);
+    hp->bus->real_ns_per_byte = 500;  // About 2 ms per full screen
+    static uint8_t pages[SCREEN_W * SCREEN_H / 8];
+    memset(pages, 0x3C, sizeof(pages));
+    flooder_t flooders[2];
+    pthread_t flooder_threads[2];
+    for (int i = 0; i < 2; i++) {
+        flooders[i] = (flooder_t) {.hp = hp, .pages = pages};
+        TEST_ASSERT_EQUAL(0, pthread_create(&flooder_threads[i], NULL, flooder_run, &flooders[i]));
+    }
+    sleep_ms(20);
+
+    locker_t locker = {.hp = hp};
+    pthread_t locker_thread;
+    TEST_ASSERT_EQUAL(0, pthread_create(&locker_thread, NULL, locker_run, &locker));
+    // 30 calls, each behind at most a full queue of 2 ms draws
+    for (int ms = 0; ms < 5000 && !locker.done; ms += 10) {
+        sleep_ms(10);
+    }
+    TEST_ASSERT(locker.done);
+    pthread_join(locker_thread, NULL);
+    TEST_ASSERT_EQUAL(30, locker.calls);
+
+    for (int i = 0; i < 2; i++) {
+        flooders[i].stop = true;
+    }
+    for (int i = 0; i < 2; i++) {
+        pthread_join(flooder_threads[i], NULL);
+        TEST_ASSERT_EQUAL(0, flooders[i].errors);
+    }
+    hp->bus->real_ns_per_byte = 0;
+    host_panel_del(hp);
+}
+
+typedef struct {
+    volatile bool entered;
+    volatile bool finished;
+} slow_done_t;
+
+static void slow_done(esp_lcd_panel_handle_t panel, void *user_ctx)
+{
+    slow_done_t *ctx = user_ctx;
+    ctx->entered = true;
+    sleep_ms(20);
+    ctx->finished = true;
+}
+
+// del while the flush task is inside a callback, after it released the lock: the callback runs to its end
+static void test_del_during_on_done(void)
+{
+    host_panel_t *hp = new_async_panel(false);
+    uint8_t pages[8];
+    memset(pages, 0xFF, sizeof(pages));
+    slow_done_t ctx = {0};
+    TEST_ESP_OK(esp_lcd_panel_st75256_queue_bitmap(hp->panel, 0, 0, 8, 8, pages, slow_done, &ctx));
+    while (!ctx.entered) {
+        sleep_ms(1);
+    }
+    host_panel_del(hp);
+    TEST_ASSERT(ctx.finished);
+}
+
+static const host_test_case_t cases[] = {
+    HOST_TEST_CASE(test_on_done_full_queue),
+    HOST_TEST_CASE(test_concurrent_producers),
+    HOST_TEST_CASE(test_lock_under_flood),
+    HOST_TEST_CASE(test_del_during_on_done),
+};
+
+int main(int argc, char **argv)
+{
+    return host_test_main(argc, argv, cases, sizeof(cases) / sizeof(cases[0]));
+}
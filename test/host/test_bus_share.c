@@ -0,0 +1,330 @@
+/*
+ * Bus sharing: pixel data split into transactions that fit bus_share_max_hold_us,
+ * the RAM window reopened at the right line after every slice, and other clients
+ * on the bus waiting no longer than one slice. Time is the mock bus's virtual time.
+ */
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+#include "esp_lcd_panel_io_st75256.h"
+#include "host_shim.h"
+#include "host_test.h"
+
+#define PANEL_ADDRESS 0x3C
+#define SCREEN_W 256
+#define SCREEN_H 128
+#define WINDOW_COST 20        // ST75256_WINDOW_COST: bus bytes the driver budgets for reopening a window
+#define TIME_SLACK_US 50      // Virtual clock ticks of the driver's own esp_timer_get_time() calls
+
+// Wire time of a transaction of `size` bytes after the address, as the mock bus takes it
+static int64_t trans_us(size_t size, uint32_t scl_speed_hz)
+{
+    return (int64_t)(size + 1) * 9 * 1000000 / scl_speed_hz;
+}
+
+static host_panel_t *new_shared_panel(uint32_t scl_speed_hz, uint16_t max_hold_us)
+{
+    host_panel_config_t config = {
+        .stream_io = true,
+        .scl_speed_hz = scl_speed_hz,
+        .config.bus_share_max_hold_us = max_hold_us,
+    };
+    return host_panel_new(&config);
+}
+
+// What one panel transaction carried: the RAM window in effect and the pixel bytes
+typedef struct {
+    uint8_t window[4];        // col_start, col_end, page_start, page_end
+    bool write_ram;           // 0x5C in this transaction: the address counter is back at the window origin
+    size_t data_bytes;
+} decoded_t;
+
+// Decode the Co/A0 control bytes of a panel transaction, carrying the window over from the previous ones
+static void decode_transaction(const uint8_t *bytes, size_t size, uint8_t *cmd_set, uint8_t window[4], decoded_t *out)
+{
+    uint8_t cmd = 0;
+    int num_params = 0;
+    out->write_ram = false;
+    out->data_bytes = 0;
+    for (size_t i = 0; i < size;) {
+        uint8_t ctrl = bytes[i++];
+        bool a0 = ctrl & 0x40;
+        if (!(ctrl & 0x80) && a0) {
+            out->data_bytes = size - i;
+            break;
+        }
+        if (i >= size) {
+            break;
+        }
+        uint8_t byte = bytes[i++];
+        if (!a0) {
+            cmd = byte;
+            num_params = 0;
+            if (cmd == 0x30 || cmd == 0x31) {
+                *cmd_set = cmd;
+            } else if (cmd == 0x5C && *cmd_set == 0x30) {
+                out->write_ram = true;
+            }
+        } else if (*cmd_set == 0x30 && num_params < 2) {
+            if (cmd == 0x15) {
+                window[num_params] = byte;
+            } else if (cmd == 0x75) {
+                window[2 + num_params] = byte;
+            }
+            num_params++;
+        }
+    }
+    memcpy(out->window, window, 4);
+}
+
+/*
+ * Check the panel transactions logged since the bus was cleared, for one draw of
+ * `columns` x `pages`: every slice fits the hold time (or is a single line if a line
+ * does not fit), and every slice after the first reopens the window the first one
+ * opened at the line it left off. Where the window sits is up to host_check_glass().
+ */
+static void check_slices(host_panel_t *hp, uint32_t scl_speed_hz, uint16_t max_hold_us, int columns, int pages, bool page_first)
+{
+    mock_i2c_bus_t *bus = hp->bus;
+    size_t line = page_first ? pages : columns;
+    size_t total = columns * pages;
+    size_t slice = (size_t)max_hold_us * scl_speed_hz / 9 / 1000000 - WINDOW_COST;
+    bool line_fits = line <= slice;
+
+    uint8_t cmd_set = 0x30;
+    uint8_t window[4] = {0};
+    uint8_t full_window[4] = {0};
+    size_t sent = 0;
+    int slices = 0;
+    for (size_t t = 0; t < bus->log_len; t++) {
+        const mock_i2c_trans_t *trans = &bus->log[t];
+        if (trans->address != PANEL_ADDRESS) {
+            continue;
+        }
+        decoded_t decoded;
+        decode_transaction(bus->bytes + trans->offset, trans->size, &cmd_set, window, &decoded);
+        if (!decoded.data_bytes) {
+            continue;
+        }
+        if (line_fits) {
+            TEST_ASSERT(trans_us(trans->size, scl_speed_hz) <= max_hold_us);
+            TEST_ASSERT(decoded.data_bytes <= slice);
+        } else {
+            TEST_ASSERT_EQUAL(line, decoded.data_bytes);
+        }
+        // Slices end on line boundaries, the last one takes the rest
+        TEST_ASSERT(decoded.data_bytes % line == 0 || sent + decoded.data_bytes == total);
+        TEST_ASSERT(decoded.write_ram);
+        if (!slices) {
+            memcpy(full_window, decoded.window, 4);
+            TEST_ASSERT_EQUAL(columns, full_window[1] - full_window[0] + 1);
+            TEST_ASSERT_EQUAL(pages, full_window[3] - full_window[2] + 1);
+        } else {
+            // st75256_resume_ddram_window(): the start moves by the lines sent, the rest of the window stays
+            uint8_t expected[4];
+            memcpy(expected, full_window, 4);
+            expected[page_first ? 0 : 2] += sent / line;
+            TEST_ASSERT(!memcmp(expected, decoded.window, 4));
+        }
+        sent += decoded.data_bytes;
+        slices++;
+    }
+    TEST_ASSERT_EQUAL(total, sent);
+    TEST_ASSERT(slices > 1);
+}
+
+static void draw_random(host_panel_t *hp, const host_orient_t *orient, int x0, int y0, int w, int h, uint32_t seed)
+{
+    uint8_t *image = host_random_image(w, h, seed);
+    uint8_t *pages = host_pack_lvgl_pages(image, w, h);
+    mock_i2c_bus_clear(hp->bus);
+    TEST_ESP_OK(esp_lcd_panel_draw_bitmap(hp->panel, x0, y0, x0 + w, y0 + h, pages));
+    TEST_ASSERT_EQUAL(0, host_check_glass(hp, orient, x0, y0, image, w, h));
+    free(pages);
+    free(image);
+}
+
+static void test_slices_fit_hold_limit(void)
+{
+    const uint32_t scl_speeds[] = {400000, 800000};
+    const uint16_t hold_limits[] = {1000, 3000, 8000};
+    for (int s = 0; s < 2; s++) {
+        for (int l = 0; l < 3; l++) {
+            for (int swap = 0; swap < 2; swap++) {
+                host_panel_t *hp = new_shared_panel(scl_speeds[s], hold_limits[l]);
+                const host_orient_t orient = {.swap_xy = swap};
+                host_panel_orient(hp, &orient);
+                int w = swap ? SCREEN_H : SCREEN_W;
+                int h = swap ? SCREEN_W : SCREEN_H;
+                draw_random(hp, &orient, 0, 0, w, h, s * 10 + l * 2 + swap + 1);
+                check_slices(hp, scl_speeds[s], hold_limits[l], SCREEN_W, SCREEN_H / 8, swap);
+                host_panel_del(hp);
+            }
+        }
+    }
+}
+
+// Partial areas with a gap and mirroring: the resumed window starts inside the area, not at its edge
+static void test_resume_window(void)
+{
+    // Landscape: 160 columns x 10 pages, one page of gap, both axes mirrored
+    host_panel_t *hp = new_shared_panel(800000, 2000);
+    host_orient_t orient = {.mirror_x = true, .mirror_y = true, .y_gap = 8};
+    host_panel_orient(hp, &orient);
+    draw_random(hp, &orient, 40, 16, 160, 80, 21);
+    check_slices(hp, 800000, 2000, 160, 10, false);
+    host_panel_del(hp);
+
+    // Portrait: 128 columns x 10 pages, a 16 column gap, both axes mirrored
+    hp = new_shared_panel(400000, 1000);
+    orient = (host_orient_t) {.swap_xy = true, .mirror_x = true, .mirror_y = true, .y_gap = 16};
+    host_panel_orient(hp, &orient);
+    draw_random(hp, &orient, 8, 64, 80, 128, 22);
+    check_slices(hp, 400000, 1000, 128, 10, true);
+    host_panel_del(hp);
+}
+
+// Two sensors sampling on the same bus, served between panel transactions as soon as they are due
+#define NUM_SENSORS 2
+
+typedef struct {
+    uint16_t address;
+    size_t size;
+    int64_t period_us;
+    int64_t next_due_us;
+    int64_t max_latency_us;
+    int samples;
+} sensor_t;
+
+typedef struct {
+    sensor_t sensors[NUM_SENSORS];
+    uint32_t scl_speed_hz;
+} sensors_t;
+
+static void serve_sensors(mock_i2c_bus_t *bus, sensors_t *sensors)
+{
+    while (true) {
+        // Earliest due first, the bus is free right now
+        sensor_t *next = NULL;
+        int64_t now = esp_timer_get_time();
+        for (int i = 0; i < NUM_SENSORS; i++) {
+            sensor_t *sensor = &sensors->sensors[i];
+            if (sensor->next_due_us <= now && (!next || sensor->next_due_us < next->next_due_us)) {
+                next = sensor;
+            }
+        }
+        if (!next) {
+            return;
+        }
+        next->max_latency_us = MAX(next->max_latency_us, now - next->next_due_us);
+        mock_i2c_bus_client_transmit(bus, next->address, next->size, sensors->scl_speed_hz, NULL);
+        next->next_due_us += next->period_us;
+        next->samples++;
+    }
+}
+
+// The bus left to the sensors for `us`: each is served when it comes due
+static void idle_bus(mock_i2c_bus_t *bus, sensors_t *sensors, int64_t us)
+{
+    int64_t end = esp_timer_get_time() + us;
+    for (int64_t now = esp_timer_get_time(); now < end; now = esp_timer_get_time()) {
+        serve_sensors(bus, sensors);
+        int64_t next_due = end;
+        for (int i = 0; i < NUM_SENSORS; i++) {
+            next_due = MIN(next_due, sensors->sensors[i].next_due_us);
+        }
+        host_time_advance(MAX(next_due - esp_timer_get_time(), 0));
+    }
+}
+
+static void sensor_hook(mock_i2c_bus_t *bus, uint16_t address, size_t size, void *ctx)
+{
+    if (address == PANEL_ADDRESS) {
+        serve_sensors(bus, ctx);
+    }
+}
+
+static void run_sensors(uint16_t max_hold_us, sensors_t *sensors, int64_t *panel_max_us, uint32_t *hold_max_us)
+{
+    const uint32_t scl_speed_hz = 800000;
+    host_panel_t *hp = new_shared_panel(scl_speed_hz, max_hold_us);
+    const host_orient_t orient = {0};
+    *sensors = (sensors_t) {
+        .sensors = {
+            {.address = 0x48, .size = 6, .period_us = 5000},
+            {.address = 0x68, .size = 14, .period_us = 1500},
+        },
+        .scl_speed_hz = scl_speed_hz,
+    };
+    int64_t now = esp_timer_get_time();
+    for (int i = 0; i < NUM_SENSORS; i++) {
+        sensors->sensors[i].next_due_us = now + sensors->sensors[i].period_us;
+    }
+    TEST_ESP_OK(esp_lcd_panel_st75256_reset_stats(hp->panel));
+    mock_i2c_bus_clear(hp->bus);
+    hp->bus->hook = sensor_hook;
+    hp->bus->hook_ctx = sensors;
+    uint8_t *image = host_random_image(SCREEN_W, SCREEN_H, 31);
+    uint8_t *pages = host_pack_lvgl_pages(image, SCREEN_W, SCREEN_H);
+    for (int frame = 0; frame < 3; frame++) {
+        TEST_ESP_OK(esp_lcd_panel_draw_bitmap(hp->panel, 0, 0, SCREEN_W, SCREEN_H, pages));
+        // The rest of the frame time the bus is the sensors'
+        idle_bus(hp->bus, sensors, 20000);
+    }
+    hp->bus->hook = NULL;
+    TEST_ASSERT_EQUAL(0, host_check_glass(hp, &orient, 0, 0, image, SCREEN_W, SCREEN_H));
+
+    *panel_max_us = 0;
+    for (size_t t = 0; t < hp->bus->log_len; t++) {
+        if (hp->bus->log[t].address == PANEL_ADDRESS) {
+            *panel_max_us = MAX(*panel_max_us, trans_us(hp->bus->log[t].size, scl_speed_hz));
+        }
+    }
+    esp_lcd_panel_st75256_stats_t stats;
+    TEST_ESP_OK(esp_lcd_panel_st75256_get_stats(hp->panel, &stats));
+    *hold_max_us = stats.bus_hold_max_us;
+    free(pages);
+    free(image);
+    host_panel_del(hp);
+}
+
+static void test_competing_clients(void)
+{
+    const uint16_t max_hold_us = 4000;
+    sensors_t sensors;
+    int64_t panel_max_us;
+    uint32_t hold_max_us;
+    run_sensors(max_hold_us, &sensors, &panel_max_us, &hold_max_us);
+    printf("slice %" PRId64 " us, sensor wait %" PRId64 "/%" PRId64 " us ... ", panel_max_us,
+           sensors.sensors[0].max_latency_us, sensors.sensors[1].max_latency_us);
+    TEST_ASSERT(panel_max_us <= max_hold_us);
+    // The driver reports the panel's own longest transaction, not the time it waited for the sensors
+    TEST_ASSERT(hold_max_us >= panel_max_us);
+    TEST_ASSERT(hold_max_us <= panel_max_us + TIME_SLACK_US);
+    for (int i = 0; i < NUM_SENSORS; i++) {
+        const sensor_t *sensor = &sensors.sensors[i];
+        const sensor_t *other = &sensors.sensors[1 - i];
+        TEST_ASSERT(sensor->samples > 10);
+        // A sensor waits for at most one panel slice and one transfer of the other sensor
+        TEST_ASSERT(sensor->max_latency_us <= panel_max_us + trans_us(other->size, sensors.scl_speed_hz) + TIME_SLACK_US);
+    }
+
+    // Without bus sharing a sensor waits for most of a frame
+    run_sensors(0, &sensors, &panel_max_us, &hold_max_us);
+    TEST_ASSERT(panel_max_us > 10 * max_hold_us);
+    TEST_ASSERT(sensors.sensors[1].max_latency_us > 5 * max_hold_us);
+    TEST_ASSERT(hold_max_us >= panel_max_us);
+    TEST_ASSERT(hold_max_us <= panel_max_us + TIME_SLACK_US);
+}
+
+static const host_test_case_t cases[] = {
+    HOST_TEST_CASE(test_slices_fit_hold_limit),
+    HOST_TEST_CASE(test_resume_window),
+    HOST_TEST_CASE(test_competing_clients),
+};
+
+int main(int argc, char **argv)
+{
+    return host_test_main(argc, argv, cases, sizeof(cases) / sizeof(cases[0]));
+}
@@ -0,0 +1,177 @@
+/*
+ * Adaptive frame rate: the flush cadence raises the controller frame rate (0xF0 of
+ * command set 2), the idle timer lowers it again, on the virtual clock
+ */
+#include <string.h>
+#include "host_shim.h"
+#include "host_test.h"
+
+#define ACTIVE_CODE 0x18
+#define IDLE_CODE   0x06
+
+static void draw_page(host_panel_t *hp, uint8_t fill)
+{
+    uint8_t page[32];
+    memset(page, fill, sizeof(page));
+    TEST_ESP_OK(esp_lcd_panel_draw_bitmap(hp->panel, 0, 0, sizeof(page), 8, page));
+}
+
+// The code the controller received last, for all four temperature ranges
+static void expect_frame_rate(const host_panel_t *hp, uint8_t code)
+{
+    const st75256_model_cmd_t *entry = st75256_model_find(&hp->model, 1, 0xF0);
+    TEST_ASSERT(entry);
+    TEST_ASSERT_EQUAL(4, entry->num_params);
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(code, entry->params[i]);
+        TEST_ASSERT_EQUAL(code, hp->model.frame_rate[i]);
+    }
+}
+
+static esp_lcd_panel_st75256_stats_t get_stats(const host_panel_t *hp)
+{
+    esp_lcd_panel_st75256_stats_t stats;
+    TEST_ESP_OK(esp_lcd_panel_st75256_get_stats(hp->panel, &stats));
+    return stats;
+}
+
+// Slow flushes keep the idle code, fast ones raise it once the smoothed cadence reaches active_fps
+// (10 by default), idle_ms (500 by default) after the last flush it goes back
+static void test_cadence(void)
+{
+    for (int stream_io = 0; stream_io < 2; stream_io++) {
+        host_panel_config_t config = {
+            .stream_io = stream_io,
+            .config.frame_rate = {.active = ACTIVE_CODE, .idle = IDLE_CODE},
+        };
+        host_panel_t *hp = host_panel_new(&config);
+        expect_frame_rate(hp, IDLE_CODE);
+        TEST_ASSERT_EQUAL(IDLE_CODE, get_stats(hp).frame_rate);
+
+        // 2.5 flushes per second: the cadence settles towards 400 ms, the rate stays
+        st75256_model_clear_log(&hp->model);
+        for (int i = 0; i < 10; i++) {
+            host_time_advance(400 * 1000);
+            host_timer_run_due();
+            draw_page(hp, i);
+        }
+        esp_lcd_panel_st75256_stats_t stats = get_stats(hp);
+        TEST_ASSERT(stats.flush_interval_us >= 400000 && stats.flush_interval_us < 450000);
+        TEST_ASSERT_EQUAL(IDLE_CODE, stats.frame_rate);
+        TEST_ASSERT_EQUAL(0, stats.frame_rate_switches);
+        TEST_ASSERT_EQUAL(0, st75256_model_count(&hp->model, 1, 0xF0));
+
+        // 50 flushes per second: the flush that brings the cadence to 100 ms or less sends the active code
+        bool raised = false;
+        for (int i = 0; i < 20; i++) {
+            host_time_advance(20 * 1000);
+            host_timer_run_due();
+            draw_page(hp, i);
+            stats = get_stats(hp);
+            bool animating = stats.flush_interval_us <= 100000;
+            TEST_ASSERT(!raised || animating);
+            raised = animating;
+            TEST_ASSERT_EQUAL(animating ? ACTIVE_CODE : IDLE_CODE, stats.frame_rate);
+            TEST_ASSERT_EQUAL(animating, stats.frame_rate_switches);
+            TEST_ASSERT_EQUAL(animating, st75256_model_count(&hp->model, 1, 0xF0));
+        }
+        TEST_ASSERT(raised);
+        TEST_ASSERT(stats.flush_interval_us < 30000);
+        expect_frame_rate(hp, ACTIVE_CODE);
+
+        // The animation stops: the idle code idle_ms after the last flush, the pause shows in the cadence
+        host_time_advance(490 * 1000);
+        host_timer_run_due();
+        TEST_ASSERT_EQUAL(ACTIVE_CODE, hp->model.frame_rate[0]);
+        host_time_advance(20 * 1000);
+        TEST_ASSERT(host_timer_run_due() > 0);
+        expect_frame_rate(hp, IDLE_CODE);
+        stats = get_stats(hp);
+        TEST_ASSERT_EQUAL(IDLE_CODE, stats.frame_rate);
+        TEST_ASSERT_EQUAL(2, stats.frame_rate_switches);
+        TEST_ASSERT(stats.flush_interval_us >= 500000);
+        TEST_ASSERT_EQUAL(2, st75256_model_count(&hp->model, 1, 0xF0));
+        host_panel_del(hp);
+    }
+}
+
+// esp_lcd_panel_st75256_set_frame_rate() sends the code matching the cadence at once and survives init
+static void test_set_frame_rate(void)
+{
+    host_panel_config_t config = {.stream_io = true};
+    host_panel_t *hp = host_panel_new(&config);
+    // Left at the reset default without a config
+    TEST_ASSERT_EQUAL(0, st75256_model_count(&hp->model, 1, 0xF0));
+    TEST_ASSERT_EQUAL(0, get_stats(hp).frame_rate);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_lcd_panel_st75256_set_frame_rate(hp->panel, NULL));
+
+    // Static screen: the idle code
+    const esp_lcd_panel_st75256_frame_rate_t slow = {.active = ACTIVE_CODE, .idle = IDLE_CODE, .active_fps = 30, .idle_ms = 200};
+    TEST_ESP_OK(esp_lcd_panel_st75256_set_frame_rate(hp->panel, &slow));
+    expect_frame_rate(hp, IDLE_CODE);
+    TEST_ASSERT_EQUAL(IDLE_CODE, get_stats(hp).frame_rate);
+
+    // active_fps 30: 20 flushes per second do not count as animating, 50 do
+    for (int i = 0; i < 20; i++) {
+        host_time_advance(50 * 1000);
+        host_timer_run_due();
+        draw_page(hp, i);
+    }
+    TEST_ASSERT_EQUAL(IDLE_CODE, hp->model.frame_rate[0]);
+    for (int i = 0; i < 20; i++) {
+        host_time_advance(20 * 1000);
+        host_timer_run_due();
+        draw_page(hp, i);
+    }
+    expect_frame_rate(hp, ACTIVE_CODE);
+    TEST_ASSERT_EQUAL(1, get_stats(hp).frame_rate_switches);
+
+    // New codes while animating: the new active code at once, idle_ms 200 after the last flush the new idle one
+    const esp_lcd_panel_st75256_frame_rate_t other = {.active = 0x1F, .idle = 0x02, .idle_ms = 200};
+    TEST_ESP_OK(esp_lcd_panel_st75256_set_frame_rate(hp->panel, &other));
+    expect_frame_rate(hp, 0x1F);
+    host_time_advance(210 * 1000);
+    host_timer_run_due();
+    expect_frame_rate(hp, 0x02);
+
+    // The setting survives a re-init, which starts from the idle code
+    st75256_model_clear_log(&hp->model);
+    TEST_ESP_OK(esp_lcd_panel_init(hp->panel));
+    expect_frame_rate(hp, 0x02);
+
+    // Equal codes fix the rate: fast flushes send nothing more
+    const esp_lcd_panel_st75256_frame_rate_t fixed = {.active = 0x0C, .idle = 0x0C};
+    TEST_ESP_OK(esp_lcd_panel_st75256_set_frame_rate(hp->panel, &fixed));
+    expect_frame_rate(hp, 0x0C);
+    st75256_model_clear_log(&hp->model);
+    uint32_t switches = get_stats(hp).frame_rate_switches;
+    for (int i = 0; i < 20; i++) {
+        host_time_advance(20 * 1000);
+        host_timer_run_due();
+        draw_page(hp, i);
+    }
+    host_time_advance(1000 * 1000);
+    host_timer_run_due();
+    TEST_ASSERT_EQUAL(0, st75256_model_count(&hp->model, 1, 0xF0));
+    TEST_ASSERT_EQUAL(switches, get_stats(hp).frame_rate_switches);
+
+    // All zero: the driver leaves the frame rate alone from then on
+    TEST_ESP_OK(esp_lcd_panel_st75256_set_frame_rate(hp->panel, &(const esp_lcd_panel_st75256_frame_rate_t) {0}));
+    for (int i = 0; i < 20; i++) {
+        host_time_advance(20 * 1000);
+        draw_page(hp, i);
+    }
+    TEST_ESP_OK(esp_lcd_panel_init(hp->panel));
+    TEST_ASSERT_EQUAL(0, st75256_model_count(&hp->model, 1, 0xF0));
+    host_panel_del(hp);
+}
+
+static const host_test_case_t cases[] = {
+    HOST_TEST_CASE(test_cadence),
+    HOST_TEST_CASE(test_set_frame_rate),
+};
+
+int main(int argc, char **argv)
+{
+    return host_test_main(argc, argv, cases, sizeof(cases) / sizeof(cases[0]));
+}
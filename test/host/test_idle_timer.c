@@ -0,0 +1,103 @@
+/*
+ * Idle timer against panel deletion: a callback still running when del starts must not
+ * touch the timer after esp_timer_delete()
+ */
+#include <pthread.h>
+#include <unistd.h>
+#include "host_shim.h"
+#include "host_test.h"
+
+#define IDLE_MS 100
+
+// Holds the first transfer after `armed` until the test releases it
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool armed;
+    bool entered;
+    bool released;
+} bus_gate_t;
+
+static void gate_hook(mock_i2c_bus_t *bus, uint16_t address, size_t size, void *ctx)
+{
+    bus_gate_t *gate = ctx;
+    pthread_mutex_lock(&gate->mutex);
+    if (gate->armed && !gate->entered) {
+        gate->entered = true;
+        pthread_cond_broadcast(&gate->cond);
+        while (!gate->released) {
+            pthread_cond_wait(&gate->cond, &gate->mutex);
+        }
+    }
+    pthread_mutex_unlock(&gate->mutex);
+}
+
+static void *fire_timer(void *arg)
+{
+    host_timer_fire(arg);
+    return NULL;
+}
+
+static void *del_panel(void *arg)
+{
+    host_panel_del(arg);
+    return NULL;
+}
+
+// The idle job of the timer is in the middle of entering power save when del is called
+static void check_del_during_idle_job(bool async_flush)
+{
+    host_panel_config_t config = {
+        .stream_io = true,
+        .config = {
+            .power_save_idle_ms = IDLE_MS,
+            .flags.async_flush = async_flush,
+        },
+    };
+    host_panel_t *hp = host_panel_new(&config);
+    bus_gate_t gate = {.mutex = PTHREAD_MUTEX_INITIALIZER, .cond = PTHREAD_COND_INITIALIZER, .armed = true};
+    hp->bus->hook = gate_hook;
+    hp->bus->hook_ctx = &gate;
+    int use_after_delete = host_timer_use_after_delete();
+
+    host_time_advance(2 * IDLE_MS * 1000);
+    pthread_t timer_thread;
+    TEST_ASSERT_EQUAL(0, pthread_create(&timer_thread, NULL, fire_timer, host_timer_last()));
+    pthread_mutex_lock(&gate.mutex);
+    while (!gate.entered) {
+        pthread_cond_wait(&gate.cond, &gate.mutex);
+    }
+    pthread_mutex_unlock(&gate.mutex);
+
+    // del starts while the power save commands are on the bus, the job re-arms the timer when done
+    pthread_t del_thread;
+    TEST_ASSERT_EQUAL(0, pthread_create(&del_thread, NULL, del_panel, hp));
+    usleep(20 * 1000);
+    pthread_mutex_lock(&gate.mutex);
+    gate.released = true;
+    pthread_cond_broadcast(&gate.cond);
+    pthread_mutex_unlock(&gate.mutex);
+    pthread_join(timer_thread, NULL);
+    pthread_join(del_thread, NULL);
+    TEST_ASSERT_EQUAL(use_after_delete, host_timer_use_after_delete());
+}
+
+static void test_del_during_idle_job(void)
+{
+    check_del_during_idle_job(false);
+}
+
+static void test_del_during_idle_job_async(void)
+{
+    check_del_during_idle_job(true);
+}
+
+static const host_test_case_t cases[] = {
+    HOST_TEST_CASE(test_del_during_idle_job),
+    HOST_TEST_CASE(test_del_during_idle_job_async),
+};
+
+int main(int argc, char **argv)
+{
+    return host_test_main(argc, argv, cases, sizeof(cases) / sizeof(cases[0]));
+}
@@ -0,0 +1,235 @@
+/*
+ * ST75256 panel IO: the Co/A0 encoding of esp_lcd_panel_io_st75256_tx_stream(),
+ * byte for byte on a mock bus, against the same commands sent one transaction each
+ */
+#include <string.h>
+#include "esp_lcd_panel_io_st75256.h"
+#include "host_test.h"
+
+#define MAX_CMD_BYTES ESP_LCD_PANEL_IO_ST75256_MAX_CMD_BYTES
+
+typedef struct {
+    mock_i2c_bus_t *bus;
+    esp_lcd_panel_io_handle_t io;
+} stream_io_t;
+
+// What the controller receives: each byte with its A0
+typedef struct {
+    uint8_t a0[4096];
+    uint8_t byte[4096];
+    size_t len;
+} received_t;
+
+static void stream_io_new(stream_io_t *sio)
+{
+    sio->bus = mock_i2c_bus_new(NULL);
+    TEST_ASSERT(sio->bus);
+    esp_lcd_panel_io_st75256_config_t config = {
+        .dev_addr = 0x3C,
+        .scl_speed_hz = 400000,
+    };
+    TEST_ESP_OK(esp_lcd_new_panel_io_st75256(sio->bus, &config, &sio->io));
+}
+
+static void stream_io_del(stream_io_t *sio)
+{
+    TEST_ESP_OK(esp_lcd_panel_io_del(sio->io));
+    mock_i2c_bus_del(sio->bus);
+}
+
+// Decode every logged transaction. Strict: a Co=1 control byte carries exactly one byte,
+// and only the last control byte of a transaction may have Co=0.
+static void decode(const mock_i2c_bus_t *bus, received_t *rx)
+{
+    rx->len = 0;
+    for (size_t t = 0; t < bus->log_len; t++) {
+        const uint8_t *bytes = bus->bytes + bus->log[t].offset;
+        size_t size = bus->log[t].size;
+        size_t i = 0;
+        while (i < size) {
+            uint8_t ctrl = bytes[i++];
+            TEST_ASSERT_EQUAL(0, ctrl & 0x3F);
+            if (ctrl & 0x80) {
+                TEST_ASSERT(i < size);
+                rx->a0[rx->len] = (ctrl >> 6) & 0x01;
+                rx->byte[rx->len++] = bytes[i++];
+                // A transaction never ends on a control byte that announces more
+                TEST_ASSERT(i < size);
+            } else {
+                TEST_ASSERT(i < size);
+                while (i < size) {
+                    rx->a0[rx->len] = (ctrl >> 6) & 0x01;
+                    rx->byte[rx->len++] = bytes[i++];
+                }
+            }
+        }
+    }
+}
+
+static void expect_transaction(const mock_i2c_bus_t *bus, size_t index, const uint8_t *expected, size_t size)
+{
+    TEST_ASSERT(index < bus->log_len);
+    TEST_ASSERT_EQUAL(size, bus->log[index].size);
+    const uint8_t *bytes = bus->bytes + bus->log[index].offset;
+    for (size_t i = 0; i < size; i++) {
+        if (bytes[i] != expected[i]) {
+            host_test_fail(__FILE__, __LINE__, "transaction %zu byte %zu: expected 0x%02X, got 0x%02X",
+                           index, i, expected[i], bytes[i]);
+        }
+    }
+}
+
+static void test_stream_encoding(void)
+{
+    stream_io_t sio;
+    stream_io_new(&sio);
+    // Co chains across records, the data phase gets one control byte with A0=1, Co=0
+    const uint8_t cmds[] = {
+        0x30, 0,
+        0x15, 2, 0x10, 0x1F,
+        0x75, 2, 0x02, 0x05,
+        0x5C, 0,
+    };
+    const uint8_t data[] = {0xDE, 0xAD, 0x80, 0x40, 0x00};
+    TEST_ESP_OK(esp_lcd_panel_io_st75256_tx_stream(sio.io, cmds, sizeof(cmds), data, sizeof(data)));
+    const uint8_t expected[] = {
+        0x80, 0x30,
+        0x80, 0x15, 0xC0, 0x10, 0xC0, 0x1F,
+        0x80, 0x75, 0xC0, 0x02, 0xC0, 0x05,
+        0x80, 0x5C,
+        0x40, 0xDE, 0xAD, 0x80, 0x40, 0x00,
+    };
+    TEST_ASSERT_EQUAL(1, sio.bus->log_len);
+    expect_transaction(sio.bus, 0, expected, sizeof(expected));
+
+    // Commands only: the last control byte ends the sequence, no data control byte
+    mock_i2c_bus_clear(sio.bus);
+    const uint8_t cmds_only[] = {0xA6, 0, 0xBC, 1, 0x04};
+    TEST_ESP_OK(esp_lcd_panel_io_st75256_tx_stream(sio.io, cmds_only, sizeof(cmds_only), NULL, 0));
+    expect_transaction(sio.bus, 0, (const uint8_t[]) {0x80, 0xA6, 0x80, 0xBC, 0x40, 0x04}, 6);
+
+    // Data only: a single data control byte
+    mock_i2c_bus_clear(sio.bus);
+    TEST_ESP_OK(esp_lcd_panel_io_st75256_tx_stream(sio.io, NULL, 0, data, 2));
+    expect_transaction(sio.bus, 0, (const uint8_t[]) {0x40, 0xDE, 0xAD}, 3);
+
+    // Nothing to send, nothing on the bus
+    mock_i2c_bus_clear(sio.bus);
+    TEST_ESP_OK(esp_lcd_panel_io_st75256_tx_stream(sio.io, NULL, 0, NULL, 0));
+    TEST_ASSERT_EQUAL(0, sio.bus->log_len);
+    stream_io_del(&sio);
+}
+
+static void test_stream_matches_transactions(void)
+{
+    stream_io_t stream;
+    stream_io_t single;
+    stream_io_new(&stream);
+    stream_io_new(&single);
+    static received_t rx_stream;
+    static received_t rx_single;
+    uint32_t seed = 7;
+    for (int round = 0; round < 200; round++) {
+        // Random records of 0..6 parameters up to the list limit, then optional data
+        uint8_t cmds[MAX_CMD_BYTES];
+        size_t cmds_size = 0;
+        uint8_t data[300];
+        seed = seed * 1103515245 + 12345;
+        size_t data_size = (seed >> 16) % 2 ? (seed >> 8) % sizeof(data) : 0;
+        for (size_t i = 0; i < data_size; i++) {
+            data[i] = i * 37 + round;
+        }
+        mock_i2c_bus_clear(stream.bus);
+        mock_i2c_bus_clear(single.bus);
+        for (;;) {
+            seed = seed * 1103515245 + 12345;
+            uint8_t n = (seed >> 16) % 7;
+            if (cmds_size + 2 + n > MAX_CMD_BYTES || (seed >> 24) % 5 == 0) {
+                break;
+            }
+            uint8_t cmd = seed >> 8;
+            cmds[cmds_size++] = cmd;
+            cmds[cmds_size++] = n;
+            uint8_t *params = cmds + cmds_size;
+            for (int i = 0; i < n; i++) {
+                cmds[cmds_size++] = (seed >> (i % 4 * 8)) ^ i;
+            }
+            // The multi-transaction path of the driver: command with A0=0, parameters as data
+            TEST_ESP_OK(esp_lcd_panel_io_tx_param(single.io, cmd, NULL, 0));
+            if (n) {
+                TEST_ESP_OK(esp_lcd_panel_io_tx_color(single.io, -1, params, n));
+            }
+        }
+        if (data_size) {
+            TEST_ESP_OK(esp_lcd_panel_io_tx_color(single.io, -1, data, data_size));
+        }
+        TEST_ESP_OK(esp_lcd_panel_io_st75256_tx_stream(stream.io, cmds, cmds_size, data, data_size));
+
+        TEST_ASSERT_EQUAL(cmds_size || data_size ? 1 : 0, stream.bus->log_len);
+        decode(stream.bus, &rx_stream);
+        decode(single.bus, &rx_single);
+        TEST_ASSERT_EQUAL(rx_single.len, rx_stream.len);
+        TEST_ASSERT(!memcmp(rx_single.a0, rx_stream.a0, rx_stream.len));
+        TEST_ASSERT(!memcmp(rx_single.byte, rx_stream.byte, rx_stream.len));
+    }
+    stream_io_del(&stream);
+    stream_io_del(&single);
+}
+
+static void test_stream_worst_case(void)
+{
+    stream_io_t sio;
+    stream_io_new(&sio);
+    // One command with the most parameters a list can hold: every byte needs its own control byte
+    uint8_t cmds[MAX_CMD_BYTES + 2];
+    cmds[0] = 0x31;
+    cmds[1] = MAX_CMD_BYTES - 2;
+    for (int i = 0; i < MAX_CMD_BYTES - 2; i++) {
+        cmds[2 + i] = 0xF0 + (i & 0x0F);
+    }
+    const uint8_t data[] = {0x55, 0xAA};
+    TEST_ESP_OK(esp_lcd_panel_io_st75256_tx_stream(sio.io, cmds, MAX_CMD_BYTES, data, sizeof(data)));
+    uint8_t expected[(MAX_CMD_BYTES - 1) * 2 + 1 + sizeof(data)];
+    size_t len = 0;
+    expected[len++] = 0x80;
+    expected[len++] = 0x31;
+    for (int i = 0; i < MAX_CMD_BYTES - 2; i++) {
+        expected[len++] = 0xC0;
+        expected[len++] = cmds[2 + i];
+    }
+    expected[len++] = 0x40;
+    memcpy(expected + len, data, sizeof(data));
+    len += sizeof(data);
+    TEST_ASSERT_EQUAL(sizeof(expected), len);
+    expect_transaction(sio.bus, 0, expected, len);
+
+    // Zero-parameter records: one control byte per command
+    mock_i2c_bus_clear(sio.bus);
+    uint8_t nops[MAX_CMD_BYTES];
+    for (int i = 0; i < MAX_CMD_BYTES; i += 2) {
+        nops[i] = 0xE3;
+        nops[i + 1] = 0;
+    }
+    TEST_ESP_OK(esp_lcd_panel_io_st75256_tx_stream(sio.io, nops, MAX_CMD_BYTES, data, sizeof(data)));
+    TEST_ASSERT_EQUAL(MAX_CMD_BYTES + 1 + sizeof(data), sio.bus->log[0].size);
+
+    // Over the limit or malformed: rejected before anything is sent
+    mock_i2c_bus_clear(sio.bus);
+    cmds[1] = MAX_CMD_BYTES - 1;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, esp_lcd_panel_io_st75256_tx_stream(sio.io, cmds, MAX_CMD_BYTES + 1, NULL, 0));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_lcd_panel_io_st75256_tx_stream(sio.io, (const uint8_t[]) {0x15, 2, 0x00}, 3, NULL, 0));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_lcd_panel_io_st75256_tx_stream(sio.io, (const uint8_t[]) {0x15}, 1, NULL, 0));
+    TEST_ASSERT_EQUAL(0, sio.bus->log_len);
+    stream_io_del(&sio);
+}
+
+static const host_test_case_t cases[] = {
+    HOST_TEST_CASE(test_stream_encoding),
+    HOST_TEST_CASE(test_stream_matches_transactions),
+    HOST_TEST_CASE(test_stream_worst_case),
+};
+
+int main(int argc, char **argv)
+{
+    return host_test_main(argc, argv, cases, sizeof(cases) / sizeof(cases[0]));
+}
@@ -0,0 +1,84 @@
+/*
+ * LVGL glue on the host: the power save helper against input and draw activity
+ */
+#include <string.h>
+#include "esp_lcd_st75256_lvgl.h"
+#include "host_shim.h"
+#include "host_test.h"
+#include "lvgl.h"
+
+#define INACTIVE_MS 1000
+
+static void draw_page(host_panel_t *hp, uint8_t fill)
+{
+    uint8_t page[32];
+    memset(page, fill, sizeof(page));
+    TEST_ESP_OK(esp_lcd_panel_draw_bitmap(hp->panel, 0, 0, sizeof(page), 8, page));
+}
+
+static void test_power_save_update(void)
+{
+    host_panel_config_t config = {.stream_io = true};
+    host_panel_t *hp = host_panel_new(&config);
+    bool power_save = true;
+    host_lvgl_set_inactive_time(NULL, 0);
+    host_time_advance(2 * INACTIVE_MS * 1000);
+    st75256_model_clear_log(&hp->model);
+
+    // No input for a long time, but the UI redraws every 200 ms: the panel stays on
+    host_lvgl_set_inactive_time(NULL, 10 * INACTIVE_MS);
+    for (int i = 0; i < 20; i++) {
+        host_time_advance(200 * 1000);
+        draw_page(hp, i);
+        TEST_ESP_OK(esp_lcd_st75256_lvgl_power_save_update(hp->panel, NULL, INACTIVE_MS));
+    }
+    TEST_ASSERT_EQUAL(0, st75256_model_count(&hp->model, 0, 0x95));
+    TEST_ASSERT_EQUAL(0, st75256_model_count(&hp->model, 0, 0xAE));
+    TEST_ESP_OK(esp_lcd_panel_st75256_get_power_save(hp->panel, &power_save));
+    TEST_ASSERT(!power_save);
+
+    // The animation stops: asleep once the draws are inactive_ms old too
+    host_time_advance((INACTIVE_MS - 100) * 1000);
+    TEST_ESP_OK(esp_lcd_st75256_lvgl_power_save_update(hp->panel, NULL, INACTIVE_MS));
+    TEST_ASSERT(!hp->model.power_save);
+    host_time_advance(200 * 1000);
+    TEST_ESP_OK(esp_lcd_st75256_lvgl_power_save_update(hp->panel, NULL, INACTIVE_MS));
+    TEST_ASSERT(hp->model.power_save);
+    TEST_ASSERT(!hp->model.display_on);
+    TEST_ASSERT_EQUAL(1, st75256_model_count(&hp->model, 0, 0x95));
+
+    // A draw wakes the panel, the next update does not put it back to sleep
+    draw_page(hp, 0x55);
+    TEST_ASSERT(!hp->model.power_save);
+    host_time_advance(200 * 1000);
+    TEST_ESP_OK(esp_lcd_st75256_lvgl_power_save_update(hp->panel, NULL, INACTIVE_MS));
+    TEST_ASSERT(!hp->model.power_save);
+    TEST_ASSERT_EQUAL(1, st75256_model_count(&hp->model, 0, 0x95));
+
+    // Input wakes it without a redraw
+    host_time_advance(2 * INACTIVE_MS * 1000);
+    TEST_ESP_OK(esp_lcd_st75256_lvgl_power_save_update(hp->panel, NULL, INACTIVE_MS));
+    TEST_ASSERT(hp->model.power_save);
+    uint32_t data_bytes = hp->model.data_bytes;
+    host_lvgl_set_inactive_time(NULL, 10);
+    TEST_ESP_OK(esp_lcd_st75256_lvgl_power_save_update(hp->panel, NULL, INACTIVE_MS));
+    TEST_ASSERT(!hp->model.power_save);
+    TEST_ASSERT(hp->model.display_on);
+    TEST_ASSERT_EQUAL(data_bytes, hp->model.data_bytes);
+
+    uint32_t idle_ms = 0;
+    draw_page(hp, 0);
+    host_time_advance(300 * 1000);
+    TEST_ESP_OK(esp_lcd_panel_st75256_get_idle_time(hp->panel, &idle_ms));
+    TEST_ASSERT_EQUAL(300, idle_ms);
+    host_panel_del(hp);
+}
+
+static const host_test_case_t cases[] = {
+    HOST_TEST_CASE(test_power_save_update),
+};
+
+int main(int argc, char **argv)
+{
+    return host_test_main(argc, argv, cases, sizeof(cases) / sizeof(cases[0]));
+}
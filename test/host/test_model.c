@@ -0,0 +1,165 @@
+/*
+ * Controller model: RAM window addressing and command sets fed byte by byte,
+ * and PBM/PGM dumps of frames drawn through the driver
+ */
+#include <string.h>
+#include "host_test.h"
+
+static void feed_cmd(st75256_model_t *model, uint8_t cmd, const uint8_t *params, int num_params)
+{
+    st75256_model_feed(model, 0, cmd);
+    for (int i = 0; i < num_params; i++) {
+        st75256_model_feed(model, 1, params[i]);
+    }
+}
+
+// Dump into memory, check the header and return the pixel bytes after it
+static uint8_t *dump(const st75256_model_t *model, const char *header, size_t *size)
+{
+    char *buf = NULL;
+    size_t len = 0;
+    FILE *stream = open_memstream(&buf, &len);
+    TEST_ASSERT(stream);
+    TEST_ASSERT_EQUAL(0, st75256_model_dump_pnm(model, stream));
+    fclose(stream);
+    size_t header_len = strlen(header);
+    TEST_ASSERT(len >= header_len && !memcmp(buf, header, header_len));
+    *size = len - header_len;
+    memmove(buf, buf + header_len, *size);
+    return (uint8_t *)buf;
+}
+
+static void test_ram_window(void)
+{
+    st75256_model_t model = {0};
+    st75256_model_init(&model, 256, 128, 21, 0);
+    feed_cmd(&model, 0x30, NULL, 0);
+    feed_cmd(&model, 0x15, (const uint8_t[]) {10, 12}, 2);
+    feed_cmd(&model, 0x75, (const uint8_t[]) {2, 3}, 2);
+    // Columns first, wrapping back to the first page after the window
+    feed_cmd(&model, 0x5C, (const uint8_t[]) {1, 2, 3, 4, 5, 6, 7}, 7);
+    TEST_ASSERT_EQUAL(2, model.ddram[2][11]);
+    TEST_ASSERT_EQUAL(3, model.ddram[2][12]);
+    TEST_ASSERT_EQUAL(4, model.ddram[3][10]);
+    TEST_ASSERT_EQUAL(6, model.ddram[3][12]);
+    TEST_ASSERT_EQUAL(7, model.ddram[2][10]);
+    TEST_ASSERT_EQUAL(0xAA, model.ddram[2][13]);
+    TEST_ASSERT_EQUAL(7, model.data_bytes);
+
+    // 0xBC bit2: pages first
+    feed_cmd(&model, 0xBC, (const uint8_t[]) {0x04}, 1);
+    feed_cmd(&model, 0x5C, (const uint8_t[]) {11, 12, 13, 14}, 4);
+    TEST_ASSERT_EQUAL(11, model.ddram[2][10]);
+    TEST_ASSERT_EQUAL(12, model.ddram[3][10]);
+    TEST_ASSERT_EQUAL(13, model.ddram[2][11]);
+    TEST_ASSERT_EQUAL(14, model.ddram[3][11]);
+    st75256_model_deinit(&model);
+}
+
+static void test_command_sets(void)
+{
+    st75256_model_t model = {0};
+    st75256_model_init(&model, 256, 128, 21, 0);
+    // 0xF0 is the frame rate in set 2, the display mode in set 1
+    feed_cmd(&model, 0x31, NULL, 0);
+    feed_cmd(&model, 0xF0, (const uint8_t[]) {0x12, 0x13, 0x14, 0x15}, 4);
+    feed_cmd(&model, 0xA7, NULL, 0);
+    TEST_ASSERT(!st75256_model_gray(&model));
+    TEST_ASSERT(!model.invert);
+    TEST_ASSERT_EQUAL(0x15, model.frame_rate[3]);
+    feed_cmd(&model, 0x30, NULL, 0);
+    feed_cmd(&model, 0xF0, (const uint8_t[]) {0x11}, 1);
+    feed_cmd(&model, 0xA7, NULL, 0);
+    TEST_ASSERT(st75256_model_gray(&model));
+    TEST_ASSERT(model.invert);
+    TEST_ASSERT_EQUAL(4, st75256_model_find(&model, 1, 0xF0)->num_params);
+    TEST_ASSERT_EQUAL(1, st75256_model_find(&model, 0, 0xF0)->num_params);
+
+    // Data order: LSB puts bit0 on the top row, MSB bit7
+    model.display_mode = 0x10;
+    model.invert = false;
+    model.ddram[0][0] = 0x01;
+    feed_cmd(&model, 0x0C, NULL, 0);
+    TEST_ASSERT_EQUAL(1, st75256_model_pixel(&model, 0, 0));
+    TEST_ASSERT_EQUAL(0, st75256_model_pixel(&model, 0, 7));
+    feed_cmd(&model, 0x08, NULL, 0);
+    TEST_ASSERT_EQUAL(0, st75256_model_pixel(&model, 0, 0));
+    TEST_ASSERT_EQUAL(1, st75256_model_pixel(&model, 0, 7));
+    st75256_model_deinit(&model);
+}
+
+static void test_dump_pbm(void)
+{
+    for (int stream_io = 0; stream_io < 2; stream_io++) {
+        host_panel_config_t config = {.stream_io = stream_io};
+        host_panel_t *hp = host_panel_new(&config);
+        const host_orient_t orient = {.swap_xy = true, .mirror_x = true};
+        host_panel_orient(hp, &orient);
+        uint8_t *image = host_random_image(128, 256, 50);
+        uint8_t *pages = host_pack_lvgl_pages(image, 128, 256);
+        TEST_ESP_OK(esp_lcd_panel_draw_bitmap(hp->panel, 0, 0, 128, 256, pages));
+        TEST_ESP_OK(esp_lcd_panel_invert_color(hp->panel, true));
+
+        size_t size;
+        uint8_t *pbm = dump(&hp->model, "P4\n256 128\n", &size);
+        TEST_ASSERT_EQUAL(256 / 8 * 128, size);
+        for (int y = 0; y < 256; y++) {
+            for (int x = 0; x < 128; x++) {
+                int gx;
+                int gy;
+                host_lvgl_to_glass(hp, &orient, x, y, &gx, &gy);
+                int black = (pbm[gy * 32 + gx / 8] >> (7 - gx % 8)) & 0x01;
+                TEST_ASSERT_EQUAL(!image[y * 128 + x], black);
+            }
+        }
+        free(pbm);
+        free(pages);
+        free(image);
+        host_panel_del(hp);
+    }
+}
+
+static void test_dump_pgm(void)
+{
+    // RGB332 colors of the four levels: black, dark gray, light gray, white
+    static const uint8_t colors[4] = {0xFF, 0x92, 0x49, 0x00};
+    host_panel_config_t config = {
+        .stream_io = true,
+        .config.flags.gray_mode = true,
+        .bits_per_pixel = 8,
+    };
+    host_panel_t *hp = host_panel_new(&config);
+    uint8_t *levels = host_random_image(256, 128, 60);
+    uint8_t *noise = host_random_image(256, 128, 61);
+    uint8_t *rgb332 = malloc(256 * 128);
+    for (int i = 0; i < 256 * 128; i++) {
+        levels[i] = levels[i] | (noise[i] << 1);
+        rgb332[i] = colors[levels[i]];
+    }
+    TEST_ESP_OK(esp_lcd_panel_draw_bitmap(hp->panel, 0, 0, 256, 128, rgb332));
+    TEST_ASSERT(st75256_model_gray(&hp->model));
+
+    size_t size;
+    uint8_t *pgm = dump(&hp->model, "P5\n256 128\n3\n", &size);
+    TEST_ASSERT_EQUAL(256 * 128, size);
+    for (int i = 0; i < 256 * 128; i++) {
+        TEST_ASSERT_EQUAL(3 - levels[i], pgm[i]);
+    }
+    free(pgm);
+    free(rgb332);
+    free(noise);
+    free(levels);
+    host_panel_del(hp);
+}
+
+static const host_test_case_t cases[] = {
+    HOST_TEST_CASE(test_ram_window),
+    HOST_TEST_CASE(test_command_sets),
+    HOST_TEST_CASE(test_dump_pbm),
+    HOST_TEST_CASE(test_dump_pgm),
+};
+
+int main(int argc, char **argv)
+{
+    return host_test_main(argc, argv, cases, sizeof(cases) / sizeof(cases[0]));
+}
@@ -0,0 +1,588 @@
+/*
+ * ST75256 panel driver on the host: init sequence, orientation, mirroring,
+ * inversion, gap, hardware scrolling and custom init tables, checked on the glass of
+ * the controller model
+ */
+#include <string.h>
+#include "esp_lcd_panel_io_st75256.h"
+#include "host_test.h"
+
+#define LANDSCAPE_W 256
+#define LANDSCAPE_H 128
+
+// Every case runs on both panel IOs: generic (one transaction per call) and the ST75256 stream IO
+static host_panel_t *new_panel(bool stream_io, uint8_t orientation)
+{
+    host_panel_config_t config = {
+        .stream_io = stream_io,
+        .config.orientation = orientation,
+    };
+    return host_panel_new(&config);
+}
+
+// Draw an image at (x0, y0) in LVGL page format and copy it into the expected screen
+static void draw_image(host_panel_t *hp, uint8_t *screen, int screen_w, int x0, int y0, const uint8_t *image, int w, int h)
+{
+    uint8_t *pages = host_pack_lvgl_pages(image, w, h);
+    TEST_ESP_OK(esp_lcd_panel_draw_bitmap(hp->panel, x0, y0, x0 + w, y0 + h, pages));
+    free(pages);
+    for (int y = 0; y < h; y++) {
+        memcpy(screen + (y0 + y) * screen_w + x0, image + y * w, w);
+    }
+}
+
+static void expect_cmd(const host_panel_t *hp, int ext, uint8_t cmd, const uint8_t *params, int num_params)
+{
+    const st75256_model_cmd_t *entry = st75256_model_find(&hp->model, ext, cmd);
+    if (!entry) {
+        host_test_fail(__FILE__, __LINE__, "command 0x%02X of set %d not sent", cmd, ext + 1);
+    }
+    TEST_ASSERT_EQUAL(num_params, entry->num_params);
+    TEST_ASSERT(!memcmp(params, entry->params, num_params));
+}
+
+static void test_init(void)
+{
+    for (int stream_io = 0; stream_io < 2; stream_io++) {
+        host_panel_t *hp = new_panel(stream_io, 0);
+        const st75256_model_t *model = &hp->model;
+
+        // Glass table of the JLX256128G
+        expect_cmd(hp, 1, 0xD7, (const uint8_t[]) {0x9F}, 1);
+        expect_cmd(hp, 1, 0x32, (const uint8_t[]) {0x00, 0x01, 0x00}, 3);
+        expect_cmd(hp, 0, 0x81, (const uint8_t[]) {0x1E, 0x05}, 2);
+        expect_cmd(hp, 0, 0x20, (const uint8_t[]) {0x0B}, 1);
+        expect_cmd(hp, 0, 0xCA, (const uint8_t[]) {0x00, 0x7F, 0x20}, 3);
+        expect_cmd(hp, 0, 0xF0, (const uint8_t[]) {0x10}, 1);
+        expect_cmd(hp, 0, 0xBC, (const uint8_t[]) {0x00}, 1);
+        TEST_ASSERT_EQUAL(1, st75256_model_count(model, 0, 0xA6));
+
+        TEST_ASSERT_EQUAL(0x0C, model->data_order);
+        TEST_ASSERT_EQUAL(0x00, model->scan_dir);
+        TEST_ASSERT(!st75256_model_gray(model));
+        TEST_ASSERT(!model->invert);
+        TEST_ASSERT(!model->power_save);
+        TEST_ASSERT(model->display_on);
+        TEST_ASSERT_EQUAL(0, model->start_line);
+        // Display off first, on only from disp_on_off()
+        TEST_ASSERT_EQUAL(0xAE, model->log[1].cmd);
+        TEST_ASSERT_EQUAL(0xAF, model->log[model->log_len - 1].cmd);
+
+        // All 21 DDRAM pages are cleared, the rows Y mirroring shows included
+        for (int page = 0; page < 21; page++) {
+            for (int col = 0; col < 256; col++) {
+                TEST_ASSERT_EQUAL(0, model->ddram[page][col]);
+            }
+        }
+        TEST_ASSERT_EQUAL(0xAA, model->ddram[21][0]);
+        host_panel_del(hp);
+    }
+}
+
+static void test_landscape(void)
+{
+    for (int stream_io = 0; stream_io < 2; stream_io++) {
+        host_panel_t *hp = new_panel(stream_io, 0);
+        const host_orient_t orient = {0};
+        uint8_t *screen = calloc(1, LANDSCAPE_W * LANDSCAPE_H);
+        uint8_t *full = host_random_image(LANDSCAPE_W, LANDSCAPE_H, 1);
+        draw_image(hp, screen, LANDSCAPE_W, 0, 0, full, LANDSCAPE_W, LANDSCAPE_H);
+        TEST_ASSERT_EQUAL(0, host_check_glass(hp, &orient, 0, 0, screen, LANDSCAPE_W, LANDSCAPE_H));
+
+        // Partial areas: any columns, whole pages
+        uint8_t *part = host_random_image(61, 24, 2);
+        draw_image(hp, screen, LANDSCAPE_W, 37, 16, part, 61, 24);
+        uint8_t *edge = host_random_image(3, 8, 3);
+        draw_image(hp, screen, LANDSCAPE_W, LANDSCAPE_W - 3, LANDSCAPE_H - 8, edge, 3, 8);
+        TEST_ASSERT_EQUAL(0, host_check_glass(hp, &orient, 0, 0, screen, LANDSCAPE_W, LANDSCAPE_H));
+        free(edge);
+        free(part);
+        free(full);
+        free(screen);
+        host_panel_del(hp);
+    }
+}
+
+static void test_portrait(void)
+{
+    for (int stream_io = 0; stream_io < 2; stream_io++) {
+        host_panel_t *hp = new_panel(stream_io, 1);
+        const host_orient_t orient = {.swap_xy = true};
+        host_panel_orient(hp, &orient);
+        TEST_ASSERT_EQUAL(0x04, hp->model.scan_dir);
+        uint8_t *screen = calloc(1, LANDSCAPE_H * LANDSCAPE_W);
+        uint8_t *full = host_random_image(LANDSCAPE_H, LANDSCAPE_W, 4);
+        draw_image(hp, screen, LANDSCAPE_H, 0, 0, full, LANDSCAPE_H, LANDSCAPE_W);
+        TEST_ASSERT_EQUAL(0, host_check_glass(hp, &orient, 0, 0, screen, LANDSCAPE_H, LANDSCAPE_W));
+
+        // Partial areas: LVGL pages are transposed in 8 x 8 blocks
+        uint8_t *part = host_random_image(32, 72, 5);
+        draw_image(hp, screen, LANDSCAPE_H, 48, 104, part, 32, 72);
+        uint8_t *edge = host_random_image(8, 8, 6);
+        draw_image(hp, screen, LANDSCAPE_H, LANDSCAPE_H - 8, LANDSCAPE_W - 8, edge, 8, 8);
+        TEST_ASSERT_EQUAL(0, host_check_glass(hp, &orient, 0, 0, screen, LANDSCAPE_H, LANDSCAPE_W));
+        free(edge);
+        free(part);
+        free(full);
+        free(screen);
+        host_panel_del(hp);
+    }
+}
+
+static void test_mirror(void)
+{
+    for (int stream_io = 0; stream_io < 2; stream_io++) {
+        host_panel_t *hp = new_panel(stream_io, 0);
+        for (int combo = 0; combo < 8; combo++) {
+            const host_orient_t orient = {
+                .swap_xy = combo & 0x04,
+                .mirror_x = combo & 0x02,
+                .mirror_y = combo & 0x01,
+            };
+            host_panel_orient(hp, &orient);
+            // Row mirror: 0xBC bit0 reverses the pages, MSB on top (0x08) the rows within them, as u8g2 flips the ST75256
+            bool row_mirror = orient.swap_xy ? orient.mirror_x : orient.mirror_y;
+            TEST_ASSERT_EQUAL(row_mirror ? 0x08 : 0x0C, hp->model.data_order);
+            TEST_ASSERT_EQUAL(row_mirror, hp->model.scan_dir & 0x01);
+            int w = orient.swap_xy ? LANDSCAPE_H : LANDSCAPE_W;
+            int h = orient.swap_xy ? LANDSCAPE_W : LANDSCAPE_H;
+            uint8_t *screen = calloc(1, w * h);
+            uint8_t *full = host_random_image(w, h, 10 + combo);
+            draw_image(hp, screen, w, 0, 0, full, w, h);
+            uint8_t *part = host_random_image(16, 16, 20 + combo);
+            draw_image(hp, screen, w, 8, 24, part, 16, 16);
+            if (host_check_glass(hp, &orient, 0, 0, screen, w, h)) {
+                host_test_fail(__FILE__, __LINE__, "swap_xy %d mirror_x %d mirror_y %d, %s IO",
+                               orient.swap_xy, orient.mirror_x, orient.mirror_y, stream_io ? "stream" : "generic");
+            }
+            free(part);
+            free(full);
+            free(screen);
+        }
+        host_panel_del(hp);
+    }
+}
+
+static void test_invert(void)
+{
+    for (int stream_io = 0; stream_io < 2; stream_io++) {
+        host_panel_t *hp = new_panel(stream_io, 0);
+        const host_orient_t orient = {0};
+        uint8_t *full = host_random_image(LANDSCAPE_W, LANDSCAPE_H, 30);
+        uint8_t *screen = calloc(1, LANDSCAPE_W * LANDSCAPE_H);
+        draw_image(hp, screen, LANDSCAPE_W, 0, 0, full, LANDSCAPE_W, LANDSCAPE_H);
+
+        // Inversion is the controller's, DDRAM keeps what was drawn
+        st75256_model_clear_log(&hp->model);
+        TEST_ESP_OK(esp_lcd_panel_invert_color(hp->panel, true));
+        TEST_ASSERT_EQUAL(1, st75256_model_count(&hp->model, 0, 0xA7));
+        TEST_ASSERT_EQUAL(0, hp->model.data_bytes);
+        for (int i = 0; i < LANDSCAPE_W * LANDSCAPE_H; i++) {
+            screen[i] ^= 1;
+        }
+        TEST_ASSERT_EQUAL(0, host_check_glass(hp, &orient, 0, 0, screen, LANDSCAPE_W, LANDSCAPE_H));
+
+        TEST_ESP_OK(esp_lcd_panel_invert_color(hp->panel, false));
+        TEST_ASSERT_EQUAL(1, st75256_model_count(&hp->model, 0, 0xA6));
+        TEST_ASSERT_EQUAL(0, host_check_glass(hp, &orient, 0, 0, full, LANDSCAPE_W, LANDSCAPE_H));
+        free(screen);
+        free(full);
+        host_panel_del(hp);
+    }
+}
+
+static void test_gap(void)
+{
+    static const host_orient_t orients[] = {
+        {.x_gap = 5, .y_gap = 8},
+        {.mirror_x = true, .mirror_y = true, .x_gap = 3, .y_gap = 16},
+        {.swap_xy = true, .x_gap = 8, .y_gap = 7},
+        {.swap_xy = true, .mirror_x = true, .x_gap = 16, .y_gap = 1},
+    };
+    for (int stream_io = 0; stream_io < 2; stream_io++) {
+        host_panel_t *hp = new_panel(stream_io, 0);
+        for (size_t i = 0; i < sizeof(orients) / sizeof(orients[0]); i++) {
+            const host_orient_t *orient = &orients[i];
+            host_panel_orient(hp, orient);
+            // The visible area shrinks by the gap
+            int w = (orient->swap_xy ? LANDSCAPE_H : LANDSCAPE_W) - 16;
+            int h = (orient->swap_xy ? LANDSCAPE_W : LANDSCAPE_H) - 16;
+            uint8_t *image = host_random_image(w, h, 40 + i);
+            uint8_t *pages = host_pack_lvgl_pages(image, w, h);
+            TEST_ESP_OK(esp_lcd_panel_draw_bitmap(hp->panel, 0, 0, w, h, pages));
+            if (host_check_glass(hp, orient, 0, 0, image, w, h)) {
+                host_test_fail(__FILE__, __LINE__, "gap case %zu, %s IO", i, stream_io ? "stream" : "generic");
+            }
+            free(pages);
+            free(image);
+        }
+        host_panel_del(hp);
+    }
+}
+
+static void test_page_alignment(void)
+{
+    static const esp_lcd_st75256_input_format_t formats[] = {ESP_LCD_ST75256_INPUT_LVGL_PAGES, ESP_LCD_ST75256_INPUT_NATIVE};
+    for (int mode = 0; mode < 4; mode++) {
+        for (size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+            host_panel_config_t config = {
+                .stream_io = mode & 2,
+                .config.flags.shadow_fb = mode & 1,
+            };
+            host_panel_t *hp = host_panel_new(&config);
+            TEST_ESP_OK(esp_lcd_panel_st75256_set_input_format(hp->panel, formats[f]));
+            const host_orient_t orient = {0};
+            uint8_t *screen = calloc(1, LANDSCAPE_W * LANDSCAPE_H);
+            uint8_t *image = host_random_image(40, 16, 70);
+            uint8_t *pages = host_pack_lvgl_pages(image, 40, 16);
+            st75256_model_clear_log(&hp->model);
+
+            // Rows 4..12 span two pages but carry one page of data: rejected, nothing sent (not even the byte the
+            // generic IO rewrites to report a flush the shadow found unchanged)
+            TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_lcd_panel_draw_bitmap(hp->panel, 0, 4, 40, 12, pages));
+            TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_lcd_panel_draw_bitmap(hp->panel, 0, 8, 40, 20, pages));
+            TEST_ASSERT_EQUAL(0, hp->model.data_bytes);
+
+            draw_image(hp, screen, LANDSCAPE_W, 16, 8, image, 40, 16);
+            TEST_ASSERT_EQUAL(40 * 2, hp->model.data_bytes);
+            TEST_ASSERT_EQUAL(0, host_check_glass(hp, &orient, 0, 0, screen, LANDSCAPE_W, LANDSCAPE_H));
+            free(pages);
+            free(image);
+            free(screen);
+            host_panel_del(hp);
+        }
+    }
+}
+
+// The glass after the start line moved from 0 to `line`: the picture moves up, the rows below show DDRAM rows `rows` on
+static void scroll_screen(uint8_t *screen, int w, int h, int line)
+{
+    memmove(screen, screen + line * w, (h - line) * w);
+    memset(screen + (h - line) * w, 0, line * w);
+}
+
+static void test_scroll(void)
+{
+    for (int stream_io = 0; stream_io < 2; stream_io++) {
+        host_panel_t *hp = new_panel(stream_io, 0);
+        const host_orient_t orient = {0};
+        uint8_t *screen = calloc(1, LANDSCAPE_W * LANDSCAPE_H);
+        uint8_t *full = host_random_image(LANDSCAPE_W, LANDSCAPE_H, 80);
+        draw_image(hp, screen, LANDSCAPE_W, 0, 0, full, LANDSCAPE_W, LANDSCAPE_H);
+
+        // Only page aligned lines below the 168 DDRAM rows
+        TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_lcd_panel_st75256_set_scroll(hp->panel, 4));
+        TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_lcd_panel_st75256_set_scroll(hp->panel, ESP_LCD_ST75256_SCROLL_LINES));
+        TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_lcd_panel_st75256_set_scroll(hp->panel, -8));
+
+        // Whole screen scroll over the 42 blocks of 4 rows, programmed once, then one 0xAB per move
+        st75256_model_clear_log(&hp->model);
+        TEST_ESP_OK(esp_lcd_panel_st75256_set_scroll(hp->panel, 16));
+        expect_cmd(hp, 0, 0xAA, (const uint8_t[]) {0x00, 41, 42, 0x03}, 4);
+        expect_cmd(hp, 0, 0xAB, (const uint8_t[]) {16}, 1);
+        TEST_ASSERT_EQUAL(16, hp->model.start_line);
+        TEST_ASSERT_EQUAL(0, hp->model.data_bytes);
+        // The rows scrolled in show DDRAM rows 128..143, cleared by init
+        scroll_screen(screen, LANDSCAPE_W, LANDSCAPE_H, 16);
+        TEST_ASSERT_EQUAL(0, host_check_glass(hp, &orient, 0, 0, screen, LANDSCAPE_W, LANDSCAPE_H));
+
+        // Drawing keeps screen coordinates
+        uint8_t *bottom = host_random_image(LANDSCAPE_W, 16, 81);
+        draw_image(hp, screen, LANDSCAPE_W, 0, LANDSCAPE_H - 16, bottom, LANDSCAPE_W, 16);
+        TEST_ASSERT_EQUAL(0, host_check_glass(hp, &orient, 0, 0, screen, LANDSCAPE_W, LANDSCAPE_H));
+
+        st75256_model_clear_log(&hp->model);
+        TEST_ESP_OK(esp_lcd_panel_st75256_set_scroll(hp->panel, 24));
+        TEST_ASSERT_EQUAL(0, st75256_model_count(&hp->model, 0, 0xAA));
+        expect_cmd(hp, 0, 0xAB, (const uint8_t[]) {24}, 1);
+        scroll_screen(screen, LANDSCAPE_W, LANDSCAPE_H, 8);
+        TEST_ASSERT_EQUAL(0, host_check_glass(hp, &orient, 0, 0, screen, LANDSCAPE_W, LANDSCAPE_H));
+        int line;
+        TEST_ESP_OK(esp_lcd_panel_st75256_get_scroll(hp->panel, &line));
+        TEST_ASSERT_EQUAL(24, line);
+
+        // Portrait and Y mirror can not scroll, switching to them returns to start line 0
+        host_panel_orient(hp, &(const host_orient_t) {.mirror_y = true});
+        TEST_ASSERT_EQUAL(0, hp->model.start_line);
+        TEST_ESP_OK(esp_lcd_panel_st75256_get_scroll(hp->panel, &line));
+        TEST_ASSERT_EQUAL(0, line);
+        TEST_ASSERT_EQUAL(ESP_ERR_NOT_SUPPORTED, esp_lcd_panel_st75256_set_scroll(hp->panel, 8));
+        host_panel_orient(hp, &(const host_orient_t) {.swap_xy = true});
+        TEST_ASSERT_EQUAL(ESP_ERR_NOT_SUPPORTED, esp_lcd_panel_st75256_set_scroll(hp->panel, 8));
+        TEST_ASSERT_EQUAL(0, hp->model.start_line);
+        free(bottom);
+        free(full);
+        free(screen);
+        host_panel_del(hp);
+    }
+}
+
+// Windows crossing the row shown from DDRAM row 0 are split there, with and without a Y gap and a shadow
+static void test_scroll_wrap(void)
+{
+    static const struct {
+        int y_gap;
+        int line;
+    } cases[] = {
+        {0, 160},                 // Screen rows 0..7 from DDRAM 160..167, the rest from DDRAM 0 on
+        {0, 64},                  // Wrap at screen row 104
+        {8, 152},                 // Wrap at screen row 168 - 152 - 8 = 8
+    };
+    for (int shadow = 0; shadow < 2; shadow++) {
+        for (int stream_io = 0; stream_io < 2; stream_io++) {
+            for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+                host_panel_config_t config = {
+                    .stream_io = stream_io,
+                    .config.flags.shadow_fb = shadow,
+                };
+                host_panel_t *hp = host_panel_new(&config);
+                const host_orient_t orient = {.y_gap = cases[i].y_gap};
+                host_panel_orient(hp, &orient);
+                TEST_ESP_OK(esp_lcd_panel_st75256_set_scroll(hp->panel, cases[i].line));
+                int h = LANDSCAPE_H - cases[i].y_gap;
+                int wrap = ESP_LCD_ST75256_SCROLL_LINES - cases[i].line - cases[i].y_gap;
+                uint8_t *screen = calloc(1, LANDSCAPE_W * h);
+
+                // Full screen and a partial area across the wrap, each in two RAM windows
+                uint8_t *full = host_random_image(LANDSCAPE_W, h, 90 + i);
+                st75256_model_clear_log(&hp->model);
+                draw_image(hp, screen, LANDSCAPE_W, 0, 0, full, LANDSCAPE_W, h);
+                TEST_ASSERT_EQUAL(2, hp->model.ram_writes);
+                uint8_t *part = host_random_image(40, 16, 95 + i);
+                st75256_model_clear_log(&hp->model);
+                draw_image(hp, screen, LANDSCAPE_W, 24, wrap - 8, part, 40, 16);
+                TEST_ASSERT_EQUAL(2, hp->model.ram_writes);
+                TEST_ASSERT_EQUAL(40 * 2, hp->model.data_bytes);
+                if (host_check_glass(hp, &orient, 0, 0, screen, LANDSCAPE_W, h)) {
+                    host_test_fail(__FILE__, __LINE__, "y_gap %d line %d, %s IO, shadow %d",
+                                   cases[i].y_gap, cases[i].line, stream_io ? "stream" : "generic", shadow);
+                }
+                free(part);
+                free(full);
+                free(screen);
+                host_panel_del(hp);
+            }
+        }
+    }
+}
+
+// Draw the whole landscape screen as expected
+static void redraw_screen(host_panel_t *hp, const uint8_t *screen)
+{
+    uint8_t *pages = host_pack_lvgl_pages(screen, LANDSCAPE_W, LANDSCAPE_H);
+    TEST_ESP_OK(esp_lcd_panel_draw_bitmap(hp->panel, 0, 0, LANDSCAPE_W, LANDSCAPE_H, pages));
+    free(pages);
+}
+
+// The shadow moves with the start line: redrawing the scrolled picture only sends the rows scrolled in
+static void test_scroll_shadow(void)
+{
+    host_panel_config_t config = {
+        .stream_io = true,
+        .config.flags.shadow_fb = true,
+    };
+    host_panel_t *hp = host_panel_new(&config);
+    const host_orient_t orient = {0};
+    uint8_t *screen = calloc(1, LANDSCAPE_W * LANDSCAPE_H);
+    uint8_t *full = host_random_image(LANDSCAPE_W, LANDSCAPE_H, 100);
+    draw_image(hp, screen, LANDSCAPE_W, 0, 0, full, LANDSCAPE_W, LANDSCAPE_H);
+
+    // Up by two pages: the two pages scrolled in are blank and dirty in the shadow
+    TEST_ESP_OK(esp_lcd_panel_st75256_set_scroll(hp->panel, 16));
+    scroll_screen(screen, LANDSCAPE_W, LANDSCAPE_H, 16);
+    uint8_t *bottom = host_random_image(LANDSCAPE_W, 16, 101);
+    memcpy(screen + (LANDSCAPE_H - 16) * LANDSCAPE_W, bottom, 16 * LANDSCAPE_W);
+    st75256_model_clear_log(&hp->model);
+    redraw_screen(hp, screen);
+    TEST_ASSERT_EQUAL(LANDSCAPE_W * 2, hp->model.data_bytes);
+    TEST_ASSERT_EQUAL(0, host_check_glass(hp, &orient, 0, 0, screen, LANDSCAPE_W, LANDSCAPE_H));
+
+    // Down by one page, from 16 to 8: the top page shows DDRAM rows 8..15, still holding the first picture
+    TEST_ESP_OK(esp_lcd_panel_st75256_set_scroll(hp->panel, 8));
+    memmove(screen + 8 * LANDSCAPE_W, screen, (LANDSCAPE_H - 8) * LANDSCAPE_W);
+    memcpy(screen, full + 8 * LANDSCAPE_W, 8 * LANDSCAPE_W);
+    st75256_model_clear_log(&hp->model);
+    redraw_screen(hp, screen);
+    TEST_ASSERT_EQUAL(LANDSCAPE_W, hp->model.data_bytes);
+    TEST_ASSERT_EQUAL(0, host_check_glass(hp, &orient, 0, 0, screen, LANDSCAPE_W, LANDSCAPE_H));
+
+    // From 8 across line 0 to 160 is down by two pages, not up by nineteen
+    TEST_ESP_OK(esp_lcd_panel_st75256_set_scroll(hp->panel, 160));
+    // Screen rows 0..15 show DDRAM rows 160..167, never drawn, and 0..7, still holding the first picture
+    memmove(screen + 16 * LANDSCAPE_W, screen, (LANDSCAPE_H - 16) * LANDSCAPE_W);
+    memset(screen, 0, 8 * LANDSCAPE_W);
+    memcpy(screen + 8 * LANDSCAPE_W, full, 8 * LANDSCAPE_W);
+    st75256_model_clear_log(&hp->model);
+    redraw_screen(hp, screen);
+    TEST_ASSERT_EQUAL(LANDSCAPE_W * 2, hp->model.data_bytes);
+    TEST_ASSERT_EQUAL(0, host_check_glass(hp, &orient, 0, 0, screen, LANDSCAPE_W, LANDSCAPE_H));
+    free(bottom);
+    free(full);
+    free(screen);
+    host_panel_del(hp);
+}
+
+// A table that fails validation: the panel is not created
+static void expect_bad_init_cmds(const uint8_t *cmds, size_t size)
+{
+    st75256_model_t model = {0};
+    st75256_model_init(&model, 256, 128, 21, 0);
+    esp_lcd_panel_io_handle_t io;
+    TEST_ESP_OK(mock_panel_io_new(&model, 0, &io));
+    const esp_lcd_panel_st75256_config_t config = {
+        .init_cmds = cmds,
+        .init_cmds_size = size,
+    };
+    const esp_lcd_panel_dev_config_t panel_config = {
+        .reset_gpio_num = -1,
+        .bits_per_pixel = 1,
+        .vendor_config = (void *) &config,
+    };
+    esp_lcd_panel_handle_t panel = NULL;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_lcd_new_panel_st75256(io, &panel_config, &panel));
+    TEST_ASSERT(!panel);
+    TEST_ESP_OK(esp_lcd_panel_io_del(io));
+    st75256_model_deinit(&model);
+}
+
+static void test_init_cmds_invalid(void)
+{
+    expect_bad_init_cmds((const uint8_t[]) {0x81}, 1);                                    // No length
+    expect_bad_init_cmds((const uint8_t[]) {0x81, 2, 0x20}, 3);                           // Parameter missing
+    expect_bad_init_cmds((const uint8_t[]) {0x81, 2, 0x20, 0x04, 0xCA}, 5);               // Second record cut short
+    expect_bad_init_cmds((const uint8_t[]) {0x20, 1 | ESP_LCD_ST75256_INIT_DELAY, 0x0B}, 3); // Delay byte missing
+    // More parameters than the stream IO takes in one command list
+    uint8_t *long_cmd = calloc(1, ESP_LCD_PANEL_IO_ST75256_MAX_CMD_BYTES + 1);
+    TEST_ASSERT(long_cmd);
+    long_cmd[0] = 0x32;
+    long_cmd[1] = ESP_LCD_PANEL_IO_ST75256_MAX_CMD_BYTES - 1;
+    expect_bad_init_cmds(long_cmd, ESP_LCD_PANEL_IO_ST75256_MAX_CMD_BYTES + 1);
+    free(long_cmd);
+}
+
+#define INIT_DELAY_MS 20
+
+static const uint8_t s_custom_init[] = {
+    0x30, 0,                                      // Already in command set 1: nothing sent
+    0x31, 0,
+    0xD7, 1, 0x9F,
+    0x32, 3, 0x00, 0x01, 0x03,
+    0x30, 0, 0x31, 0, 0x30, 0,                    // Only the set of the next command is sent
+    0x81, 2, 0x20, 0x04,
+    0x20, 1 | ESP_LCD_ST75256_INIT_DELAY, 0x0B, INIT_DELAY_MS,
+    0xCA, 3, 0x00, 0x9F, 0x20,
+};
+
+// What the controller receives of s_custom_init, set switches included (logged in the set they leave)
+static const st75256_model_cmd_t s_custom_init_received[] = {
+    {0, 0x31, 0, {0}},
+    {1, 0xD7, 1, {0x9F}},
+    {1, 0x32, 3, {0x00, 0x01, 0x03}},
+    {1, 0x30, 0, {0}},
+    {0, 0x81, 2, {0x20, 0x04}},
+    {0, 0x20, 1, {0x0B}},
+    {0, 0xCA, 3, {0x00, 0x9F, 0x20}},
+};
+
+#define CUSTOM_INIT_RECEIVED (sizeof(s_custom_init_received) / sizeof(s_custom_init_received[0]))
+#define CUSTOM_INIT_DELAY_AFTER 5                 // Index of 0x20 in s_custom_init_received
+
+// Model log entries before each transfer of the stream IO
+typedef struct {
+    const st75256_model_t *model;
+    size_t starts[64];
+    size_t len;
+} trans_starts_t;
+
+static void record_start(mock_i2c_bus_t *bus, uint16_t address, size_t size, void *ctx)
+{
+    trans_starts_t *starts = ctx;
+    if (starts->len < sizeof(starts->starts) / sizeof(starts->starts[0])) {
+        starts->starts[starts->len++] = starts->model->log_len;
+    }
+}
+
+static void test_init_cmds_custom(void)
+{
+    for (int stream_io = 0; stream_io < 2; stream_io++) {
+        host_panel_config_t config = {
+            .stream_io = stream_io,
+            .config = {
+                .init_cmds = s_custom_init,
+                .init_cmds_size = sizeof(s_custom_init),
+            },
+        };
+        host_panel_t *hp = host_panel_new(&config);
+        trans_starts_t starts = {.model = &hp->model};
+        if (hp->bus) {
+            mock_i2c_bus_clear(hp->bus);
+            hp->bus->hook = record_start;
+            hp->bus->hook_ctx = &starts;
+        } else {
+            mock_panel_io_clear(hp->io);
+        }
+        st75256_model_clear_log(&hp->model);
+        TEST_ESP_OK(esp_lcd_panel_init(hp->panel));
+
+        // Display off and power save off in set 1, then the table in order, then the driver's own steps
+        const st75256_model_t *model = &hp->model;
+        TEST_ASSERT(model->log_len > 3 + CUSTOM_INIT_RECEIVED);
+        TEST_ASSERT_EQUAL(0x30, model->log[0].cmd);
+        TEST_ASSERT_EQUAL(0xAE, model->log[1].cmd);
+        TEST_ASSERT_EQUAL(0x94, model->log[2].cmd);
+        for (size_t i = 0; i < CUSTOM_INIT_RECEIVED; i++) {
+            const st75256_model_cmd_t *expected = &s_custom_init_received[i];
+            const st75256_model_cmd_t *entry = &model->log[3 + i];
+            if (entry->ext != expected->ext || entry->cmd != expected->cmd || entry->num_params != expected->num_params ||
+                    memcmp(entry->params, expected->params, expected->num_params)) {
+                host_test_fail(__FILE__, __LINE__, "init command %zu: 0x%02X of set %d, expected 0x%02X of set %d, %s IO",
+                               i, entry->cmd, entry->ext + 1, expected->cmd, expected->ext + 1, stream_io ? "stream" : "generic");
+            }
+        }
+
+        if (hp->bus) {
+            // Set switches and commands up to the delay leave in one transaction, the delay separates it from the next
+            TEST_ASSERT(starts.len >= 2);
+            TEST_ASSERT_EQUAL(0, starts.starts[0]);
+            TEST_ASSERT_EQUAL(3 + CUSTOM_INIT_DELAY_AFTER + 1, starts.starts[1]);
+            TEST_ASSERT(hp->bus->log[1].start_us - hp->bus->log[0].end_us >= INIT_DELAY_MS * 1000);
+            hp->bus->hook = NULL;
+        } else {
+            // One transaction per command and one per parameter list, the delay after the parameters of 0x20
+            const mock_panel_io_t *io = mock_panel_io_get(hp->io);
+            size_t first = 0;
+            while (first < io->log_len && io->log[first].cmd != 0x31) {
+                first++;
+            }
+            size_t cmd_ca = first;
+            while (cmd_ca < io->log_len && io->log[cmd_ca].cmd != 0xCA) {
+                cmd_ca++;
+            }
+            TEST_ASSERT(cmd_ca < io->log_len);
+            // 0x31, 0xD7 + 1, 0x32 + 1, 0x30, 0x81 + 1, 0x20 + 1
+            TEST_ASSERT_EQUAL(10, cmd_ca - first);
+            TEST_ASSERT(io->log[cmd_ca].start_us - io->log[cmd_ca - 1].end_us >= INIT_DELAY_MS * 1000);
+        }
+        host_panel_del(hp);
+    }
+}
+
+static const host_test_case_t cases[] = {
+    HOST_TEST_CASE(test_init),
+    HOST_TEST_CASE(test_landscape),
+    HOST_TEST_CASE(test_portrait),
+    HOST_TEST_CASE(test_mirror),
+    HOST_TEST_CASE(test_invert),
+    HOST_TEST_CASE(test_gap),
+    HOST_TEST_CASE(test_page_alignment),
+    HOST_TEST_CASE(test_scroll),
+    HOST_TEST_CASE(test_scroll_wrap),
+    HOST_TEST_CASE(test_scroll_shadow),
+    HOST_TEST_CASE(test_init_cmds_invalid),
+    HOST_TEST_CASE(test_init_cmds_custom),
+};
+
+int main(int argc, char **argv)
+{
+    return host_test_main(argc, argv, cases, sizeof(cases) / sizeof(cases[0]));
+}